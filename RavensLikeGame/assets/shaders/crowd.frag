@@ -0,0 +1,13 @@
+#version 330 core
+in vec2 TexCoord;
+out vec4 FragColor;
+
+uniform sampler2D sprite;   // premultiplikált alfa (TextureImporter)
+
+void main()
+{
+    vec4 c = texture(sprite, TexCoord);
+    // alfa-teszt: a szereplők mélységet írnak, a félig átlátszó perem nem takarhat
+    if (c.a < 0.5) discard;
+    FragColor = c;
+}
@@ -0,0 +1,40 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;       // egység quad, alul-középre igazítva
+layout (location = 1) in vec2 aTexCoord;  // [0..1]
+
+// példányonként 8 bájt (CrowdInstance)
+layout (location = 2) in ivec2 iFeet;     // láb az origóhoz képest, 1/positionScale pixelben
+layout (location = 3) in uint iPacked;    // irány (0..2. bit) | képkocka (3..4.) | klip (5..15.)
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec2 origin;
+uniform float positionScale;
+uniform vec2 spriteSize;
+uniform vec4 isoGrid;           // (origó, 1/halfWidth, 1/halfHeight) (IsoGrid::GetSpriteDepthParams)
+uniform vec4 isoDepth;          // (csempe-eltolás x, y, átló → z skála, eltolás)
+uniform samplerBuffer uvTable;  // [klip][irány 8][képkocka 4] UV-téglalapok (u0,v0,u1,v1)
+
+out vec2 TexCoord;
+
+// A csempe átlója (IsoGrid::TileDiagonal) és abból a mélység (IsoGrid::SpriteDepth)
+float SpriteDepth(vec2 worldPos)
+{
+    vec2 local = (worldPos - isoGrid.xy) * isoGrid.zw;
+    vec2 g = 0.5 * vec2(local.x + local.y, local.y - local.x) - isoDepth.xy;
+    float diagonal = floor(g.x + 0.5) + floor(g.y + 0.5);
+    return clamp(diagonal * isoDepth.z + isoDepth.w, -1.0, 1.0);
+}
+
+void main()
+{
+    uint direction = iPacked & 7u;
+    uint frame = (iPacked >> 3) & 3u;
+    uint clip = (iPacked >> 5) & 2047u;
+    vec4 uvRect = texelFetch(uvTable, int((clip * 8u + direction) * 4u + frame));
+
+    vec2 feet = origin + vec2(iFeet) / positionScale;
+    TexCoord = mix(uvRect.xy, uvRect.zw, aTexCoord);
+    gl_Position = projection * view * vec4(feet + aPos * spriteSize, 0.0, 1.0);
+    gl_Position.z = SpriteDepth(feet) * gl_Position.w;
+}
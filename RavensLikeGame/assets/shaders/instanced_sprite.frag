@@ -0,0 +1,26 @@
+#version 330 core
+in vec2 TexCoord;
+in vec2 QuadCoord;
+in vec4 Color;
+out vec4 FragColor;
+
+uniform sampler2D sprite;
+uniform bool useTexture;     // false → textúra nélküli, lágy szélű kör
+
+void main()
+{
+    vec4 c;
+    if (useTexture)
+    {
+        // a textúra premultiplikált (TextureImporter), a szín egyenes alfás
+        c = texture(sprite, TexCoord) * vec4(Color.rgb * Color.a, Color.a);
+    }
+    else
+    {
+        float d = length(QuadCoord * 2.0 - 1.0);
+        float a = Color.a * (1.0 - smoothstep(0.5, 1.0, d));
+        c = vec4(Color.rgb * a, a);
+    }
+    if (c.a < 0.01) discard;
+    FragColor = c;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;       // egység quad, origó-középpontú
+layout (location = 1) in vec2 aTexCoord;  // [0..1]
+
+// példányonként
+layout (location = 2) in vec2 iCenter;
+layout (location = 3) in vec2 iSize;
+layout (location = 4) in vec4 iUvRect;    // (u0,v0,u1,v1)
+layout (location = 5) in vec4 iColor;     // RGBA8, normalizálva
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec4 isoGrid;       // (origó, 1/halfWidth, 1/halfHeight) (IsoGrid::GetSpriteDepthParams)
+uniform vec4 isoDepth;      // (csempe-eltolás x, y, átló → z skála, eltolás); csupa 0 → z = 0
+
+out vec2 TexCoord;
+out vec2 QuadCoord;
+out vec4 Color;
+
+// A csempe átlója (IsoGrid::TileDiagonal) és abból a mélység (IsoGrid::SpriteDepth)
+float SpriteDepth(vec2 worldPos)
+{
+    vec2 local = (worldPos - isoGrid.xy) * isoGrid.zw;
+    vec2 g = 0.5 * vec2(local.x + local.y, local.y - local.x) - isoDepth.xy;
+    float diagonal = floor(g.x + 0.5) + floor(g.y + 0.5);
+    return clamp(diagonal * isoDepth.z + isoDepth.w, -1.0, 1.0);
+}
+
+void main()
+{
+    TexCoord = mix(iUvRect.xy, iUvRect.zw, aTexCoord);
+    QuadCoord = aTexCoord;
+    Color = iColor;
+    gl_Position = projection * view * vec4(iCenter + aPos * iSize, 0.0, 1.0);
+    gl_Position.z = SpriteDepth(iCenter) * gl_Position.w;
+}
\ No newline at end of file
@@ -1,10 +1,12 @@
 #version 330 core
 in vec2 TexCoord;
+in float Brightness;
 out vec4 FragColor;
 
 uniform sampler2D textureAtlas;
 
 void main()
 {
-    FragColor = texture(textureAtlas, TexCoord);
+    vec4 tex = texture(textureAtlas, TexCoord);   // premultiplikált: a fényerő az alfát nem érinti
+    FragColor = vec4(tex.rgb * Brightness, tex.a);
 }
\ No newline at end of file
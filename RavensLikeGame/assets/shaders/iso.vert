@@ -2,16 +2,23 @@
 layout (location = 0) in vec2 aPos;   // quad pozíció (pixelekben)
 layout (location = 1) in vec2 aTex;   // quad UV [0..1]
 
-uniform mat4 model;
+// példányonként (csempénként)
+layout (location = 2) in vec2 iOffset;       // quad bal-felső sarka világ-koordinátában
+layout (location = 3) in vec4 iUvRect;       // x=u0, y=v0, z=u1, w=v1
+layout (location = 4) in float iBrightness;  // látótér: 1 = látható, <1 = emlékezett
+layout (location = 5) in float iDepth;       // NDC z az iso rendezési kulcsból (átló)
+
 uniform mat4 view;
 uniform mat4 projection;
-uniform vec4 uvRect;                  // x=u0, y=v0, z=u1, w=v1
 
 out vec2 TexCoord;
+out float Brightness;
 
 void main()
 {
     // quad UV → atlas UV
-    TexCoord = mix(uvRect.xy, uvRect.zw, aTex);
-    gl_Position = projection * view * model * vec4(aPos, 0.0, 1.0);
+    TexCoord = mix(iUvRect.xy, iUvRect.zw, aTex);
+    Brightness = iBrightness;
+    gl_Position = projection * view * vec4(aPos + iOffset, 0.0, 1.0);
+    gl_Position.z = iDepth * gl_Position.w;
 }
\ No newline at end of file
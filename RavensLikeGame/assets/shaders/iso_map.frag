@@ -0,0 +1,90 @@
+#version 330 core
+in vec2 WorldPos;
+out vec4 FragColor;
+
+uniform sampler2D textureAtlas;
+uniform usampler2D tileMap;         // R8UI csempe-azonosító, >= tileCount: üres
+uniform usampler2D visibilityMap;   // R8UI: 0 rejtett, 1 emlékezett, 2 látható
+
+uniform vec4 tileUvRects[4];        // ugyanaz az elrendezés, mint az IsoRenderer-ben
+uniform int tileCount;
+uniform vec2 origin;                // IsoRenderer::ComputeMapOrigin
+uniform vec2 halfTile;              // (félszélesség, fél látható magasság)
+uniform vec2 tileQuadSize;          // a csempe quad mérete (skálázva)
+uniform vec2 topFaceCenter;         // a quad aljától a felső lap közepéig
+uniform vec2 mapSize;               // (cols, rows)
+uniform bool useVisibility;
+uniform float rememberedBrightness;
+uniform float depthSortKeyRange;    // Globals::kDepthSortKeyRange
+
+// A csempék határán az uv ugrik, ezért a mip-szintet a (folytonos) világkoordináta
+// deriváltjából számoljuk; a main elején, egységes vezérlésben
+vec2 worldDx, worldDy;
+
+// A (col,row) csempe képe ezen a pixelen; false, ha nincs csempe vagy átlátszó
+bool SampleTile(ivec2 cell, out vec4 color)
+{
+    if (cell.x < 0 || cell.y < 0 || cell.x >= int(mapSize.x) || cell.y >= int(mapSize.y))
+        return false;
+
+    uint id = texelFetch(tileMap, cell, 0).r;
+    if (id >= uint(tileCount))
+        return false;
+
+    float brightness = 1.0;
+    if (useVisibility) {
+        uint v = texelFetch(visibilityMap, cell, 0).r;
+        if (v == 0u)
+            return false;
+        if (v == 1u)
+            brightness = rememberedBrightness;
+    }
+
+    // a quad bal-alsó sarka, pontosan mint az IsoRenderer::DrawMap-ben
+    vec2 quadMin = origin + vec2(float(cell.x - cell.y) * halfTile.x - halfTile.x, float(cell.x + cell.y) * halfTile.y);
+    vec2 uv = (WorldPos - quadMin) / tileQuadSize;
+    if (any(lessThan(uv, vec2(0.0))) || any(greaterThanEqual(uv, vec2(1.0))))
+        return false;
+
+    vec4 rect = tileUvRects[id];
+    vec2 uvPerWorld = (rect.zw - rect.xy) / tileQuadSize;
+    vec4 tex = textureGrad(textureAtlas, mix(rect.xy, rect.zw, uv), worldDx * uvPerWorld, worldDy * uvPerWorld);
+    if (tex.a <= 0.0)
+        return false;
+
+    color = vec4(tex.rgb * brightness, tex.a);
+    return true;
+}
+
+void main()
+{
+    worldDx = dFdx(WorldPos);
+    worldDy = dFdy(WorldPos);
+
+    // pixel -> a felső lapját tartalmazó csempe (inverz iso vetítés)
+    vec2 local = WorldPos - origin - topFaceCenter;
+    vec2 g = 0.5 * vec2(local.x / halfTile.x + local.y / halfTile.y,
+                        local.y / halfTile.y - local.x / halfTile.x);
+    ivec2 cell = ivec2(floor(g + 0.5));
+
+    // A felső lapok (szinte) hézag nélkül fedik a síkot; ahol nincs csempe, ott a hátsó
+    // szomszédok oldallapjai látszanak, a rombusz peremén pedig az elülsők egy-egy pixele.
+    // Elölről hátra (átló szerint): az első találat nyer, mint a festő-algoritmusnál.
+    const ivec2 candidates[6] = ivec2[6](
+        ivec2(-1, 0), ivec2(0, -1),
+        ivec2(0, 0),
+        ivec2(1, 0), ivec2(0, 1),
+        ivec2(1, 1));
+    for (int i = 0; i < 6; ++i) {
+        ivec2 c = cell + candidates[i];
+        vec4 color;
+        if (SampleTile(c, color)) {
+            FragColor = color;
+            // ugyanaz a mélység, mint a geometriás módban (IsoGrid::DepthFromSortKey)
+            float z = clamp(float(c.x + c.y) / depthSortKeyRange, -1.0, 1.0);
+            gl_FragDepth = z * 0.5 + 0.5;
+            return;
+        }
+    }
+    discard;
+}
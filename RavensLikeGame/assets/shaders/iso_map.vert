@@ -0,0 +1,14 @@
+#version 330 core
+// Teljes képernyős háromszög puffer nélkül: (-1,-1), (3,-1), (-1,3)
+
+uniform mat4 inverseViewProjection;
+
+out vec2 WorldPos;
+
+void main()
+{
+    vec2 ndc = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+    // ortho vetítés: a világ-pozíció lineáris, így interpolálható
+    WorldPos = (inverseViewProjection * vec4(ndc, 0.0, 1.0)).xy;
+    gl_Position = vec4(ndc, 0.0, 1.0);
+}
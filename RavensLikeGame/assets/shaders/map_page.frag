@@ -0,0 +1,15 @@
+#version 330 core
+in vec2 TexCoord;
+out vec4 FragColor;
+
+uniform sampler2D pageColor;
+uniform sampler2D pageDepth;    // a lap rajzolásakor írt mélység, változatlanul visszaírjuk
+
+void main()
+{
+    vec4 color = texture(pageColor, TexCoord);
+    if (color.a <= 0.0)
+        discard;
+    gl_FragDepth = texture(pageDepth, TexCoord).r;
+    FragColor = color;
+}
@@ -0,0 +1,15 @@
+#version 330 core
+// Egy cache-lap quadja puffer nélkül (GL_TRIANGLE_STRIP, 4 csúcs)
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec4 pageRect;      // világ-koordinátában: (x0, y0, x1, y1)
+
+out vec2 TexCoord;
+
+void main()
+{
+    vec2 corner = vec2(gl_VertexID & 1, (gl_VertexID >> 1) & 1);
+    TexCoord = corner;
+    gl_Position = projection * view * vec4(mix(pageRect.xy, pageRect.zw, corner), 0.0, 1.0);
+}
@@ -18,7 +18,7 @@ void main()
     {
         // a SpriteRenderer quad TexCoord-ja 0..1, ezt térképezzük rá az uvRect-re
         vec2 uv = mix(uvRect.xy, uvRect.zw, TexCoord);
-        vec4 tex = texture(sprite, uv);
+        vec4 tex = texture(sprite, uv);   // premultiplikált alfa
         if (tex.a < 0.01) discard; // tényleg átlátszó pixelek eldobása
         FragColor = tex;
     }
@@ -8,6 +8,7 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 uniform bool useView;
+uniform float depth;    // NDC z az iso rendezési kulcsból; a UI-nál 0
 
 void main()
 {
@@ -16,4 +17,5 @@ void main()
         gl_Position = projection * view * model * vec4(aPos, 0.0, 1.0);
     else
         gl_Position = projection * model * vec4(aPos, 0.0, 1.0);
+    gl_Position.z = depth * gl_Position.w;
 }
\ No newline at end of file
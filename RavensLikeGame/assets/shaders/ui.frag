@@ -0,0 +1,13 @@
+#version 330 core
+in vec2 TexCoord;
+in vec4 Color;
+out vec4 FragColor;
+
+// A sima elemek egy fehér texelt mintáznak, az ikonok az atlasz többi részét: így egy
+// textúrával (és egy rajzolással) megy az egész HUD
+uniform sampler2D uiAtlas;
+
+void main()
+{
+    FragColor = texture(uiAtlas, TexCoord) * Color;
+}
\ No newline at end of file
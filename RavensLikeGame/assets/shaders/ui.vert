@@ -0,0 +1,17 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;         // képernyő-pixel (bal-alsó origó)
+layout (location = 1) in vec2 aTexCoord;    // az UI atlaszon
+layout (location = 2) in vec4 aColor;       // RGBA8, egyenes alfa
+
+out vec2 TexCoord;
+out vec4 Color;
+
+uniform mat4 projection;
+
+void main()
+{
+    TexCoord = aTexCoord;
+    // premultiplikált, mint a textúrák és a blend függvény
+    Color = vec4(aColor.rgb * aColor.a, aColor.a);
+    gl_Position = vec4((projection * vec4(aPos, 0.0, 1.0)).xy, 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#version 330 core
+in vec2 ScreenUV;
+out vec4 FragColor;
+
+uniform sampler2D scene;        // GL_LINEAR szűréssel
+uniform vec2 sourceSize;        // a ténylegesen kirajzolt rész (skálázott viewport) pixelben
+uniform vec2 textureSize;       // a teljes target mérete
+uniform vec2 outputSize;        // ablak
+uniform bool sharpBilinear;     // false: nearest
+
+void main()
+{
+    vec2 texel = ScreenUV * sourceSize;
+    if (sharpBilinear) {
+        // Sharp-bilinear: a forrás-pixel belseje nearest, csak a széleken egy kimeneti pixelnyi
+        // lineáris átmenet, így nem-egész nagyításnál sem lesznek egyenetlen pixelek
+        vec2 pixelScale = outputSize / sourceSize;
+        vec2 center = floor(texel);
+        vec2 offset = fract(texel) - 0.5;
+        vec2 region = 0.5 - 0.5 / pixelScale;
+        offset = (offset - clamp(offset, -region, region)) * pixelScale + 0.5;
+        texel = center + offset;
+    }
+    else {
+        texel = floor(texel) + 0.5;
+    }
+    // a szélső pixel-középpontokon túl a lineáris szűrés már a kirajzolt részen kívülről keverne
+    texel = clamp(texel, vec2(0.5), sourceSize - 0.5);
+    FragColor = vec4(texture(scene, texel / textureSize).rgb, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#version 330 core
+// Teljes képernyős háromszög puffer nélkül; ScreenUV a kimeneten 0..1
+
+out vec2 ScreenUV;
+
+void main()
+{
+    vec2 ndc = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+    ScreenUV = ndc * 0.5 + 0.5;
+    gl_Position = vec4(ndc, 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,236 @@
+﻿#include "AllocationTracker.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <new>
+
+#ifdef RAVENS_TRACK_ALLOCATIONS
+
+namespace
+{
+    // Az operator new-ból hívódik: itt semmi nem foglalhat (fix tömb, atomi számlálók)
+    struct Site
+    {
+        const char* name = nullptr;
+        std::atomic<uint64_t> allocations{ 0 };
+        std::atomic<uint64_t> bytes{ 0 };
+    };
+
+    Site sites[AllocationTracker::kMaxSites];
+    std::atomic<int> siteCount{ 1 };    // 0: "(untagged)"
+    std::mutex siteMutex;
+    thread_local int currentSite = 0;
+
+    std::atomic<uint64_t> frameAllocations{ 0 };
+    std::atomic<uint64_t> frameBytes{ 0 };
+
+    int FindSite(const char* name, int count)
+    {
+        for (int i = 1; i < count; ++i) {
+            if (sites[i].name == name || std::strcmp(sites[i].name, name) == 0)
+                return i;
+        }
+        return -1;
+    }
+
+    // Egy hely első használatakor regisztrál; ha betelt, a "(untagged)" sorba számol
+    int RegisterSite(const char* name)
+    {
+        int index = FindSite(name, siteCount.load(std::memory_order_acquire));
+        if (index >= 0)
+            return index;
+
+        std::lock_guard<std::mutex> lock(siteMutex);
+        const int count = siteCount.load(std::memory_order_relaxed);
+        index = FindSite(name, count);
+        if (index >= 0)
+            return index;
+        if (count == AllocationTracker::kMaxSites)
+            return 0;
+        sites[count].name = name;
+        siteCount.store(count + 1, std::memory_order_release);
+        return count;
+    }
+
+    void RecordAllocation(size_t size)
+    {
+        frameAllocations.fetch_add(1, std::memory_order_relaxed);
+        frameBytes.fetch_add(size, std::memory_order_relaxed);
+        Site& site = sites[currentSite];
+        site.allocations.fetch_add(1, std::memory_order_relaxed);
+        site.bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void* Allocate(size_t size)
+    {
+        RecordAllocation(size);
+        return std::malloc(size ? size : 1);
+    }
+
+    void* AllocateAligned(size_t size, size_t alignment)
+    {
+        RecordAllocation(size);
+        alignment = std::max(alignment, sizeof(void*));
+#ifdef _WIN32
+        return _aligned_malloc(size ? size : 1, alignment);
+#else
+        void* pointer = nullptr;
+        return posix_memalign(&pointer, alignment, size ? size : 1) == 0 ? pointer : nullptr;
+#endif
+    }
+
+    void FreeAligned(void* pointer)
+    {
+#ifdef _WIN32
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+}
+
+void AllocationTracker::BeginFrame()
+{
+    frameAllocations.store(0, std::memory_order_relaxed);
+    frameBytes.store(0, std::memory_order_relaxed);
+    const int count = siteCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        sites[i].allocations.store(0, std::memory_order_relaxed);
+        sites[i].bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+AllocationTracker::Totals AllocationTracker::GetFrameTotals()
+{
+    Totals totals;
+    totals.allocations = frameAllocations.load(std::memory_order_relaxed);
+    totals.bytes = frameBytes.load(std::memory_order_relaxed);
+    return totals;
+}
+
+void AllocationTracker::PrintFrameReport()
+{
+    // a számlálók pillanatképe előbb: a kiírás maga is foglalhat
+    struct Row
+    {
+        const char* name;
+        uint64_t allocations;
+        uint64_t bytes;
+    };
+    Row rows[kMaxSites];
+    int rowCount = 0;
+    const int count = siteCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        const uint64_t allocations = sites[i].allocations.load(std::memory_order_relaxed);
+        if (allocations > 0)
+            rows[rowCount++] = { i == 0 ? "(untagged)" : sites[i].name, allocations, sites[i].bytes.load(std::memory_order_relaxed) };
+    }
+    const Totals totals = GetFrameTotals();
+    std::sort(rows, rows + rowCount, [](const Row& a, const Row& b) { return a.bytes > b.bytes; });
+
+    std::cout << "Frame heap allocations: " << totals.allocations << " (" << totals.bytes << " bytes)" << std::endl;
+    for (int i = 0; i < rowCount; ++i)
+        std::cout << "   " << rows[i].name << ": " << rows[i].allocations << " (" << rows[i].bytes << " bytes)" << std::endl;
+}
+
+AllocationTracker::Scope::Scope(const char* site)
+    : previousSite(currentSite)
+{
+    currentSite = RegisterSite(site);
+}
+
+AllocationTracker::Scope::~Scope()
+{
+    currentSite = previousSite;
+}
+
+// --- A globális operator new / delete cseréje
+void* operator new(std::size_t size)
+{
+    if (void* pointer = Allocate(size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (void* pointer = Allocate(size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void* pointer = AllocateAligned(size, static_cast<size_t>(alignment)))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    if (void* pointer = AllocateAligned(size, static_cast<size_t>(alignment)))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateAligned(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateAligned(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { FreeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { FreeAligned(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { FreeAligned(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { FreeAligned(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(pointer); }
+
+#else
+
+void AllocationTracker::BeginFrame()
+{
+}
+
+AllocationTracker::Totals AllocationTracker::GetFrameTotals()
+{
+    return Totals();
+}
+
+void AllocationTracker::PrintFrameReport()
+{
+}
+
+AllocationTracker::Scope::Scope(const char* site)
+    : previousSite(0)
+{
+}
+
+AllocationTracker::Scope::~Scope()
+{
+}
+
+#endif
@@ -0,0 +1,63 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Debug buildben alapból be; release-ben a RAVENS_TRACK_ALLOCATIONS definiálásával kérhető
+#if defined(_DEBUG) && !defined(RAVENS_TRACK_ALLOCATIONS)
+#define RAVENS_TRACK_ALLOCATIONS 1
+#endif
+
+// Heap-foglalások számlálása képkockánként (darab és bájt), hívási helyenként.
+// Bekapcsolva a globális operator new / delete cserélődik; kikapcsolva semmi nem változik, és
+// az ALLOCATION_SCOPE üres.
+//
+// A hívási hely a szálon éppen érvényes ALLOCATION_SCOPE neve (a legbelső): a forró utak
+// elején álló egy sor elég ahhoz, hogy a riport megmondja, honnan jön a foglalás.
+// Hely nélkül a "(untagged)" sorba kerül. A nevek statikus élettartamú literálok.
+class AllocationTracker
+{
+public:
+    static constexpr int kMaxSites = 64;
+
+    struct Totals
+    {
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+    };
+
+    static constexpr bool IsEnabled()
+    {
+#ifdef RAVENS_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // a képkocka számlálóinak nullázása (a fő szálon, a képkocka elején)
+    static void BeginFrame();
+    static Totals GetFrameTotals();
+    // a képkocka foglalásai helyenként, a legtöbbet foglaló elöl
+    static void PrintFrameReport();
+
+    class Scope
+    {
+    public:
+        explicit Scope(const char* site);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        int previousSite;
+    };
+};
+
+#ifdef RAVENS_TRACK_ALLOCATIONS
+#define RAVENS_ALLOCATION_CONCAT_(a, b) a##b
+#define RAVENS_ALLOCATION_CONCAT(a, b) RAVENS_ALLOCATION_CONCAT_(a, b)
+#define ALLOCATION_SCOPE(site) AllocationTracker::Scope RAVENS_ALLOCATION_CONCAT(allocationScope, __LINE__)(site)
+#else
+#define ALLOCATION_SCOPE(site) ((void)0)
+#endif
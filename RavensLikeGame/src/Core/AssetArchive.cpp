@@ -0,0 +1,98 @@
+﻿#include "AssetArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    uint64_t Fnv1a(const void* data, size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+uint64_t AssetArchive::HashPath(std::string_view path)
+{
+    return Fnv1a(path.data(), path.size());
+}
+
+uint64_t AssetArchive::HashContent(const uint8_t* data, size_t size)
+{
+    return Fnv1a(data, size);
+}
+
+bool AssetArchive::Open(const std::string& path)
+{
+    Close();
+    if (!file.Open(path))
+        return false;
+
+    // minden eltolást ellenőrzünk: egy csonka vagy régi archívum ne olvasson a leképezésen túl
+    const size_t size = file.Size();
+    Header header;
+    if (size < sizeof(Header)) {
+        std::cerr << "Asset archive too small: " << path << std::endl;
+        Close();
+        return false;
+    }
+    std::memcpy(&header, file.Data(), sizeof(header));
+
+    const bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0
+        && header.version == kVersion
+        && header.indexOffset % alignof(Entry) == 0
+        && header.indexOffset <= size
+        && header.entryCount <= (size - header.indexOffset) / sizeof(Entry)
+        && header.stringsOffset >= header.indexOffset + static_cast<uint64_t>(header.entryCount) * sizeof(Entry)
+        && header.stringsOffset <= size;
+    if (!valid) {
+        std::cerr << "Invalid asset archive: " << path << std::endl;
+        Close();
+        return false;
+    }
+
+    entries = reinterpret_cast<const Entry*>(file.Data() + header.indexOffset);
+    strings = reinterpret_cast<const char*>(file.Data() + header.stringsOffset);
+    entryCount = header.entryCount;
+
+    const uint64_t stringsSize = size - header.stringsOffset;
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        const Entry& entry = entries[i];
+        if (entry.offset > size || entry.storedSize > size - entry.offset
+            || entry.pathOffset + static_cast<uint64_t>(entry.pathLength) > stringsSize) {
+            std::cerr << "Corrupt asset archive entry " << i << ": " << path << std::endl;
+            Close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetArchive::Close()
+{
+    file.Close();
+    entries = nullptr;
+    strings = nullptr;
+    entryCount = 0;
+}
+
+const AssetArchive::Entry* AssetArchive::Find(std::string_view path) const
+{
+    if (!entries)
+        return nullptr;
+
+    const uint64_t hash = HashPath(path);
+    const Entry* end = entries + entryCount;
+    const Entry* it = std::lower_bound(entries, end, hash,
+        [](const Entry& entry, uint64_t value) { return entry.pathHash < value; });
+
+    for (; it != end && it->pathHash == hash; ++it)
+        if (std::string_view(strings + it->pathOffset, it->pathLength) == path)
+            return it;
+    return nullptr;
+}
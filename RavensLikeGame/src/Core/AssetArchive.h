@@ -0,0 +1,63 @@
+﻿#pragma once
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Egyetlen fájlba csomagolt assetek (AssetPacker készíti), leképezve olvasva.
+//
+// Felépítés: fejléc | adatok (bejegyzésenként a saját igazításán) | index | útvonal-tábla.
+// Az index az útvonal-hash szerint rendezett, így a keresés bináris keresés + egy
+// útvonal-összevetés (ütközés ellen). A tömörítetlen bejegyzések közvetlenül a leképezett
+// memóriából használhatók; az LZ4-es bejegyzéseket olvasáskor kell kitömöríteni.
+class AssetArchive
+{
+public:
+    static constexpr char kMagic[4] = { 'R', 'P', 'A', 'K' };
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint8_t kFlagLz4 = 1;
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t indexOffset;
+        uint64_t stringsOffset;
+    };
+
+    struct Entry
+    {
+        uint64_t pathHash;
+        uint64_t offset;
+        uint64_t storedSize;    // az archívumban (tömörítve)
+        uint64_t rawSize;       // kitömörítve
+        uint64_t contentHash;   // a nyers tartalomé: a feldolgozott cache-ek ezzel érvényesítenek
+        uint32_t pathOffset;    // az útvonal-táblában
+        uint16_t pathLength;
+        uint8_t alignmentLog2;
+        uint8_t flags;
+    };
+
+    static uint64_t HashPath(std::string_view path);
+    static uint64_t HashContent(const uint8_t* data, size_t size);
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return file.IsOpen(); }
+
+    // nullptr, ha nincs ilyen bejegyzés
+    const Entry* Find(std::string_view path) const;
+
+    // a bejegyzés tárolt bájtjai a leképezésben (tömörített bejegyzésnél az LZ4 blokk)
+    const uint8_t* StoredData(const Entry& entry) const { return file.Data() + entry.offset; }
+
+    uint32_t GetEntryCount() const { return entryCount; }
+
+private:
+    MappedFile file;
+    const Entry* entries = nullptr;
+    const char* strings = nullptr;
+    uint32_t entryCount = 0;
+};
@@ -0,0 +1,165 @@
+﻿#include "AssetPacker.h"
+#include "AssetArchive.h"
+#include "Lz4.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    struct PendingEntry
+    {
+        std::string path;
+        std::vector<uint8_t> stored;
+        AssetArchive::Entry entry{};
+    };
+
+    bool ReadWholeFile(const std::filesystem::path& path, std::vector<uint8_t>& out)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+        out.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        return out.empty() || file.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(out.size()));
+    }
+
+    // a PNG már tömörített: LZ4-gyel csak lassabb lenne, és így a leképezésből dekódolható
+    bool IsPrecompressed(const std::filesystem::path& path)
+    {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension == ".png" || extension == ".jpg" || extension == ".jpeg";
+    }
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+bool AssetPacker::Pack(const std::string& sourceDirectory, const std::string& archivePath)
+{
+    namespace fs = std::filesystem;
+
+    std::error_code error;
+    if (!fs::is_directory(sourceDirectory, error)) {
+        std::cerr << "Asset directory not found: " << sourceDirectory << std::endl;
+        return false;
+    }
+
+    const fs::path root = fs::path(sourceDirectory);
+    const std::string prefix = root.filename().generic_string();
+
+    std::vector<PendingEntry> pending;
+    for (const fs::directory_entry& item : fs::recursive_directory_iterator(root, error)) {
+        if (!item.is_regular_file())
+            continue;
+
+        PendingEntry current;
+        current.path = prefix + "/" + fs::relative(item.path(), root).generic_string();
+        if (current.path.size() > UINT16_MAX) {
+            std::cerr << "Asset path too long: " << current.path << std::endl;
+            return false;
+        }
+
+        std::vector<uint8_t> raw;
+        if (!ReadWholeFile(item.path(), raw)) {
+            std::cerr << "Failed to read asset: " << item.path().string() << std::endl;
+            return false;
+        }
+
+        AssetArchive::Entry& entry = current.entry;
+        entry.pathHash = AssetArchive::HashPath(current.path);
+        entry.rawSize = raw.size();
+        entry.contentHash = AssetArchive::HashContent(raw.data(), raw.size());
+
+        const bool image = IsPrecompressed(item.path());
+        if (!image && !raw.empty()) {
+            std::vector<uint8_t> compressed(Lz4::CompressBound(raw.size()));
+            const size_t compressedSize = Lz4::Compress(raw.data(), raw.size(), compressed.data(), compressed.size());
+            if (compressedSize > 0 && compressedSize < raw.size() * (1.0f - kMinCompressionGain)) {
+                compressed.resize(compressedSize);
+                current.stored = std::move(compressed);
+                entry.flags = AssetArchive::kFlagLz4;
+            }
+        }
+        if (!(entry.flags & AssetArchive::kFlagLz4))
+            current.stored = std::move(raw);
+        entry.storedSize = current.stored.size();
+
+        // szövegeknek elég a 16 bájt (SIMD-olvasás), a képeket és nagy blobokat laphatárra tesszük
+        entry.alignmentLog2 = (image || entry.rawSize >= kPageAlignThreshold) ? 12 : 4;
+        pending.push_back(std::move(current));
+    }
+    if (error) {
+        std::cerr << "Failed to enumerate assets: " << error.message() << std::endl;
+        return false;
+    }
+
+    std::sort(pending.begin(), pending.end(),
+        [](const PendingEntry& a, const PendingEntry& b) { return a.entry.pathHash < b.entry.pathHash; });
+
+    // elrendezés: fejléc | adatok | index | útvonalak
+    uint64_t offset = sizeof(AssetArchive::Header);
+    std::string strings;
+    for (PendingEntry& current : pending) {
+        offset = AlignUp(offset, uint64_t(1) << current.entry.alignmentLog2);
+        current.entry.offset = offset;
+        offset += current.entry.storedSize;
+
+        current.entry.pathOffset = static_cast<uint32_t>(strings.size());
+        current.entry.pathLength = static_cast<uint16_t>(current.path.size());
+        strings += current.path;
+    }
+
+    AssetArchive::Header header{};
+    std::memcpy(header.magic, AssetArchive::kMagic, sizeof(header.magic));
+    header.version = AssetArchive::kVersion;
+    header.entryCount = static_cast<uint32_t>(pending.size());
+    header.indexOffset = AlignUp(offset, alignof(AssetArchive::Entry));
+    header.stringsOffset = header.indexOffset + pending.size() * sizeof(AssetArchive::Entry);
+
+    std::ofstream out(archivePath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Failed to create asset archive: " << archivePath << std::endl;
+        return false;
+    }
+
+    uint64_t written = 0;
+    auto write = [&](const void* data, size_t size) {
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        written += size;
+    };
+    auto padTo = [&](uint64_t target) {
+        static const char zeros[4096] = {};
+        while (written < target)
+            write(zeros, static_cast<size_t>(std::min<uint64_t>(target - written, sizeof(zeros))));
+    };
+
+    write(&header, sizeof(header));
+    uint64_t rawTotal = 0;
+    for (const PendingEntry& current : pending) {
+        padTo(current.entry.offset);
+        write(current.stored.data(), current.stored.size());
+        rawTotal += current.entry.rawSize;
+    }
+    padTo(header.indexOffset);
+    for (const PendingEntry& current : pending)
+        write(&current.entry, sizeof(current.entry));
+    write(strings.data(), strings.size());
+
+    out.close();
+    if (!out) {
+        std::cerr << "Failed to write asset archive: " << archivePath << std::endl;
+        return false;
+    }
+
+    std::cout << "Packed " << pending.size() << " assets into " << archivePath << " ("
+        << rawTotal / 1024 << " KB -> " << written / 1024 << " KB)" << std::endl;
+    return true;
+}
@@ -0,0 +1,16 @@
+﻿#pragma once
+#include <string>
+
+// Az assets/ könyvtár becsomagolása egyetlen AssetArchive fájlba (build után: RavensLikeGame --pack).
+// A bejegyzések virtuális útvonala a forráskönyvtár nevével kezdődik ("assets/shaders/iso.vert"),
+// így a betöltők ugyanazzal az útvonallal érik el a csomagolt és a laza fájlt.
+class AssetPacker
+{
+public:
+    // a tömörítés csak akkor marad meg, ha legalább ennyivel kisebb (különben a kitömörítés nem éri meg)
+    static constexpr float kMinCompressionGain = 0.1f;
+    // ekkora blobtól laphatárra igazítunk, hogy a leképezett tartalom közvetlenül feltölthető legyen
+    static constexpr size_t kPageAlignThreshold = 64 * 1024;
+
+    static bool Pack(const std::string& sourceDirectory, const std::string& archivePath);
+};
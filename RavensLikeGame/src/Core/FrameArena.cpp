@@ -0,0 +1,61 @@
+﻿#include "FrameArena.h"
+#include <algorithm>
+#include <cstdint>
+
+LinearArena::LinearArena(size_t capacityBytes)
+    : buffer(std::make_unique_for_overwrite<std::byte[]>(capacityBytes)),
+      capacity(capacityBytes),
+      overflow(std::pmr::new_delete_resource())
+{
+}
+
+void* LinearArena::do_allocate(size_t bytes, size_t alignment)
+{
+    const uintptr_t base = reinterpret_cast<uintptr_t>(buffer.get());
+    size_t current = offset.load(std::memory_order_relaxed);
+    for (;;) {
+        const uintptr_t aligned = (base + current + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        const size_t next = static_cast<size_t>(aligned - base) + bytes;
+        if (next > capacity)
+            break;
+        if (offset.compare_exchange_weak(current, next, std::memory_order_relaxed))
+            return reinterpret_cast<void*>(aligned);
+    }
+
+    // betelt: a képkocka hátralévő része a heapről, a Reset-ig
+    overflowBytes.fetch_add(bytes + alignment, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(overflowMutex);
+    return overflow.allocate(bytes, alignment);
+}
+
+void LinearArena::Reset()
+{
+    const size_t used = offset.load(std::memory_order_relaxed) + overflowBytes.load(std::memory_order_relaxed);
+    peakBytes = std::max(peakBytes, used);
+
+    if (overflowBytes.load(std::memory_order_relaxed) > 0) {
+        overflow.release();
+        // a csúcs + 25%: kis ingadozásnál se kelljen újra nőni
+        capacity = peakBytes + peakBytes / 4;
+        buffer = std::make_unique_for_overwrite<std::byte[]>(capacity);
+    }
+    offset.store(0, std::memory_order_relaxed);
+    overflowBytes.store(0, std::memory_order_relaxed);
+}
+
+FrameArena& FrameArena::Get()
+{
+    static FrameArena instance;
+    return instance;
+}
+
+FrameArena::FrameArena(size_t capacityBytes)
+    : arenas{ LinearArena(capacityBytes), LinearArena(capacityBytes) }
+{
+}
+
+void FrameArena::BeginFrame()
+{
+    current ^= 1;
+    arenas[current].Reset();
+}
@@ -0,0 +1,74 @@
+﻿#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+
+// Bump allokátor egy összefüggő pufferből: a foglalás egy atomi eltolás-növelés (több szálról
+// is), a felszabadítás no-op, a Reset mindent egyszerre enged el. Ha a puffer betelik, a
+// maradék a heapről jön (overflow); a következő Reset akkorára növeli a puffert, hogy ugyanaz
+// a terhelés már beleférjen, így állandósult állapotban nincs heap-foglalás.
+class LinearArena : public std::pmr::memory_resource
+{
+public:
+    explicit LinearArena(size_t capacityBytes);
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    // csak akkor, amikor senki nem használja a belőle foglalt memóriát
+    void Reset();
+
+    size_t GetCapacity() const { return capacity; }
+    size_t GetUsedBytes() const { return offset.load(std::memory_order_relaxed); }
+    size_t GetOverflowBytes() const { return overflowBytes.load(std::memory_order_relaxed); }
+    size_t GetPeakBytes() const { return peakBytes; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    std::unique_ptr<std::byte[]> buffer;
+    size_t capacity;
+    std::atomic<size_t> offset{ 0 };
+    std::atomic<size_t> overflowBytes{ 0 };
+    size_t peakBytes = 0;       // a legnagyobb képkocka (puffer + overflow) eddig
+
+    std::mutex overflowMutex;
+    std::pmr::monotonic_buffer_resource overflow;
+};
+
+// Képkocka élettartamú átmeneti memória (rendezési, culling, batch-listák...), két
+// LinearArena felváltva: a BeginFrame után az előző képkocka foglalásai még egy képkockáig
+// érvényesek, így a worker szálak a fő szál következő képkockája alatt is olvashatják őket.
+//
+//   std::pmr::vector<SpriteInstance> visible(FrameArena::Get().Resource());
+//
+// A képkocka végén semmit nem kell felszabadítani; a konténert a képkockán túl nem szabad
+// megtartani (a következő előtti BeginFrame után a memóriája újrahasznosul).
+class FrameArena
+{
+public:
+    static constexpr size_t kDefaultCapacityBytes = 1u << 20;
+
+    static FrameArena& Get();
+
+    explicit FrameArena(size_t capacityBytes = kDefaultCapacityBytes);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // a fő szálon, a képkocka elején: a két fél cseréje, az új aktuális ürítése
+    void BeginFrame();
+
+    std::pmr::memory_resource* Resource() { return &arenas[current]; }
+    const LinearArena& GetCurrent() const { return arenas[current]; }
+    const LinearArena& GetPrevious() const { return arenas[current ^ 1]; }
+
+private:
+    LinearArena arenas[2];
+    int current = 0;
+};
@@ -12,6 +12,9 @@ namespace Globals
     inline constexpr float kClampBiasTilesX = 0.9f;
     inline constexpr float kClampBiasTilesY = 0.9f;
 
+    inline constexpr float kSpriteFootDepthLift = 0.5f;
+    inline constexpr float kDepthSortKeyRange = 4096.0f;
+
     constexpr unsigned int WindowWidth = 1600;
     constexpr unsigned int WindowHeight = 900;
     constexpr const char* WindowTitle = "RavensLikeGame";
@@ -19,11 +22,32 @@ namespace Globals
     inline float DashDistance = 180.0f;
     inline float DashDurationInSeconds = 0.2f;
     inline float DashCooldownInSeconds = 3.0f;
+    inline float DashTrailRate = 180.0f;    // csóva részecske/s dash közben
+
+    inline float ProjectileSpeed = 700.0f;
+    inline float ProjectileRadius = 4.0f;
+    inline float ProjectileLifetimeInSeconds = 1.5f;
+    inline float FireIntervalInSeconds = 0.08f;
+    inline float CrowdHitRadius = 10.0f;
+    inline float CrowdSeekSpeed = 40.0f;    // a tömeg-teszt köreinek sodródása a flow field mentén (px/s)
+
+    inline float DynamicResolutionBudgetMs = 14.0f;
+    inline int CrowdTestCount = 100000;
+    inline float StartupTargetMs = 200.0f;
+    inline int GLStatsCaptureFrames = 120;
+    inline int GLStatsTopCount = 15;
+    inline int AllocationWarmupFrames = 120;
 
     inline int KeyMoveUp = GLFW_KEY_W;
     inline int KeyMoveDown = GLFW_KEY_S;
     inline int KeyMoveLeft = GLFW_KEY_A;
     inline int KeyMoveRight = GLFW_KEY_D;
 	inline int DashKey = GLFW_KEY_SPACE;
+    inline int FireKey = GLFW_KEY_J;
+    inline int MapRenderModeKey = GLFW_KEY_F2;
+    inline int UpscaleFilterKey = GLFW_KEY_F3;
+    inline int CrowdTestKey = GLFW_KEY_F4;
+    inline int GLStatsKey = GLFW_KEY_F5;
+    inline int DebugOverlayKey = GLFW_KEY_F6;
     inline int DecreaseHealth = GLFW_KEY_M;
 }
\ No newline at end of file
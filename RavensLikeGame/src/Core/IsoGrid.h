@@ -0,0 +1,74 @@
+﻿#pragma once
+#include <algorithm>
+#include <cmath>
+#include <glm.hpp>
+#include "Globals.h"
+
+// Az izometrikus rács világ <-> csempe leképezése egy adott térkép-origóval.
+// Az IsoRenderer tölti ki, a játéklogika (lövedékek, navigáció) ezt használja,
+// így nem kell a rendererhez nyúlnia a forró ciklusokban.
+struct IsoGrid
+{
+    glm::vec2 origin{ 0.0f };
+    float halfWidth = 1.0f;
+    float halfHeight = 1.0f;
+
+    glm::ivec2 WorldToTile(const glm::vec2& worldPos) const
+    {
+        const glm::vec2 local = worldPos - origin;
+        const float gx = 0.5f * ((local.x / halfWidth) + (local.y / halfHeight)) - Globals::kClampBiasTilesX;
+        const float gy = 0.5f * ((local.y / halfHeight) - (local.x / halfWidth)) - Globals::kClampBiasTilesY;
+        return glm::ivec2(
+            static_cast<int>(std::floor(gx + 0.5f)),
+            static_cast<int>(std::floor(gy + 0.5f)));
+    }
+
+    // NDC mélység a rendezési kulcsból. footHeight (átló-egységben) előrébb hozza a sprite-ot,
+    // hogy a saját csempéje és az azonos átlón lévők előtt legyen.
+    static float DepthFromSortKey(float sortKey, float footHeight = 0.0f)
+    {
+        return std::clamp((sortKey - footHeight) / Globals::kDepthSortKeyRange, -1.0f, 1.0f);
+    }
+
+    // A láb csempéjének átlója (c + r). A csempe teteje egyetlen, az átlóból számolt mélységgel
+    // rajzolódik, ezért a sprite mélysége is ebből jön, nem a folytonos kulcsból: az a csempén
+    // belül [s - 1, s + 1) között mozog, így a csempe negyedében a padló takarná a lábat, egy
+    // másik negyedében pedig a sprite az elülső fal elé kerülne. A DepthFromSortKey(átló,
+    // kSpriteFootDepthLift) a saját átló és az elülső (s - 1) közé esik, mindkettőtől fél átlóra.
+    int TileDiagonal(const glm::vec2& worldPos) const
+    {
+        const glm::ivec2 tile = WorldToTile(worldPos);
+        return tile.x + tile.y;
+    }
+
+    float SpriteDepth(const glm::vec2& feet) const
+    {
+        return DepthFromSortKey(static_cast<float>(TileDiagonal(feet)), Globals::kSpriteFootDepthLift);
+    }
+
+    // Ugyanez shaderhez (crowd.vert, instanced_sprite.vert):
+    //   grid  = (origin, 1 / halfWidth, 1 / halfHeight)
+    //   depth = (kClampBiasTilesX, kClampBiasTilesY, átló → z skála, eltolás)
+    // A csupa nulla paraméter z = 0-t ad (mélység nélküli rajzolás).
+    struct SpriteDepthParams
+    {
+        glm::vec4 grid{ 0.0f };
+        glm::vec4 depth{ 0.0f };
+    };
+
+    SpriteDepthParams GetSpriteDepthParams() const
+    {
+        SpriteDepthParams params;
+        params.grid = glm::vec4(origin, 1.0f / halfWidth, 1.0f / halfHeight);
+        params.depth = glm::vec4(Globals::kClampBiasTilesX, Globals::kClampBiasTilesY,
+            1.0f / Globals::kDepthSortKeyRange, -Globals::kSpriteFootDepthLift / Globals::kDepthSortKeyRange);
+        return params;
+    }
+
+    glm::vec2 TileCenter(int col, int row) const
+    {
+        const float gx = col + Globals::kClampBiasTilesX;
+        const float gy = row + Globals::kClampBiasTilesY;
+        return origin + glm::vec2((gx - gy) * halfWidth, (gx + gy) * halfHeight);
+    }
+};
@@ -0,0 +1,160 @@
+﻿#include "Lz4.h"
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    constexpr size_t kMinMatch = 4;
+    constexpr size_t kLastLiterals = 5;     // a blokk utolsó 5 bájtja mindig literál
+    constexpr size_t kMatchFindLimit = 12;  // az utolsó egyezés legkésőbb ennyivel a vége előtt kezdődhet
+    constexpr size_t kMaxOffset = 65535;
+    constexpr int kHashBits = 12;
+
+    uint32_t Read32(const uint8_t* p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32_t Hash(uint32_t sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - kHashBits);
+    }
+
+    // 255-ös bájtok + maradék; false, ha nem fér el
+    bool WriteLength(uint8_t*& op, const uint8_t* end, size_t length)
+    {
+        while (length >= 255) {
+            if (op >= end) return false;
+            *op++ = 255;
+            length -= 255;
+        }
+        if (op >= end) return false;
+        *op++ = static_cast<uint8_t>(length);
+        return true;
+    }
+
+    bool WriteSequence(uint8_t*& op, const uint8_t* end, const uint8_t* literals, size_t literalLength,
+        size_t offset, size_t matchLength)
+    {
+        if (op >= end) return false;
+        uint8_t* token = op++;
+        *token = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4);
+        if (literalLength >= 15 && !WriteLength(op, end, literalLength - 15))
+            return false;
+
+        if (static_cast<size_t>(end - op) < literalLength)
+            return false;
+        std::memcpy(op, literals, literalLength);
+        op += literalLength;
+
+        if (matchLength == 0)
+            return true; // utolsó szakasz: csak literálok
+
+        if (end - op < 2) return false;
+        *op++ = static_cast<uint8_t>(offset & 0xFF);
+        *op++ = static_cast<uint8_t>(offset >> 8);
+
+        const size_t matchCode = matchLength - kMinMatch;
+        *token |= static_cast<uint8_t>(matchCode >= 15 ? 15 : matchCode);
+        return matchCode < 15 || WriteLength(op, end, matchCode - 15);
+    }
+}
+
+size_t Lz4::Compress(const uint8_t* source, size_t size, uint8_t* destination, size_t capacity)
+{
+    uint8_t* op = destination;
+    const uint8_t* end = destination + capacity;
+    size_t anchor = 0;
+
+    if (size > kMatchFindLimit) {
+        // pozíció + 1; a 0 jelenti az üres rést
+        std::vector<uint32_t> table(size_t(1) << kHashBits, 0);
+        const size_t matchStartLimit = size - kMatchFindLimit;
+        const size_t matchEndLimit = size - kLastLiterals;
+
+        size_t ip = 0;
+        while (ip < matchStartLimit) {
+            const uint32_t sequence = Read32(source + ip);
+            const uint32_t h = Hash(sequence);
+            const size_t candidate = table[h];
+            table[h] = static_cast<uint32_t>(ip + 1);
+
+            if (candidate == 0 || ip - (candidate - 1) > kMaxOffset || Read32(source + candidate - 1) != sequence) {
+                ++ip;
+                continue;
+            }
+
+            const size_t match = candidate - 1;
+            size_t length = kMinMatch;
+            while (ip + length < matchEndLimit && source[match + length] == source[ip + length])
+                ++length;
+
+            if (!WriteSequence(op, end, source + anchor, ip - anchor, ip - match, length))
+                return 0;
+            ip += length;
+            anchor = ip;
+        }
+    }
+
+    if (!WriteSequence(op, end, source + anchor, size - anchor, 0, 0))
+        return 0;
+    return static_cast<size_t>(op - destination);
+}
+
+bool Lz4::Decompress(const uint8_t* source, size_t size, uint8_t* destination, size_t rawSize)
+{
+    const uint8_t* ip = source;
+    const uint8_t* const inputEnd = source + size;
+    uint8_t* op = destination;
+    uint8_t* const outputEnd = destination + rawSize;
+
+    auto readLength = [&](size_t& length) {
+        uint8_t byte;
+        do {
+            if (ip >= inputEnd) return false;
+            byte = *ip++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+
+    while (ip < inputEnd) {
+        const uint8_t token = *ip++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(literalLength))
+            return false;
+        if (static_cast<size_t>(inputEnd - ip) < literalLength || static_cast<size_t>(outputEnd - op) < literalLength)
+            return false;
+        std::memcpy(op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        if (ip == inputEnd)
+            break; // az utolsó szakasznak nincs egyezés-része
+
+        if (inputEnd - ip < 2)
+            return false;
+        const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - destination))
+            return false;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(matchLength))
+            return false;
+        matchLength += kMinMatch;
+        if (static_cast<size_t>(outputEnd - op) < matchLength)
+            return false;
+
+        // átfedő másolás (offset < hossz: ismétlődő minta), ezért bájtonként
+        const uint8_t* match = op - offset;
+        for (size_t i = 0; i < matchLength; ++i)
+            op[i] = match[i];
+        op += matchLength;
+    }
+
+    return op == outputEnd;
+}
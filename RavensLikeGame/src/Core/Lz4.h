@@ -0,0 +1,19 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// LZ4 blokk-formátum (a referencia lz4 dekóderrel kompatibilis), külső függőség nélkül.
+// Mohó, egy hash-táblás tömörítő: a csomagoló (AssetPacker) használja, futásidőben csak
+// a kitömörítés kell, ami gyorsabb egy lemezolvasásnál.
+class Lz4
+{
+public:
+    // a legrosszabb eset (tömöríthetetlen bemenet) kimeneti mérete
+    static size_t CompressBound(size_t size) { return size + size / 255 + 16; }
+
+    // a kimenet mérete, 0, ha nem fér el a capacity-ben
+    static size_t Compress(const uint8_t* source, size_t size, uint8_t* destination, size_t capacity);
+
+    // false sérült bemenetnél vagy ha a kimenet nem pontosan rawSize bájt
+    static bool Decompress(const uint8_t* source, size_t size, uint8_t* destination, size_t rawSize);
+};
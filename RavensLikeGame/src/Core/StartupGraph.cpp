@@ -0,0 +1,147 @@
+﻿#include "StartupGraph.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+StartupGraph::StartupGraph(ThreadPool& pool, Clock::time_point origin)
+    : pool(pool), origin(origin)
+{
+}
+
+StartupGraph::~StartupGraph()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    taskDone.wait(lock, [this] {
+        return runningWorkers == 0;
+    });
+}
+
+StartupGraph::TaskId StartupGraph::Spawn(const std::string& name, std::vector<TaskId> dependencies, std::function<void()> task)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Task entry;
+    entry.name = name;
+    entry.dependencies = std::move(dependencies);
+    entry.run = std::move(task);
+    tasks.push_back(std::move(entry));
+    SubmitReady();
+    return static_cast<TaskId>(tasks.size() - 1);
+}
+
+StartupGraph::TaskId StartupGraph::Begin(const std::string& name, std::vector<TaskId> dependencies)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    // a fő szál lépései sorban futnak: az előző is függőség (a kritikus út ezen is átmehet)
+    if (lastMainTask >= 0)
+        dependencies.push_back(lastMainTask);
+
+    Task entry;
+    entry.name = name;
+    entry.onMainThread = true;
+    entry.dependencies = std::move(dependencies);
+    entry.submitted = true;
+    tasks.push_back(std::move(entry));
+    const TaskId id = static_cast<TaskId>(tasks.size() - 1);
+    lastMainTask = id;
+
+    Task& task = tasks[id];
+    task.queued = Clock::now();
+    taskDone.wait(lock, [&] { return DependenciesDone(task); });
+    task.start = Clock::now();
+    return id;
+}
+
+void StartupGraph::End(TaskId id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Task& task = tasks[id];
+    task.end = Clock::now();
+    task.done = true;
+    SubmitReady();
+    taskDone.notify_all();
+}
+
+bool StartupGraph::DependenciesDone(const Task& task) const
+{
+    return std::all_of(task.dependencies.begin(), task.dependencies.end(),
+        [this](TaskId dependency) { return tasks[dependency].done; });
+}
+
+void StartupGraph::SubmitReady()
+{
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        Task& task = tasks[i];
+        if (task.submitted || !DependenciesDone(task))
+            continue;
+
+        task.submitted = true;
+        task.queued = Clock::now();
+        ++runningWorkers;
+        pool.Submit([this, i]() {
+            // a deque elemei nem mozdulnak, de a Spawn közben bővülhet: a mezőket mutex alatt írjuk
+            std::function<void()> run;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks[i].start = Clock::now();
+                run = std::move(tasks[i].run);
+            }
+            run();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks[i].end = Clock::now();
+            tasks[i].done = true;
+            --runningWorkers;
+            SubmitReady();
+            taskDone.notify_all();
+        });
+    }
+}
+
+double StartupGraph::Ms(Clock::time_point time) const
+{
+    return std::chrono::duration<double, std::milli>(time - origin).count();
+}
+
+void StartupGraph::PrintReport(double targetMs) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // a kritikus út a legkésőbb befejezett lépésből visszafelé: mindig az a függőség,
+    // amelyik a legkésőbb végzett (arra várt ténylegesen a lépés)
+    std::vector<bool> critical(tasks.size(), false);
+    TaskId last = -1;
+    for (size_t i = 0; i < tasks.size(); ++i)
+        if (tasks[i].done && (last < 0 || tasks[i].end > tasks[last].end))
+            last = static_cast<TaskId>(i);
+    for (TaskId current = last; current >= 0;) {
+        critical[current] = true;
+        TaskId next = -1;
+        for (TaskId dependency : tasks[current].dependencies)
+            if (next < 0 || tasks[dependency].end > tasks[next].end)
+                next = dependency;
+        current = next;
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Startup (ms)           thread   start  duration  wait" << std::endl;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        const Task& task = tasks[i];
+        std::cout << (critical[i] ? " * " : "   ") << std::left << std::setw(20) << task.name << std::right
+            << std::setw(7) << (task.onMainThread ? "main" : "worker");
+        if (!task.done) {
+            std::cout << "  (not finished)" << std::endl;
+            continue;
+        }
+        std::cout << std::setw(8) << Ms(task.start)
+            << std::setw(10) << std::chrono::duration<double, std::milli>(task.end - task.start).count()
+            << std::setw(6) << std::chrono::duration<double, std::milli>(task.start - task.queued).count() << std::endl;
+    }
+
+    if (last >= 0) {
+        const double total = Ms(tasks[last].end);
+        std::cout << "   total " << total << " ms (target " << targetMs << " ms"
+            << (total <= targetMs ? ", met" : ", MISSED") << "), * = critical path" << std::endl;
+    }
+    std::cout << std::defaultfloat;
+}
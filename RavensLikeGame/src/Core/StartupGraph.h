@@ -0,0 +1,71 @@
+﻿#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// Az indítás lépései függőségi gráfként, mérve.
+//
+// A CPU-munka (fájlolvasás, dekódolás, parse) Spawn-nal a worker szálakon fut, amint a
+// függőségei elkészültek. A GL-t igénylő lépések a fő szálon maradnak: Begin megvárja a
+// függőségeit, End lezárja a lépést; a kettő között létrehozott objektumok a hívó
+// hatókörében élnek tovább. A fő szál lépései sorrendben egymásra is épülnek.
+// A riport lépésenként mutatja a kezdést, az időtartamot és a várakozást (fő szálon a
+// függőségekre, workeren a sorban töltött időt), és megjelöli
+// a kritikus utat (ami a legkésőbbi lépés befejezését ténylegesen meghatározta).
+class StartupGraph
+{
+public:
+    using TaskId = int;
+    using Clock = std::chrono::steady_clock;
+
+    // origin: ehhez mérünk (a folyamat indulásához legközelebbi pont a main elején)
+    StartupGraph(ThreadPool& pool, Clock::time_point origin);
+    // megvárja a még futó worker lépéseket (azok a hívó lokális változóira hivatkozhatnak)
+    ~StartupGraph();
+
+    StartupGraph(const StartupGraph&) = delete;
+    StartupGraph& operator=(const StartupGraph&) = delete;
+
+    TaskId Spawn(const std::string& name, std::vector<TaskId> dependencies, std::function<void()> task);
+
+    TaskId Begin(const std::string& name, std::vector<TaskId> dependencies = {});
+    void End(TaskId id);
+
+    double ElapsedMs() const { return Ms(Clock::now()); }
+
+    // az eddigi lépések riportja; targetMs a célidő a legkésőbbi befejezésig
+    void PrintReport(double targetMs) const;
+
+private:
+    struct Task
+    {
+        std::string name;
+        bool onMainThread = false;
+        std::vector<TaskId> dependencies;
+        std::function<void()> run;
+        bool submitted = false;
+        bool done = false;
+        Clock::time_point queued;   // fő szálon a Begin hívása, workeren a függőségek elkészülte
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    ThreadPool& pool;
+    const Clock::time_point origin;
+    TaskId lastMainTask = -1;
+
+    mutable std::mutex mutex;
+    std::condition_variable taskDone;
+    std::deque<Task> tasks;     // deque: a hivatkozások a bővítés után is érvényesek
+    int runningWorkers = 0;
+
+    bool DependenciesDone(const Task& task) const;
+    void SubmitReady();         // mutex alatt hívandó
+    double Ms(Clock::time_point time) const;
+};
@@ -0,0 +1,174 @@
+﻿#include "ThreadPool.h"
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+struct ThreadPool::ParallelForState
+{
+    std::atomic<int> nextChunk{ 0 };
+    std::atomic<int> remainingChunks{ 0 };
+    std::atomic<int> pendingHelpers{ 0 };
+    bool inUse = false;     // parallelStatesMutex alatt
+    int chunkCount = 0;
+    int count = 0;
+    int grainSize = 1;
+    const std::function<void(int, int)>* fn = nullptr;
+    std::mutex doneMutex;
+    std::condition_variable done;
+};
+
+// Darabokat vesz ki a közös számlálóból, amíg el nem fogynak
+void ThreadPool::RunChunks(ParallelForState& state)
+{
+    for (;;) {
+        const int chunk = state.nextChunk.fetch_add(1);
+        if (chunk >= state.chunkCount)
+            return;
+
+        const int begin = chunk * state.grainSize;
+        const int end = std::min(state.count, begin + state.grainSize);
+        (*state.fn)(begin, end);
+
+        if (state.remainingChunks.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(state.doneMutex);
+            state.done.notify_all();
+        }
+    }
+}
+
+ThreadPool::ThreadPool(unsigned int workerCount)
+{
+    if (workerCount == 0) {
+        const unsigned int hw = std::thread::hardware_concurrency();
+        workerCount = (hw > 1) ? hw - 1 : 1;
+    }
+
+    workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; ++i)
+        workers.emplace_back([this] { WorkerLoop(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+void ThreadPool::Submit(std::function<void()> job)
+{
+    ALLOCATION_SCOPE("ThreadPool::Submit");
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (jobCount == jobs.size()) {
+            // betelt: sorrendben átmásoljuk egy kétszer akkorába, a fej a 0. helyre kerül
+            std::vector<std::function<void()>> grown(std::max<size_t>(16, jobs.size() * 2));
+            for (size_t i = 0; i < jobCount; ++i)
+                grown[i] = std::move(jobs[(jobHead + i) % jobs.size()]);
+            jobs.swap(grown);
+            jobHead = 0;
+        }
+        jobs[(jobHead + jobCount) % jobs.size()] = std::move(job);
+        ++jobCount;
+    }
+    jobAvailable.notify_one();
+}
+
+ThreadPool::ParallelForState& ThreadPool::AcquireParallelState()
+{
+    std::lock_guard<std::mutex> lock(parallelStatesMutex);
+    for (const std::unique_ptr<ParallelForState>& state : parallelStates) {
+        if (!state->inUse && state->pendingHelpers.load(std::memory_order_acquire) == 0) {
+            state->inUse = true;
+            return *state;
+        }
+    }
+    parallelStates.push_back(std::make_unique<ParallelForState>());
+    parallelStates.back()->inUse = true;
+    return *parallelStates.back();
+}
+
+void ThreadPool::ReleaseParallelState(ParallelForState& state)
+{
+    std::lock_guard<std::mutex> lock(parallelStatesMutex);
+    state.inUse = false;
+}
+
+void ThreadPool::ParallelFor(int count, int grainSize, const std::function<void(int begin, int end)>& fn)
+{
+    if (count <= 0)
+        return;
+
+    grainSize = std::max(1, grainSize);
+    const int chunkCount = (count + grainSize - 1) / grainSize;
+    if (chunkCount == 1 || workers.empty()) {
+        fn(0, count);
+        return;
+    }
+
+    // A segéd job-ok túlélhetik a hívást (későn indulnak): az állapot a poolé, és csak akkor
+    // kerül újra sorra, ha mind lefutott. A job csak egy mutatót visz, így a std::function
+    // sem foglal.
+    // csak annyi segéd, ahány worker éppen ráér: a sorban ragadt segédek csak feltartanák
+    // az állapotot (a hívó szál addigra úgyis elvégzi a darabokat)
+    int helpers;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        helpers = std::clamp(static_cast<int>(idleWorkers) - static_cast<int>(jobCount), 0, chunkCount - 1);
+    }
+    if (helpers == 0) {
+        fn(0, count);
+        return;
+    }
+
+    ALLOCATION_SCOPE("ThreadPool::ParallelFor");
+    ParallelForState& state = AcquireParallelState();
+    state.nextChunk = 0;
+    state.chunkCount = chunkCount;
+    state.remainingChunks = chunkCount;
+    state.pendingHelpers = helpers;
+    state.count = count;
+    state.grainSize = grainSize;
+    state.fn = &fn;
+
+    ParallelForState* shared = &state;
+    for (int i = 0; i < helpers; ++i) {
+        Submit([shared] {
+            RunChunks(*shared);
+            shared->pendingHelpers.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    RunChunks(state);
+
+    {
+        std::unique_lock<std::mutex> lock(state.doneMutex);
+        state.done.wait(lock, [&] { return state.remainingChunks.load() == 0; });
+    }
+    ReleaseParallelState(state);
+}
+
+void ThreadPool::WorkerLoop()
+{
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ++idleWorkers;
+            jobAvailable.wait(lock, [this] { return stopping || jobCount > 0; });
+            --idleWorkers;
+            if (stopping && jobCount == 0)
+                return;
+            job = std::move(jobs[jobHead]);
+            jobs[jobHead] = nullptr;
+            jobHead = (jobHead + 1) % jobs.size();
+            --jobCount;
+        }
+        job();
+    }
+}
@@ -0,0 +1,48 @@
+﻿#pragma once
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+public:
+    // 0 → hardware_concurrency - 1 (a hívó szál is dolgozik a ParallelFor-ban)
+    explicit ThreadPool(unsigned int workerCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Submit(std::function<void()> job);
+
+    // [0, count) felosztása grainSize méretű darabokra; blokkol, amíg minden darab kész
+    void ParallelFor(int count, int grainSize, const std::function<void(int begin, int end)>& fn);
+
+    unsigned int GetWorkerCount() const { return static_cast<unsigned int>(workers.size()); }
+
+private:
+    struct ParallelForState;
+
+    std::vector<std::thread> workers;
+    // gyűrűpuffer: a kapacitás csak nő, így a sorba állítás állandósult állapotban nem foglal
+    std::vector<std::function<void()>> jobs;
+    size_t jobHead = 0;
+    size_t jobCount = 0;
+    unsigned int idleWorkers = 0;   // a jobra váró workerek (mutex alatt)
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    bool stopping = false;
+
+    // A ParallelFor állapotai újrahasznosítva; egy állapot akkor szabad, ha a hívása véget ért
+    // és minden segéd job-ja lefutott (a késve induló segédek még hivatkozhatnak rá)
+    std::vector<std::unique_ptr<ParallelForState>> parallelStates;
+    std::mutex parallelStatesMutex;
+
+    void WorkerLoop();
+    ParallelForState& AcquireParallelState();
+    void ReleaseParallelState(ParallelForState& state);
+    static void RunChunks(ParallelForState& state);
+};
@@ -1,182 +1,364 @@
 ﻿#include "UIRenderer.h"
 #include "../Core/Globals.h"
+#include "../Core/AllocationTracker.h"
+#include "../Renderer/InstancedSpriteRenderer.h"
 #include <glad/glad.h>
+#include <gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 
-UIRenderer::UIRenderer(Shader& shader) : shader(shader) {
-    InitRenderData();
+UIRenderer::UIRenderer(Shader& shader)
+    : shader(shader), screenSize((float)Globals::WindowWidth, (float)Globals::WindowHeight)
+{
+    projectionLocation = glGetUniformLocation(shader.ID, "projection");
+    shader.Use();
+    shader.SetInt("uiAtlas", 0);
+
+    // atlasz nélkül a sima elemek ezt az egy fehér texelt mintázzák
+    const uint8_t white[4] = { 255, 255, 255, 255 };
+    whiteTexture = GLTexture::Create();
+    glBindTexture(GL_TEXTURE_2D, whiteTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    atlasTexture = whiteTexture;
+
+    vao = GLVertexArray::Create();
+    vbo = GLBuffer::Create();
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-UIRenderer::~UIRenderer() {
-    glDeleteVertexArrays(1, &vaoHealthBarBorder);
-    glDeleteBuffers(1, &vboHealthBarBorder);
-
-    glDeleteVertexArrays(1, &vaoHealthBarBackground);
-    glDeleteBuffers(1, &vboHealthBarBackground);
-
-    glDeleteVertexArrays(1, &vaoHealthBarFill);
-    glDeleteBuffers(1, &vboHealthBarFill);
+UIRenderer::WidgetId UIRenderer::AddPanel(const Shape& shape, const glm::vec4& color)
+{
+    Widget widget;
+    widget.type = WidgetType::Panel;
+    widget.shape = shape;
+    widget.color = InstancedSpriteRenderer::PackColor(color);
+    return AddWidget(widget, 6);
 }
 
-void UIRenderer::InitRenderData()
+UIRenderer::WidgetId UIRenderer::AddBar(const Shape& shape, const glm::vec4& backgroundColor, const glm::vec4& fillColor,
+    FillDirection direction)
 {
-    InitHealthBarBorderVAO();
-    InitHealthBarBackgroundVAO();
-    InitHealthBarForegroundVAO();
+    Widget widget;
+    widget.type = WidgetType::Bar;
+    widget.direction = direction;
+    widget.shape = shape;
+    widget.color = InstancedSpriteRenderer::PackColor(fillColor);
+    widget.backgroundColor = InstancedSpriteRenderer::PackColor(backgroundColor);
+    return AddWidget(widget, 12);
 }
 
-void UIRenderer::InitHealthBarBorderVAO()
+UIRenderer::WidgetId UIRenderer::AddIcon(const Shape& shape, const glm::vec4& uvRect, const glm::vec4& tint)
 {
-	float offset = defaultOffset + 5.0f;
-    const float whiteW = 308.0f;
-    const float whiteH = 33.0f;
-
-    float whiteVertices[] = {
-        offset,        0.0f,
-        0.0f,         whiteH,
-        whiteW,       whiteH,
-        whiteW + offset, 0.0f
-    };
-
-    glGenVertexArrays(1, &vaoHealthBarBorder);
-    glGenBuffers(1, &vboHealthBarBorder);
-    glBindVertexArray(vaoHealthBarBorder);
-    glBindBuffer(GL_ARRAY_BUFFER, vboHealthBarBorder);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(whiteVertices), whiteVertices, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    Widget widget;
+    widget.type = WidgetType::Icon;
+    widget.shape = shape;
+    widget.uvRect = uvRect;
+    widget.color = InstancedSpriteRenderer::PackColor(tint);
+    return AddWidget(widget, 6);
 }
 
-void UIRenderer::InitHealthBarBackgroundVAO()
+UIRenderer::WidgetId UIRenderer::AddText(const glm::vec2& position, uint32_t maxGlyphs, float scale, const glm::vec4& color)
 {
-	float normalizedOffset = defaultOffset / 300.0f;
-    float unitParallelogram[] = {
-        normalizedOffset, 0.0f,
-        0.0f, 1.0f,
-        1.0f, 1.0f,
-        1.0f + normalizedOffset, 0.0f
-    };
-
-    glGenVertexArrays(1, &vaoHealthBarBackground);
-    glGenBuffers(1, &vboHealthBarBackground);
-    glBindVertexArray(vaoHealthBarBackground);
-    glBindBuffer(GL_ARRAY_BUFFER, vboHealthBarBackground);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(unitParallelogram), unitParallelogram, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    Widget widget;
+    widget.type = WidgetType::Text;
+    widget.shape.position = position;
+    widget.scale = scale;
+    widget.color = InstancedSpriteRenderer::PackColor(color);
+    // a szóközök és az ékezetes betűk miatt bőven: a SetText ne foglaljon
+    widget.text.reserve((size_t)maxGlyphs * 2);
+    return AddWidget(widget, maxGlyphs * 6);
 }
 
-void UIRenderer::InitHealthBarForegroundVAO()
+UIRenderer::WidgetId UIRenderer::AddWidget(const Widget& widget, uint32_t vertexCount)
 {
-    glGenVertexArrays(1, &vaoHealthBarFill);
-    glGenBuffers(1, &vboHealthBarFill);
-    glBindVertexArray(vaoHealthBarFill);
-    glBindBuffer(GL_ARRAY_BUFFER, vboHealthBarFill);
-    glBufferData(GL_ARRAY_BUFFER, 4 * 2 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    const WidgetId id = static_cast<WidgetId>(widgets.size());
+    widgets.push_back(widget);
+    widgets.back().firstVertex = static_cast<uint32_t>(vertices.size());
+    widgets.back().vertexCount = vertexCount;
+    vertices.resize(vertices.size() + vertexCount);
+    MarkDirty(id);
+
+    stats.widgets = widgets.size();
+    stats.vertices = vertices.size();
+    return id;
 }
 
-void UIRenderer::DrawHealthBar(int currentHealth, int maxHealth)
+void UIRenderer::SetBarValue(WidgetId id, float value)
 {
-    float ratio = glm::clamp((float)currentHealth / (float)maxHealth, 0.0f, 1.0f);
-
-    float screenWidth = Globals::WindowWidth;
-    float screenHeight = Globals::WindowHeight;
-    glm::vec2 whitePos(screenWidth - innerBarWidth - 36.5f, 16.0f);
-    glm::vec2 grayPos(screenWidth - innerBarWidth - 30.0f, 20.0f);
-
-    SetupUIRendering(screenWidth, screenHeight);
-
-    DrawHealthBarBorder(whitePos);
-    DrawHealthBarBackground(grayPos);
-
-    if (currentHealth > 0 && currentHealth <= maxHealth)
-        DrawHealthBarForeground(grayPos, ratio);
-
-    RestoreDefaultShaderState();
+    Widget& widget = widgets[id];
+    value = glm::clamp(value, 0.0f, 1.0f);
+    // fél pixel alatti változás nem látszik; az üres és a teli állapotot viszont pontosan el kell érni
+    const bool reachedEnd = (value == 0.0f || value == 1.0f) && value != widget.value;
+    if (std::abs(value - widget.value) * widget.shape.size.x < 0.5f && !reachedEnd)
+        return;
+    widget.value = value;
+    MarkDirty(id);
 }
 
-void UIRenderer::SetupUIRendering(float screenWidth, float screenHeight)
+void UIRenderer::SetColor(WidgetId id, const glm::vec4& color)
 {
-    shader.Use();
-    glUniform1i(glGetUniformLocation(shader.ID, "useView"), false);
-    glUniform1i(glGetUniformLocation(shader.ID, "useColorOnly"), true);
-
-    glm::mat4 projection = glm::ortho(0.0f, screenWidth, 0.0f, screenHeight, -1.0f, 1.0f);
-    glm::mat4 view = glm::mat4(1.0f);
-    glUniformMatrix4fv(glGetUniformLocation(shader.ID, "projection"), 1, GL_FALSE, &projection[0][0]);
-    glUniformMatrix4fv(glGetUniformLocation(shader.ID, "view"), 1, GL_FALSE, &view[0][0]);
+    const uint32_t packed = InstancedSpriteRenderer::PackColor(color);
+    if (widgets[id].color == packed)
+        return;
+    widgets[id].color = packed;
+    MarkDirty(id);
 }
 
-void UIRenderer::DrawHealthBarBorder(const glm::vec2& position)
+void UIRenderer::SetShape(WidgetId id, const Shape& shape)
 {
-    glBindVertexArray(vaoHealthBarBorder);
+    Widget& widget = widgets[id];
+    if (widget.shape.position == shape.position && widget.shape.size == shape.size && widget.shape.slant == shape.slant)
+        return;
+    widget.shape = shape;
+    MarkDirty(id);
+}
 
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(position, uiLayerDepth));
-    glUniformMatrix4fv(glGetUniformLocation(shader.ID, "model"), 1, GL_FALSE, &model[0][0]);
+void UIRenderer::SetVisible(WidgetId id, bool visible)
+{
+    if (widgets[id].visible == visible)
+        return;
+    widgets[id].visible = visible;
+    MarkDirty(id);
+}
 
-    glm::vec3 borderColor = glm::vec3(1.0f, 1.0f, 1.0f);
-    glUniform3fv(glGetUniformLocation(shader.ID, "spriteColor"), 1, &borderColor[0]);
+void UIRenderer::SetText(WidgetId id, std::string_view utf8)
+{
+    const TextSpan span{ utf8 };
+    SetTextSpans(id, &span, 1, true);
+}
 
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-    glBindVertexArray(0);
+void UIRenderer::SetText(WidgetId id, std::initializer_list<TextSpan> spans)
+{
+    SetTextSpans(id, spans.begin(), spans.size(), false);
 }
 
-void UIRenderer::DrawHealthBarBackground(const glm::vec2& position)
+void UIRenderer::SetTextSpans(WidgetId id, const TextSpan* spans, size_t count, bool inheritColor)
 {
-    glBindVertexArray(vaoHealthBarBackground);
+    // elrendezés-cache: ugyanaz a szöveg ugyanazokkal a színekkel a meglévő csúcsokkal megy tovább
+    Widget& widget = widgets[id];
+    if (IsSameText(widget, spans, count, inheritColor))
+        return;
+
+    widget.text.clear();
+    widget.spanCount = 0;
+    for (size_t i = 0; i < count && widget.spanCount < kMaxTextSpans; ++i) {
+        if (spans[i].text.empty())
+            continue;
+        widget.text.append(spans[i].text);
+        SpanColor& span = widget.spans[widget.spanCount++];
+        span.end = static_cast<uint32_t>(widget.text.size());
+        span.color = inheritColor ? 0 : InstancedSpriteRenderer::PackColor(spans[i].color);
+        span.inheritColor = inheritColor;
+    }
+    MarkDirty(id);
+}
 
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(position, uiLayerDepth - 0.01f));
-    model = glm::scale(model, glm::vec3(innerBarWidth, innerBarHeight, 1.0f));
-    glUniformMatrix4fv(glGetUniformLocation(shader.ID, "model"), 1, GL_FALSE, &model[0][0]);
+// a szöveg bájtjait a tárolt szövegen veti össze, másolat és hash nélkül
+bool UIRenderer::IsSameText(const Widget& widget, const TextSpan* spans, size_t count, bool inheritColor) const
+{
+    size_t offset = 0;
+    uint32_t stored = 0;
+    for (size_t i = 0; i < count && stored < kMaxTextSpans; ++i) {
+        const std::string_view text = spans[i].text;
+        if (text.empty())
+            continue;
+        if (stored >= widget.spanCount || widget.text.compare(offset, text.size(), text) != 0)
+            return false;
+        const SpanColor& span = widget.spans[stored++];
+        offset += text.size();
+        if (span.end != offset || span.inheritColor != inheritColor)
+            return false;
+        if (!inheritColor && span.color != InstancedSpriteRenderer::PackColor(spans[i].color))
+            return false;
+    }
+    return stored == widget.spanCount && offset == widget.text.size();
+}
 
-    glm::vec3 backgroundColor = glm::vec3(0.3f, 0.3f, 0.3f);
-    glUniform3fv(glGetUniformLocation(shader.ID, "spriteColor"), 1, &backgroundColor[0]);
+void UIRenderer::SetAtlas(unsigned int texture, const glm::vec2& whiteTexelUv)
+{
+    atlasTexture = texture ? texture : whiteTexture.Get();
+    whiteUv = texture ? whiteTexelUv : glm::vec2(0.5f);
+    for (WidgetId id = 0; id < widgets.size(); ++id)
+        MarkDirty(id);
+}
 
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-    glBindVertexArray(0);
+void UIRenderer::SetFont(const BitmapFont& textFont)
+{
+    font = &textFont;
+    SetAtlas(textFont.GetAtlas(), textFont.GetWhiteUv());
 }
 
-void UIRenderer::DrawHealthBarForeground(const glm::vec2& position, float ratio)
+void UIRenderer::SetScreenSize(float width, float height)
 {
-    float visibleWidth = innerBarWidth * ratio;
-    float missingWidth = innerBarWidth - visibleWidth;
+    if (screenSize == glm::vec2(width, height))
+        return;
+    screenSize = glm::vec2(width, height);
+    projectionDirty = true;
+}
 
-    float greenVertices[] = {
-        missingWidth + defaultOffset, 0.0f,
-        missingWidth, innerBarHeight,
-        innerBarWidth, innerBarHeight,
-        innerBarWidth + defaultOffset, 0.0f
-    };
+void UIRenderer::MarkDirty(WidgetId id)
+{
+    Widget& widget = widgets[id];
+    widget.dirty = true;
+    dirtyFirst = std::min(dirtyFirst, widget.firstVertex);
+    dirtyLast = std::max(dirtyLast, widget.firstVertex + widget.vertexCount);
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, vboHealthBarFill);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(greenVertices), nullptr, GL_DYNAMIC_DRAW);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(greenVertices), greenVertices);
+void UIRenderer::Update()
+{
+    ALLOCATION_SCOPE("UIRenderer::Update");
+    stats.rebuiltWidgets = 0;
+    stats.uploadBytes = 0;
+    stats.textLayouts = 0;
+    if (dirtyFirst >= dirtyLast)
+        return;
+
+    for (Widget& widget : widgets) {
+        if (!widget.dirty)
+            continue;
+        BuildWidget(widget);
+        widget.dirty = false;
+        ++stats.rebuiltWidgets;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    if (vertices.size() > bufferCapacity) {
+        // új widget után: nagyobb puffer, benne minden csúcs (csak a HUD felépítésekor)
+        bufferCapacity = vertices.capacity();
+        glBufferData(GL_ARRAY_BUFFER, bufferCapacity * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+        dirtyFirst = 0;
+        dirtyLast = static_cast<uint32_t>(vertices.size());
+    }
+    const size_t bytes = (dirtyLast - dirtyFirst) * sizeof(Vertex);
+    glBufferSubData(GL_ARRAY_BUFFER, dirtyFirst * sizeof(Vertex), bytes, vertices.data() + dirtyFirst);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    glBindVertexArray(vaoHealthBarFill);
+    stats.uploadBytes = bytes;
+    uploadedVertices = static_cast<uint32_t>(vertices.size());
+    dirtyFirst = UINT32_MAX;
+    dirtyLast = 0;
+}
 
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(position, uiLayerDepth - 0.02f));
-    glUniformMatrix4fv(glGetUniformLocation(shader.ID, "model"), 1, GL_FALSE, &model[0][0]);
+void UIRenderer::Record(CommandBuffer& commands, uint32_t order)
+{
+    if (uploadedVertices == 0)
+        return;
+
+    // a program csak az UI-é: a vetítés a következő méretváltásig a programban marad
+    if (projectionDirty) {
+        commands.SetMat4(projectionLocation, glm::ortho(0.0f, screenSize.x, 0.0f, screenSize.y, -1.0f, 1.0f));
+        projectionDirty = false;
+    }
+
+    DrawCommand command;
+    command.program = shader.ID;
+    command.texture = atlasTexture;
+    command.vao = vao;
+    command.primitive = GL_TRIANGLES;
+    command.count = static_cast<int32_t>(uploadedVertices);
+    command.state = kStateBlend;
+    commands.Record(RenderPass::UI, order, command);
+}
 
-    glm::vec3 foregroundColor = glm::vec3(0.0f, 1.0f, 0.0f);
-    glUniform3fv(glGetUniformLocation(shader.ID, "spriteColor"), 1, &foregroundColor[0]);
+void UIRenderer::BuildWidget(Widget& widget)
+{
+    Vertex* out = vertices.data() + widget.firstVertex;
+    if (widget.type == WidgetType::Text) {
+        stats.glyphs -= widget.glyphCount;
+        widget.glyphCount = widget.visible ? BuildText(widget, out) : 0;
+        stats.glyphs += widget.glyphCount;
+        ++stats.textLayouts;
+    }
+    if (!widget.visible) {
+        // nulla területű háromszögek: a rajzolás tartománya nem változik
+        std::fill(out, out + widget.vertexCount, Vertex{});
+        return;
+    }
+
+    const glm::vec4 white(whiteUv, whiteUv);
+    switch (widget.type) {
+    case WidgetType::Panel:
+        WriteQuad(out, widget.shape, 0.0f, 1.0f, white, widget.color);
+        break;
+    case WidgetType::Icon:
+        WriteQuad(out, widget.shape, 0.0f, 1.0f, widget.uvRect, widget.color);
+        break;
+    case WidgetType::Bar:
+        WriteQuad(out, widget.shape, 0.0f, 1.0f, white, widget.backgroundColor);
+        if (widget.direction == FillDirection::LeftToRight)
+            WriteQuad(out + 6, widget.shape, 0.0f, widget.value, white, widget.color);
+        else
+            WriteQuad(out + 6, widget.shape, 1.0f - widget.value, 1.0f, white, widget.color);
+        break;
+    case WidgetType::Text:
+        break;
+    }
+}
 
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-    glBindVertexArray(0);
+// A glifek a toll mentén, a tartomány maradéka nulla területű; visszaadja a glifek számát
+uint32_t UIRenderer::BuildText(const Widget& widget, Vertex* out) const
+{
+    const uint32_t capacity = widget.vertexCount / 6;
+    uint32_t glyphCount = 0;
+    if (font) {
+        const float lineHeight = font->GetLineHeight() * widget.scale;
+        glm::vec2 pen = widget.shape.position;
+        uint32_t span = 0;
+        size_t index = 0;
+        while (index < widget.text.size() && glyphCount < capacity) {
+            while (span + 1 < widget.spanCount && index >= widget.spans[span].end)
+                ++span;
+            const uint32_t codepoint = BitmapFont::DecodeUtf8(widget.text, index);
+            if (codepoint == '\n') {
+                pen = glm::vec2(widget.shape.position.x, pen.y - lineHeight);
+                continue;
+            }
+
+            const BitmapFont::Glyph& glyph = font->GetGlyph(codepoint);
+            if (glyph.visible) {
+                const SpanColor& spanColor = widget.spans[span];
+                const Shape quad{ pen + glyph.offset * widget.scale, glyph.size * widget.scale, 0.0f };
+                WriteQuad(out + glyphCount * 6, quad, 0.0f, 1.0f, glyph.uvRect, spanColor.inheritColor ? widget.color : spanColor.color);
+                ++glyphCount;
+            }
+            pen.x += glyph.advance * widget.scale;
+        }
+    }
+    std::fill(out + glyphCount * 6, out + widget.vertexCount, Vertex{});
+    return glyphCount;
 }
 
-void UIRenderer::RestoreDefaultShaderState()
+// A forma [u0, u1] vízszintes szelete két háromszögként; a ferde oldalak a slant szerint
+void UIRenderer::WriteQuad(Vertex* out, const Shape& shape, float u0, float u1, const glm::vec4& uvRect, uint32_t color) const
 {
-    glUniform1i(glGetUniformLocation(shader.ID, "useView"), true);
-    glUniform1i(glGetUniformLocation(shader.ID, "useColorOnly"), false);
-}
\ No newline at end of file
+    const float x0 = shape.position.x + shape.size.x * u0;
+    const float x1 = shape.position.x + shape.size.x * u1;
+    const float y0 = shape.position.y;
+    const float y1 = shape.position.y + shape.size.y;
+    const float s0 = uvRect.x + (uvRect.z - uvRect.x) * u0;
+    const float s1 = uvRect.x + (uvRect.z - uvRect.x) * u1;
+
+    const Vertex bottomLeft{ { x0, y0 }, { s0, uvRect.y }, color };
+    const Vertex bottomRight{ { x1, y0 }, { s1, uvRect.y }, color };
+    const Vertex topRight{ { x1 + shape.slant, y1 }, { s1, uvRect.w }, color };
+    const Vertex topLeft{ { x0 + shape.slant, y1 }, { s0, uvRect.w }, color };
+    out[0] = bottomLeft;
+    out[1] = bottomRight;
+    out[2] = topRight;
+    out[3] = bottomLeft;
+    out[4] = topRight;
+    out[5] = topLeft;
+}
@@ -1,34 +1,158 @@
-#pragma once
+﻿#pragma once
 #include "../Renderer/Shader.h"
-#include "../Renderer/Camera.h"
+#include "../Renderer/CommandBuffer.h"
+#include "../Renderer/BitmapFont.h"
+#include <array>
+#include <cstdint>
 #include <glm.hpp>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
 
+// Megtartott (retained) HUD: a widgetek egyszer jönnek létre, a csúcsaik egy közös dinamikus
+// pufferben élnek (widgetenként rögzített tartomány, létrehozási sorrendben = rajzolási sorrend).
+// A Set* hívások csak akkor jelölik piszkosnak a widgetet, ha a látványa tényleg változik; az
+// Update csak a piszkosakat építi újra, és a piszkos tartományt egy glBufferSubData-val tölti
+// fel. Az egész HUD egyetlen rajzolás, csúcsonkénti színnel; a sima elemek az atlasz fehér
+// texelét mintázzák, így az ikonok ugyanabban a rajzolásban lehetnek.
+// A szöveg is widget: a glifjei a widget tartományába kerülnek (SetFont atlaszából), így
+// akárhány szöveg és glif is ugyanaz az egy rajzolás. Az elrendezés a widget csúcsaiban marad
+// meg: változatlan szövegre a SetText nem jelöl piszkosnak, csak a szöveg vagy a színe számít.
 class UIRenderer {
 public:
-    UIRenderer(Shader& shader);
-    ~UIRenderer();
+    using WidgetId = uint32_t;
 
-    void DrawHealthBar(int currentHealth, int maxHealth);
+    // Paralelogramma (a HUD ferde elemeihez; slant = 0: téglalap). position: az alsó él bal
+    // vége képernyő-pixelben (bal-alsó origó), slant: a felső él vízszintes eltolása az alsóhoz képest
+    struct Shape
+    {
+        glm::vec2 position{ 0.0f };
+        glm::vec2 size{ 0.0f };
+        float slant = 0.0f;
+    };
+
+    enum class FillDirection : uint8_t { LeftToRight, RightToLeft };
+
+    // Egyszínű szakasz a SetText-hez (glifenkénti szín: több szakasz egymás után)
+    struct TextSpan
+    {
+        std::string_view text;      // UTF-8
+        glm::vec4 color{ 1.0f };
+    };
+
+    struct Stats
+    {
+        size_t widgets = 0;
+        size_t vertices = 0;
+        size_t rebuiltWidgets = 0;      // az utolsó Update-ben
+        size_t uploadBytes = 0;         // az utolsó Update-ben
+        size_t textLayouts = 0;         // az utolsó Update-ben újra elrendezett szövegek
+        size_t glyphs = 0;              // a kirajzolt glifek összesen
+    };
+
+    explicit UIRenderer(Shader& shader);
+
+    // a színek egyenes alfával (a shader premultiplikál)
+    WidgetId AddPanel(const Shape& shape, const glm::vec4& color);
+    WidgetId AddBar(const Shape& shape, const glm::vec4& backgroundColor, const glm::vec4& fillColor,
+        FillDirection direction = FillDirection::LeftToRight);
+    // uvRect: (u0, v0, u1, v1) az atlaszon (SetAtlas)
+    WidgetId AddIcon(const Shape& shape, const glm::vec4& uvRect, const glm::vec4& tint = glm::vec4(1.0f));
+    // position: az első sor alapvonalának bal vége; legfeljebb maxGlyphs látható glif (a többi
+    // elmarad), scale: egész pixelszorzó
+    WidgetId AddText(const glm::vec2& position, uint32_t maxGlyphs, float scale = 1.0f,
+        const glm::vec4& color = glm::vec4(1.0f));
+
+    // 0..1; csak akkor piszkos, ha a kitöltés szélessége legalább fél pixelt változik
+    void SetBarValue(WidgetId id, float value);
+    void SetColor(WidgetId id, const glm::vec4& color);
+    void SetShape(WidgetId id, const Shape& shape);
+    void SetVisible(WidgetId id, bool visible);
+    // A widget színével (a SetColor később is átszínezi); '\n' új sort kezd
+    void SetText(WidgetId id, std::string_view utf8);
+    // szakaszonkénti színnel, legfeljebb kMaxTextSpans nem üres szakasz (a többi elmarad)
+    void SetText(WidgetId id, std::initializer_list<TextSpan> spans);
+
+    // Az ikonok atlasza (a nevet nem veszi át); whiteUv egy teljesen fehér, átlátszatlan
+    // texel közepe rajta. Alapból egy saját 1x1-es fehér textúra.
+    void SetAtlas(unsigned int texture, const glm::vec2& whiteUv);
+    // A szövegek fontja, egyben az atlasz is (a fontnak a UIRenderer után kell megszűnnie)
+    void SetFont(const BitmapFont& font);
+    void SetScreenSize(float width, float height);
+
+    // GL szál, a Record előtt: a piszkos widgetek újraépítése és feltöltése
+    void Update();
+    // GL-mentes: az egész HUD egy parancs az UI pass-ban
+    void Record(CommandBuffer& commands, uint32_t order = 0);
+
+    const Stats& GetStats() const { return stats; }
+
+    static constexpr size_t kMaxTextSpans = 8;
 
 private:
-    // VAO = Vertex Array Object
-	// VBO = Vertex Buffer Object
-    unsigned int vaoHealthBarBorder, vboHealthBarBorder;
-    unsigned int vaoHealthBarBackground, vboHealthBarBackground;
-    unsigned int vaoHealthBarFill, vboHealthBarFill;
-	const float defaultOffset = 15.0f;
-	const float innerBarWidth = 300.0f;
-    const float innerBarHeight = 25.0f;
-	const float uiLayerDepth = -0.5f;
+    enum class WidgetType : uint8_t { Panel, Bar, Icon, Text };
+
+    struct Vertex
+    {
+        glm::vec2 position;
+        glm::vec2 uv;
+        uint32_t color;     // RGBA8 (a memóriában R először)
+    };
+
+    // a szöveg [előző vége, end) bájttartományának színe
+    struct SpanColor
+    {
+        uint32_t end = 0;
+        uint32_t color = 0;
+        bool inheritColor = false;      // a widget színe
+    };
+
+    struct Widget
+    {
+        WidgetType type;
+        FillDirection direction = FillDirection::LeftToRight;
+        bool visible = true;
+        bool dirty = true;
+        Shape shape;
+        uint32_t color = 0;             // panel / ikon: a szín; sáv: a kitöltés
+        uint32_t backgroundColor = 0;   // sáv
+        glm::vec4 uvRect{ 0.0f };       // ikon
+        float value = 1.0f;             // sáv
+        float scale = 1.0f;             // szöveg
+        uint32_t glyphCount = 0;        // szöveg: a legutóbbi elrendezés glifjei
+        uint32_t spanCount = 0;         // szöveg
+        std::array<SpanColor, kMaxTextSpans> spans;
+        std::string text;               // szöveg: az elrendezett tartalom (a cache kulcsa)
+        uint32_t firstVertex = 0;
+        uint32_t vertexCount = 0;       // a lefoglalt tartomány
+    };
+
     Shader& shader;
+    GLVertexArray vao;
+    GLBuffer vbo;
+    GLTexture whiteTexture;
+    unsigned int atlasTexture = 0;
+    const BitmapFont* font = nullptr;
+    glm::vec2 whiteUv{ 0.5f };
+    int projectionLocation = -1;
+
+    glm::vec2 screenSize;
+    bool projectionDirty = true;
+
+    std::vector<Widget> widgets;
+    std::vector<Vertex> vertices;
+    size_t bufferCapacity = 0;          // csúcsokban, a GL pufferé
+    uint32_t uploadedVertices = 0;      // ennyit rajzol a Record
+    uint32_t dirtyFirst = UINT32_MAX;   // a piszkos csúcstartomány [dirtyFirst, dirtyLast)
+    uint32_t dirtyLast = 0;
+    Stats stats;
 
-    void InitRenderData();
-    void InitHealthBarBorderVAO();
-    void InitHealthBarBackgroundVAO();
-    void InitHealthBarForegroundVAO();
-    void SetupUIRendering(float screenWidth, float screenHeight);
-    void DrawHealthBarBorder(const glm::vec2& position);
-    void DrawHealthBarBackground(const glm::vec2& position);
-    void DrawHealthBarForeground(const glm::vec2& position, float ratio);
-    void RestoreDefaultShaderState();
-};
\ No newline at end of file
+    WidgetId AddWidget(const Widget& widget, uint32_t vertexCount);
+    void MarkDirty(WidgetId id);
+    void SetTextSpans(WidgetId id, const TextSpan* spans, size_t count, bool inheritColor);
+    bool IsSameText(const Widget& widget, const TextSpan* spans, size_t count, bool inheritColor) const;
+    void BuildWidget(Widget& widget);
+    uint32_t BuildText(const Widget& widget, Vertex* out) const;
+    void WriteQuad(Vertex* out, const Shape& shape, float u0, float u1, const glm::vec4& uvRect, uint32_t color) const;
+};
@@ -0,0 +1,134 @@
+﻿#include "VirtualFileSystem.h"
+#include "Lz4.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace
+{
+    std::string FindExecutableDirectory()
+    {
+        std::error_code error;
+#ifdef _WIN32
+        char buffer[MAX_PATH];
+        const DWORD length = GetModuleFileNameA(nullptr, buffer, MAX_PATH);
+        if (length == 0 || length == MAX_PATH)
+            return std::string();
+        return std::filesystem::path(std::string(buffer, length)).parent_path().string();
+#else
+        const std::filesystem::path executable = std::filesystem::read_symlink("/proc/self/exe", error);
+        return error ? std::string() : executable.parent_path().string();
+#endif
+    }
+}
+
+VirtualFileSystem& VirtualFileSystem::Get()
+{
+    static VirtualFileSystem instance;
+    return instance;
+}
+
+VirtualFileSystem::VirtualFileSystem()
+    : executableDirectory(FindExecutableDirectory())
+{
+}
+
+std::string VirtualFileSystem::ResolveLoose(const std::string& path) const
+{
+    std::error_code error;
+    if (std::filesystem::is_regular_file(path, error))
+        return path;
+
+    if (!executableDirectory.empty() && std::filesystem::path(path).is_relative()) {
+        const std::string candidate = (std::filesystem::path(executableDirectory) / path).string();
+        if (std::filesystem::is_regular_file(candidate, error))
+            return candidate;
+    }
+    return std::string();
+}
+
+bool VirtualFileSystem::MountArchive(const std::string& archivePath)
+{
+    const std::string resolved = ResolveLoose(archivePath);
+    if (resolved.empty() || !archive.Open(resolved)) {
+        std::cout << "Asset archive not found (" << archivePath << "), using loose files" << std::endl;
+        return false;
+    }
+
+    std::cout << "Mounted asset archive " << resolved << " (" << archive.GetEntryCount() << " entries)" << std::endl;
+    return true;
+}
+
+bool VirtualFileSystem::Read(const std::string& path, AssetData& out, size_t maxBytes) const
+{
+    out = AssetData();
+
+    if (const AssetArchive::Entry* entry = archive.Find(path)) {
+        if (!(entry->flags & AssetArchive::kFlagLz4)) {
+            out.data = archive.StoredData(*entry);
+            out.size = static_cast<size_t>(entry->rawSize);
+            return true;
+        }
+
+        out.owned.resize(static_cast<size_t>(entry->rawSize));
+        if (!Lz4::Decompress(archive.StoredData(*entry), static_cast<size_t>(entry->storedSize),
+            out.owned.data(), out.owned.size())) {
+            std::cerr << "Corrupt compressed asset: " << path << std::endl;
+            out = AssetData();
+            return false;
+        }
+        out.data = out.owned.data();
+        out.size = out.owned.size();
+        return true;
+    }
+
+    const std::string resolved = ResolveLoose(path);
+    std::ifstream file(resolved, std::ios::binary | std::ios::ate);
+    if (resolved.empty() || !file) {
+        std::cerr << "Failed to open asset: " << path << std::endl;
+        return false;
+    }
+
+    const size_t size = std::min(static_cast<size_t>(file.tellg()), maxBytes);
+    file.seekg(0);
+    // üres fájlnál is legyen érvényes (nem null) mutató
+    out.owned.resize(size > 0 ? size : 1);
+    if (!file.read(reinterpret_cast<char*>(out.owned.data()), static_cast<std::streamsize>(size))) {
+        std::cerr << "Failed to read asset: " << path << std::endl;
+        out = AssetData();
+        return false;
+    }
+    out.data = out.owned.data();
+    out.size = size;
+    return true;
+}
+
+bool VirtualFileSystem::Stat(const std::string& path, AssetStat& out) const
+{
+    out = AssetStat();
+
+    if (const AssetArchive::Entry* entry = archive.Find(path)) {
+        out.size = entry->rawSize;
+        out.stamp = entry->contentHash;
+        out.packed = true;
+        return true;
+    }
+
+    const std::string resolved = ResolveLoose(path);
+    if (resolved.empty())
+        return false;
+
+    std::error_code error;
+    out.size = std::filesystem::file_size(resolved, error);
+    if (error)
+        return false;
+    out.stamp = static_cast<uint64_t>(std::filesystem::last_write_time(resolved, error).time_since_epoch().count());
+    return true;
+}
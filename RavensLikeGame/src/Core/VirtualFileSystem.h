@@ -0,0 +1,84 @@
+﻿#pragma once
+#include "AssetArchive.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Egy asset tartalma. Tömörítetlen archív-bejegyzésnél nézet a leképezett archívumba
+// (másolás nélkül, az archívum élettartamáig érvényes); laza fájlnál vagy LZ4-es
+// bejegyzésnél saját puffer. Csak mozgatható: saját puffernél a data a saját owned-jába
+// mutat, egy másolat a forrás pufferére hivatkozna.
+class AssetData
+{
+public:
+    AssetData() = default;
+    AssetData(const AssetData&) = delete;
+    AssetData& operator=(const AssetData&) = delete;
+
+    // a vektor mozgatása a puffert is átadja, így a data érvényes marad; a forrás üres lesz
+    AssetData(AssetData&& other) noexcept
+        : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)), owned(std::move(other.owned))
+    {
+    }
+
+    AssetData& operator=(AssetData&& other) noexcept
+    {
+        if (this != &other) {
+            data = std::exchange(other.data, nullptr);
+            size = std::exchange(other.size, 0);
+            owned = std::move(other.owned);
+        }
+        return *this;
+    }
+
+    const uint8_t* Data() const { return data; }
+    size_t Size() const { return size; }
+    std::string_view Text() const { return std::string_view(reinterpret_cast<const char*>(data), size); }
+    bool IsMapped() const { return data && owned.empty(); }
+    explicit operator bool() const { return data != nullptr; }
+
+private:
+    friend class VirtualFileSystem;
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    std::vector<uint8_t> owned;
+};
+
+struct AssetStat
+{
+    uint64_t size = 0;
+    uint64_t stamp = 0;     // archívumban a tartalom hash-e, lazán a módosítási idő
+    bool packed = false;
+};
+
+// Minden betöltő ezen át olvas: először a csatolt archívumból (assets.pak), ha abban nincs,
+// laza fájlból (fejlesztéshez). A relatív útvonalak a munkakönyvtárból, majd a futtatható
+// mellől oldódnak fel, így az indítás nem függ attól, honnan indították a játékot.
+// Csatolás csak indításkor, betöltések előtt; utána több szálról is olvasható.
+class VirtualFileSystem
+{
+public:
+    static constexpr const char* kDefaultArchive = "assets.pak";
+
+    static VirtualFileSystem& Get();
+
+    // false, ha nincs (érvényes) archívum: ilyenkor minden laza fájlból jön
+    bool MountArchive(const std::string& archivePath = kDefaultArchive);
+    bool HasArchive() const { return archive.IsOpen(); }
+
+    // maxBytes: laza fájlból legfeljebb ennyit olvas (pl. csak a képfejléchez)
+    bool Read(const std::string& path, AssetData& out, size_t maxBytes = SIZE_MAX) const;
+    bool Stat(const std::string& path, AssetStat& out) const;
+
+    // a laza fájl tényleges helye (munkakönyvtár vagy a futtatható mappája); üres, ha nincs
+    std::string ResolveLoose(const std::string& path) const;
+
+private:
+    VirtualFileSystem();
+
+    AssetArchive archive;
+    std::string executableDirectory;
+};
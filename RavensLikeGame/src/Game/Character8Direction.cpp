@@ -1,12 +1,13 @@
 ﻿#include "Character8Direction.h"
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
-Character8Direction::Character8Direction(Texture& s, SpriteRenderer& r)
-    : sheet(s), renderer(r)
+Character8Direction::Character8Direction(TextureRef s, SpriteRenderer& r)
+    : sheet(std::move(s)), renderer(r)
 {
-    spriteSheetWidthPx = static_cast<float>(sheet.Width);
-    spriteSheetHeightPx = static_cast<float>(sheet.Height);
+    spriteSheetWidthPx = static_cast<float>(sheet->Width);
+    spriteSheetHeightPx = static_cast<float>(sheet->Height);
     BuildFramesFromGivenCoords();
 }
 
@@ -101,11 +102,13 @@ void Character8Direction::Update(const glm::vec2& move, float deltaTime)
     }
 }
 
-void Character8Direction::DrawPlayer(const glm::vec2& centerPosition, const glm::vec2& pictureSize)
+void Character8Direction::RecordPlayer(CommandBuffer& commands, RenderPass pass, uint32_t order,
+    const glm::vec2& centerPosition, const glm::vec2& pictureSize,
+    const glm::mat4& projection, const glm::mat4& view, float depth) const
 {
     const glm::vec4 uv = uvFrames[currentDirection][currentFrame];
     glm::vec2 drawPos = centerPosition - pictureSize * 0.5f;
-    renderer.DrawSpriteRegion(sheet, drawPos, pictureSize, uv);
+    renderer.RecordSpriteRegion(commands, pass, order, *sheet, drawPos, pictureSize, uv, projection, view, depth);
 }
 
 int Character8Direction::GetCurrentDirection() const
@@ -115,7 +118,12 @@ int Character8Direction::GetCurrentDirection() const
 
 glm::vec2 Character8Direction::GetCurrentDirectionVector() const
 {
-    switch (currentDirection)
+    return DirectionToVector(currentDirection);
+}
+
+glm::vec2 Character8Direction::DirectionToVector(int direction)
+{
+    switch (direction)
     {
         case N:  return glm::vec2(0.0f, 1.0f);
         case NE: return glm::normalize(glm::vec2(1.0f, 1.0f));
@@ -2,7 +2,7 @@
 #include <glm.hpp>
 #include <array>
 #include <vector>
-#include "../Renderer/Texture.h"
+#include "../Renderer/TextureCache.h"
 #include "../Renderer/SpriteRenderer.h"
 #include "../Core/Globals.h"
 
@@ -13,16 +13,26 @@ public:
 
     enum Directions { N = 0, NE = 1, E = 2, SE = 3, S = 4, SW = 5, W = 6, NW = 7 };
 
-    Character8Direction(Texture& sheet, SpriteRenderer& renderer);
+    Character8Direction(TextureRef sheet, SpriteRenderer& renderer);
 
     void Update(const glm::vec2& movementDir, float deltaTime);
-    void DrawPlayer(const glm::vec2& centerPosition, const glm::vec2& pictureSize);
+    // a játékos sprite-ja rajzolási parancsként (a sorrendet a CommandQueue dönti el)
+    void RecordPlayer(CommandBuffer& commands, RenderPass pass, uint32_t order,
+        const glm::vec2& centerPosition, const glm::vec2& pictureSize,
+        const glm::mat4& projection, const glm::mat4& view, float depth) const;
 
     int GetCurrentDirection() const;
+    int GetCurrentFrame() const { return currentFrame; }
+
+    // [irány][képkocka] UV-téglalapok (pl. a CrowdRenderer klip-táblájához)
+    const std::array<std::array<glm::vec4, kFramesPerDirection>, kDirections>& GetUvFrames() const { return uvFrames; }
     glm::vec2 GetCurrentDirectionVector() const;
 
+    static int DirectionFromMovement(const glm::vec2& v);
+    static glm::vec2 DirectionToVector(int direction);
+
 private:
-    Texture& sheet;
+    TextureRef sheet;
     SpriteRenderer& renderer;
 
     float spriteSheetWidthPx = 1.0f, spriteSheetHeightPx = 1.0f;
@@ -39,7 +49,6 @@ private:
     float frameDuration = 0.12f;  // 8–9 FPS körül
 
     static glm::vec2 NormalizeVector(const glm::vec2& v);
-    static int DirectionFromMovement(const glm::vec2& v);
 
     static glm::vec4 PixelRectToNormalizedUVRect(int x1, int y1, int x2, int y2, float sheetWidth, float sheetHeight);
 
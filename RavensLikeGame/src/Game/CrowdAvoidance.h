@@ -0,0 +1,86 @@
+﻿#pragma once
+#include <glm.hpp>
+#include <vector>
+#include "SpatialGrid.h"
+
+class ThreadPool;
+
+// ORCA (RVO2-szerű) helyi elkerülés sok mozgó karakterre. A kívánt sebességek
+// kiszámolása után fut; ha kifut a képkockánkénti időkeretből, a maradék
+// ágensekre egyszerű szétválasztó (separation) erőre vált. A keretet ágensenként
+// nézi, a szétválasztás várható idejét előre leszámítva.
+class CrowdAvoidance
+{
+public:
+    static constexpr int kMaxNeighbours = 10;
+
+    struct Settings
+    {
+        bool enabled = true;
+        float agentRadius = 10.0f;
+        float neighbourDistance = 60.0f;
+        float timeHorizon = 0.75f;
+        float maxSpeed = 200.0f;
+        double budgetMs = 2.0;
+    };
+
+    explicit CrowdAvoidance(ThreadPool* workers = nullptr);
+
+    void SetSettings(const Settings& s) { settings = s; }
+    const Settings& GetSettings() const { return settings; }
+
+    // outVelocities[i] = ütközésmentes sebesség az i. ágensnek
+    void Solve(const std::vector<glm::vec2>& positions,
+        const std::vector<glm::vec2>& velocities,
+        const std::vector<glm::vec2>& preferredVelocities,
+        std::vector<glm::vec2>& outVelocities,
+        float deltaTime);
+
+    double GetLastSolveMs() const { return lastSolveMs; }
+    int GetLastDegradedCount() const { return lastDegradedCount; }
+
+    // "--bench-crowd": agentCount ágens két szemközti csoportban egymáson át, frames lépésen;
+    // a Solve ideje időkeret nélkül és az alap kerettel, valamint az átfedő párok száma;
+    // false, ha a keretes futás átlaga érdemben a kereten túl van
+    static bool Benchmark(int agentCount, int frames, ThreadPool* workers);
+
+private:
+    struct Line
+    {
+        glm::vec2 point;
+        glm::vec2 direction;
+    };
+
+    struct NeighbourList
+    {
+        int count = 0;
+        int index[kMaxNeighbours];
+        float distanceSq[kMaxNeighbours];
+    };
+
+    Settings settings;
+    ThreadPool* workers;
+
+    SpatialGrid grid;
+
+    double lastSolveMs = 0.0;
+    int lastDegradedCount = 0;
+    double separationNsPerAgent = 300.0;    // a tartalék mért ágensenkénti falióra-ideje
+
+    void GatherNeighbours(int agent, const std::vector<glm::vec2>& positions, NeighbourList& out) const;
+
+    glm::vec2 SolveOrca(int agent, const NeighbourList& neighbours,
+        const std::vector<glm::vec2>& positions,
+        const std::vector<glm::vec2>& velocities,
+        const glm::vec2& preferred, float deltaTime) const;
+    glm::vec2 SolveSeparation(int agent,
+        const std::vector<glm::vec2>& positions,
+        const glm::vec2& preferred) const;
+
+    static bool LinearProgram1(const Line* lines, int lineNo, float radius,
+        const glm::vec2& optVelocity, bool directionOpt, glm::vec2& result);
+    static int LinearProgram2(const Line* lines, int lineCount, float radius,
+        const glm::vec2& optVelocity, bool directionOpt, glm::vec2& result);
+    static void LinearProgram3(const Line* lines, int lineCount, int beginLine,
+        float radius, glm::vec2& result);
+};
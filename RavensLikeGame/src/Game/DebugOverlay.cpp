@@ -0,0 +1,77 @@
+﻿#include "DebugOverlay.h"
+#include "../Core/Globals.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    constexpr float kRefreshSeconds = 0.25f;
+    constexpr float kTextScale = 2.0f;
+    constexpr float kMargin = 8.0f;
+    constexpr uint32_t kMaxGlyphs = 256;
+
+    const glm::vec4 kLabelColor(0.75f, 0.75f, 0.75f, 1.0f);
+    const glm::vec4 kOnBudget(0.3f, 1.0f, 0.3f, 1.0f);
+    const glm::vec4 kOverBudget(1.0f, 0.85f, 0.2f, 1.0f);      // 60 FPS alatt
+    const glm::vec4 kFarOverBudget(1.0f, 0.3f, 0.2f, 1.0f);    // 30 FPS alatt
+
+    const glm::vec4& BudgetColor(float milliseconds)
+    {
+        if (milliseconds <= 1000.0f / 60.0f)
+            return kOnBudget;
+        return milliseconds <= 1000.0f / 30.0f ? kOverBudget : kFarOverBudget;
+    }
+}
+
+DebugOverlay::DebugOverlay(UIRenderer& ui)
+    : ui(ui)
+{
+    // az első sor teteje a margónál (a glif 7 sora az alapvonal fölött)
+    const glm::vec2 position(kMargin, (float)Globals::WindowHeight - kMargin - 7.0f * kTextScale);
+    text = ui.AddText(position, kMaxGlyphs, kTextScale, kLabelColor);
+    ui.SetVisible(text, visible);
+}
+
+void DebugOverlay::SetVisible(bool show)
+{
+    visible = show;
+    ui.SetVisible(text, visible);
+}
+
+void DebugOverlay::Update(float deltaTime, const CommandQueue::Stats& worldStats, const IsoRenderer& isoRenderer)
+{
+    if (!visible) {
+        windowSeconds = 0.0f;
+        maxFrameSeconds = 0.0f;
+        windowFrames = 0;
+        return;
+    }
+    windowSeconds += deltaTime;
+    maxFrameSeconds = std::max(maxFrameSeconds, deltaTime);
+    ++windowFrames;
+    if (windowSeconds < kRefreshSeconds)
+        return;
+
+    const float averageMs = windowSeconds * 1000.0f / windowFrames;
+    const float maxMs = maxFrameSeconds * 1000.0f;
+    const UIRenderer::Stats& uiStats = ui.GetStats();
+    const IsoRenderer::MeshStats& mesh = isoRenderer.GetMeshStats();
+
+    // fix pufferek: a frissítés se foglaljon heapet
+    char average[32], peak[32], details[256];
+    std::snprintf(average, sizeof(average), "%.2f ms", averageMs);
+    std::snprintf(peak, sizeof(peak), "%.2f ms", maxMs);
+    std::snprintf(details, sizeof(details), " (%.0f fps)\ndraws %zu  programs %zu  textures %zu\n"
+        "tiles %zu  mesh %.0f px/tile (quad %.0f, blended %.0f)  samples %llu\nhud %zu widgets  %zu glyphs",
+        1000.0f / averageMs, worldStats.commands, worldStats.programBinds, worldStats.textureBinds,
+        isoRenderer.GetLastDrawnTileCount(), mesh.pixelsPerTile, mesh.quadPixelsPerTile, mesh.blendedPixelsPerTile,
+        (unsigned long long)isoRenderer.GetLastSamplesPassed(), uiStats.widgets, uiStats.glyphs);
+    ui.SetText(text, {
+        { "frame ", kLabelColor }, { average, BudgetColor(averageMs) },
+        { "  max ", kLabelColor }, { peak, BudgetColor(maxMs) },
+        { details, kLabelColor } });
+
+    windowSeconds = 0.0f;
+    maxFrameSeconds = 0.0f;
+    windowFrames = 0;
+}
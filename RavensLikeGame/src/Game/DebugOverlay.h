@@ -0,0 +1,27 @@
+﻿#pragma once
+#include "../Core/UIRenderer.h"
+#include "../Renderer/IsoRenderer.h"
+
+// Debug-overlay a bal felső sarokban: képidő (átlag és csúcs) a keretre színezve, FPS, a
+// világ rajzolási statisztikája, a csempe-háló fragmentszáma és a HUD mérete. Negyed másodpercenként frissül, így a szöveg
+// is legfeljebb ennyiszer rendeződik újra; rejtve a widget nulla területű (a rajzolás ugyanaz).
+class DebugOverlay
+{
+public:
+    explicit DebugOverlay(UIRenderer& ui);
+
+    void SetVisible(bool visible);
+    bool IsVisible() const { return visible; }
+
+    // képkockánként, a világ Submit-ja után
+    void Update(float deltaTime, const CommandQueue::Stats& worldStats, const IsoRenderer& isoRenderer);
+
+private:
+    UIRenderer& ui;
+    UIRenderer::WidgetId text;
+    bool visible = false;
+
+    float windowSeconds = 0.0f;     // az aktuális mérési ablak
+    float maxFrameSeconds = 0.0f;
+    int windowFrames = 0;
+};
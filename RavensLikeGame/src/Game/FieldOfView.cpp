@@ -0,0 +1,102 @@
+﻿#include "FieldOfView.h"
+#include "../Core/AllocationTracker.h"
+
+namespace
+{
+    // Oktánsonkénti transzformáció (xx, xy, yx, yy)
+    constexpr int kOctants[8][4] = {
+        { 1,  0,  0,  1 }, { 0,  1,  1,  0 }, { 0, -1,  1,  0 }, { -1,  0,  0,  1 },
+        { -1, 0,  0, -1 }, { 0, -1, -1,  0 }, { 0,  1, -1,  0 }, { 1,  0,  0, -1 }
+    };
+}
+
+FieldOfView::FieldOfView(const TileMap& map, int radius)
+    : map(map), radius(radius)
+{
+}
+
+bool FieldOfView::Update(const glm::ivec2& originTile)
+{
+    ALLOCATION_SCOPE("FieldOfView::Update");
+    const bool sizeChanged = (width != map.GetWidth() || height != map.GetHeight());
+    if (!sizeChanged && originTile == lastOrigin && blockerRevision == map.GetBlockerRevision())
+        return false;
+
+    if (sizeChanged) {
+        width = map.GetWidth();
+        height = map.GetHeight();
+        visibility.assign(static_cast<size_t>(width) * height, Hidden);
+    }
+
+    lastOrigin = originTile;
+    blockerRevision = map.GetBlockerRevision();
+
+    // ami eddig látszott, az innentől csak emlék
+    for (uint8_t& v : visibility)
+        if (v == Visible)
+            v = Remembered;
+
+    if (originTile.x < 0 || originTile.y < 0 || originTile.x >= width || originTile.y >= height)
+        return true;
+
+    visibility[originTile.y * width + originTile.x] = Visible;
+    for (const auto& o : kOctants)
+        CastLight(originTile, 1, 1.0f, 0.0f, o[0], o[1], o[2], o[3]);
+    return true;
+}
+
+uint8_t FieldOfView::Get(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= width || y >= height)
+        return Hidden;
+    return visibility[y * width + x];
+}
+
+void FieldOfView::CastLight(const glm::ivec2& origin, int row, float startSlope, float endSlope,
+    int xx, int xy, int yx, int yy)
+{
+    if (startSlope < endSlope)
+        return;
+
+    const int radiusSq = radius * radius;
+    float nextStartSlope = startSlope;
+
+    for (int distance = row; distance <= radius; ++distance) {
+        bool blocked = false;
+
+        for (int dx = -distance, dy = -distance; dx <= 0; ++dx) {
+            const int x = origin.x + dx * xx + dy * xy;
+            const int y = origin.y + dx * yx + dy * yy;
+            const float leftSlope = (dx - 0.5f) / (dy + 0.5f);
+            const float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+
+            if (startSlope < rightSlope)
+                continue;
+            if (endSlope > leftSlope)
+                break;
+
+            const bool inside = (x >= 0 && y >= 0 && x < width && y < height);
+            if (inside && dx * dx + dy * dy < radiusSq)
+                visibility[y * width + x] = Visible;
+
+            const bool blocking = map.BlocksSight(x, y);
+            if (blocked) {
+                if (blocking) {
+                    nextStartSlope = rightSlope;
+                    continue;
+                }
+                blocked = false;
+                startSlope = nextStartSlope;
+            }
+            else if (blocking && distance < radius) {
+                // a fal mögötti rész külön sugárral folytatódik
+                blocked = true;
+                CastLight(origin, distance + 1, startSlope, leftSlope, xx, xy, yx, yy);
+                nextStartSlope = rightSlope;
+            }
+        }
+
+        if (blocked)
+            break;
+    }
+}
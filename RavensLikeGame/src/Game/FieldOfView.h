@@ -0,0 +1,35 @@
+﻿#pragma once
+#include <cstdint>
+#include <glm.hpp>
+#include <vector>
+#include "TileMap.h"
+
+// Rekurzív shadowcasting a játékos csempéjéből; falak (1..6) takarnak.
+// Csempénként egy bájt: még nem látott / emlékezett / most látható.
+class FieldOfView
+{
+public:
+    enum Visibility : uint8_t { Hidden = 0, Remembered = 1, Visible = 2 };
+
+    FieldOfView(const TileMap& map, int radius = 12);
+
+    // Csak csempeváltáskor vagy takaró csempe változásakor számol újra; true, ha számolt
+    bool Update(const glm::ivec2& originTile);
+
+    uint8_t Get(int x, int y) const;
+    const std::vector<uint8_t>& GetVisibility() const { return visibility; }
+
+    void SetRadius(int r) { radius = r; lastOrigin = glm::ivec2(-1); }
+
+private:
+    const TileMap& map;
+    int radius;
+
+    int width = 0, height = 0;
+    glm::ivec2 lastOrigin{ -1, -1 };
+    unsigned int blockerRevision = 0;
+    std::vector<uint8_t> visibility;
+
+    void CastLight(const glm::ivec2& origin, int row, float startSlope, float endSlope,
+        int xx, int xy, int yx, int yy);
+};
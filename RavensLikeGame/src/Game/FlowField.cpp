@@ -0,0 +1,188 @@
+﻿#include "FlowField.h"
+#include "../Core/AllocationTracker.h"
+#include "../Core/FrameArena.h"
+#include "Character8Direction.h"
+#include "../Core/ThreadPool.h"
+#include <algorithm>
+#include <array>
+
+namespace
+{
+    constexpr uint32_t kStraightCost = 10;
+    constexpr uint32_t kDiagonalCost = 14;
+    constexpr int kBucketCount = kDiagonalCost + 1;
+
+    constexpr int kNeighbourDx[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    constexpr int kNeighbourDy[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+    // Rács-lépés (dx = oszlop, dy = sor) -> karakter irány. Az izometrikus vetítésben
+    // egy (dx, dy) lépés világ-eltolása ((dx - dy) * halfW, (dx + dy) * halfH),
+    // ennek az előjelei adják a 8 irányt, pont úgy, mint a mozgás inputnál.
+    const std::array<int, 9>& StepDirectionTable()
+    {
+        static const std::array<int, 9> table = [] {
+            std::array<int, 9> t{};
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int dx = -1; dx <= 1; ++dx)
+                    t[(dy + 1) * 3 + (dx + 1)] = Character8Direction::DirectionFromMovement(
+                        glm::vec2(static_cast<float>(dx - dy), static_cast<float>(dx + dy)));
+            return t;
+        }();
+        return table;
+    }
+}
+
+FlowField::FlowField(const TileMap& map, ThreadPool* workers)
+    : map(map), workers(workers)
+{
+}
+
+bool FlowField::Update(const glm::ivec2& targetTile)
+{
+    ALLOCATION_SCOPE("FlowField::Update");
+    const bool sizeChanged = (width != map.GetWidth() || height != map.GetHeight());
+    if (!sizeChanged && targetTile == target && mapRevision == map.GetRevision())
+        return false;
+
+    if (sizeChanged)
+        Resize();
+
+    target = targetTile;
+    mapRevision = map.GetRevision();
+
+    BuildIntegrationField();
+
+    const int chunksX = (width + kChunkSize - 1) / kChunkSize;
+    const int chunksY = (height + kChunkSize - 1) / kChunkSize;
+    const int chunkCount = chunksX * chunksY;
+
+    if (workers) {
+        workers->ParallelFor(chunkCount, 1, [this](int begin, int end) {
+            for (int i = begin; i < end; ++i)
+                BuildDirectionChunk(i);
+        });
+    }
+    else {
+        for (int i = 0; i < chunkCount; ++i)
+            BuildDirectionChunk(i);
+    }
+    return true;
+}
+
+int FlowField::GetDirection(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= width || y >= height)
+        return -1;
+    return directions[y * width + x];
+}
+
+glm::vec2 FlowField::GetDirectionVector(int x, int y) const
+{
+    return Character8Direction::DirectionToVector(GetDirection(x, y));
+}
+
+uint32_t FlowField::GetCost(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= width || y >= height)
+        return kUnreachable;
+    return integration[y * width + x];
+}
+
+void FlowField::Resize()
+{
+    width = map.GetWidth();
+    height = map.GetHeight();
+    integration.assign(static_cast<size_t>(width) * height, kUnreachable);
+    directions.assign(static_cast<size_t>(width) * height, -1);
+}
+
+bool FlowField::CanStep(int x, int y, int dx, int dy) const
+{
+    if (!map.IsTileWalkable(x + dx, y + dy))
+        return false;
+
+    // átlón ne lehessen falsarkot levágni
+    if (dx != 0 && dy != 0)
+        return map.IsTileWalkable(x + dx, y) && map.IsTileWalkable(x, y + dy);
+    return true;
+}
+
+void FlowField::BuildIntegrationField()
+{
+    std::fill(integration.begin(), integration.end(), kUnreachable);
+    if (!map.IsTileWalkable(target.x, target.y))
+        return;
+
+    // Dial-féle vödörsor: az élköltség legfeljebb 14, így 15 körkörös vödör elég. A vödrök
+    // csak a számolás idejére kellenek: a képkocka-arénából jönnek (a belső vektorok is, a
+    // polymorphic_allocator továbbadja az erőforrást), így az újraszámolás nem foglal heapet.
+    std::pmr::vector<std::pmr::vector<int>> buckets(kBucketCount, FrameArena::Get().Resource());
+    integration[target.y * width + target.x] = 0;
+    buckets[0].push_back(target.y * width + target.x);
+
+    int pending = 1;
+    for (uint32_t cost = 0; pending > 0; ++cost) {
+        std::pmr::vector<int>& bucket = buckets[cost % kBucketCount];
+        // a bucket bejárás közben nem nőhet: ugyanebbe a vödörbe csak cost + 15 kerülhetne
+        for (size_t i = 0; i < bucket.size(); ++i) {
+            const int index = bucket[i];
+            --pending;
+            if (integration[index] != cost)
+                continue; // elavult bejegyzés
+
+            const int x = index % width;
+            const int y = index / width;
+            for (int n = 0; n < 8; ++n) {
+                const int dx = kNeighbourDx[n];
+                const int dy = kNeighbourDy[n];
+                if (!CanStep(x, y, dx, dy))
+                    continue;
+
+                const uint32_t newCost = cost + ((dx != 0 && dy != 0) ? kDiagonalCost : kStraightCost);
+                const int neighbour = (y + dy) * width + (x + dx);
+                if (newCost >= integration[neighbour])
+                    continue;
+
+                integration[neighbour] = newCost;
+                buckets[newCost % kBucketCount].push_back(neighbour);
+                ++pending;
+            }
+        }
+        bucket.clear();
+    }
+}
+
+void FlowField::BuildDirectionChunk(int chunkIndex)
+{
+    const int chunksX = (width + kChunkSize - 1) / kChunkSize;
+    const int x0 = (chunkIndex % chunksX) * kChunkSize;
+    const int y0 = (chunkIndex / chunksX) * kChunkSize;
+    const int x1 = std::min(width, x0 + kChunkSize);
+    const int y1 = std::min(height, y0 + kChunkSize);
+
+    const std::array<int, 9>& stepDirection = StepDirectionTable();
+
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            const int index = y * width + x;
+            uint32_t best = integration[index];
+            int bestDirection = -1;
+
+            if (best != kUnreachable && best != 0) {
+                for (int n = 0; n < 8; ++n) {
+                    const int dx = kNeighbourDx[n];
+                    const int dy = kNeighbourDy[n];
+                    if (!CanStep(x, y, dx, dy))
+                        continue;
+
+                    const uint32_t cost = integration[(y + dy) * width + (x + dx)];
+                    if (cost < best) {
+                        best = cost;
+                        bestDirection = stepDirection[(dy + 1) * 3 + (dx + 1)];
+                    }
+                }
+            }
+            directions[index] = static_cast<int8_t>(bestDirection);
+        }
+    }
+}
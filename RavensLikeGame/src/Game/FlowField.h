@@ -0,0 +1,45 @@
+﻿#pragma once
+#include <cstdint>
+#include <glm.hpp>
+#include <vector>
+#include "TileMap.h"
+
+class ThreadPool;
+
+// Integrációs mező (Dijkstra a játékos csempéjéből) + 8 irányú mező, ami
+// közvetlenül a Character8Direction::Directions értékeire képez
+class FlowField
+{
+public:
+    static constexpr int kChunkSize = 16;
+    // uint32_t költség: 16 biten egy ~6500 lépésnél hosszabb út már elérhetetlennek látszana
+    static constexpr uint32_t kUnreachable = 0xFFFFFFFFu;
+
+    FlowField(const TileMap& map, ThreadPool* workers = nullptr);
+
+    // Csak akkor számol újra, ha a cél csempe vagy a térkép változott; true, ha számolt
+    bool Update(const glm::ivec2& targetTile);
+
+    // -1, ha a csempe nem járható / nem érhető el / maga a cél
+    int GetDirection(int x, int y) const;
+    glm::vec2 GetDirectionVector(int x, int y) const;
+    uint32_t GetCost(int x, int y) const;
+
+    const glm::ivec2& GetTarget() const { return target; }
+
+private:
+    const TileMap& map;
+    ThreadPool* workers;
+
+    int width = 0, height = 0;
+    glm::ivec2 target{ -1, -1 };
+    unsigned int mapRevision = 0;
+
+    std::vector<uint32_t> integration;
+    std::vector<int8_t> directions;
+
+    void Resize();
+    void BuildIntegrationField();
+    void BuildDirectionChunk(int chunkIndex);
+    bool CanStep(int x, int y, int dx, int dy) const;
+};
@@ -0,0 +1,185 @@
+﻿#include "ParticleSystem.h"
+#include "../Core/AllocationTracker.h"
+#include "../Core/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RAVENS_PARTICLES_SSE 1
+#endif
+
+ParticleEmitter::ParticleEmitter(const ParticleEmitterSettings& settings)
+    : settings(settings)
+{
+    // seed nélkül a létrehozási sorszámból: két azonos beállítású kibocsátó se fusson együtt
+    static uint32_t instanceCount = 0;
+    rng = settings.seed != 0 ? settings.seed : 0x9E3779B9u * ++instanceCount;
+    if (rng == 0)
+        rng = 0x9E3779B9u;  // a xorshift a 0 állapotból nem mozdul
+
+    // 4-gyel osztható kapacitás: a SIMD ciklusnak nincs maradék ága
+    capacity = (std::max(settings.capacity, 4) + 3) & ~3;
+
+    posX.resize(capacity);
+    posY.resize(capacity);
+    velX.resize(capacity);
+    velY.resize(capacity);
+    age.assign(capacity, 0.0f);
+    lifetime.assign(capacity, 0.0f); // age >= lifetime: halott slot
+}
+
+float ParticleEmitter::NextRandom()
+{
+    // xorshift32, kibocsátónként saját állapot (párhuzamos szimulációhoz)
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return static_cast<float>(rng >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleEmitter::Emit(int count, const glm::vec2& position, const glm::vec2& direction)
+{
+    const bool directed = direction.x != 0.0f || direction.y != 0.0f;
+    const float baseAngle = directed ? std::atan2(direction.y, direction.x) : 0.0f;
+    const float spread = directed ? settings.spreadRadians : 6.2831853f;
+
+    for (int n = 0; n < count; ++n) {
+        // a gyűrűpufferben mindig a legrégebbi slot íródik felül
+        const int i = head;
+        head = (head + 1) % capacity;
+        used = std::min(used + 1, capacity);
+
+        const float angle = baseAngle + (NextRandom() - 0.5f) * spread;
+        const float speed = settings.minSpeed + (settings.maxSpeed - settings.minSpeed) * NextRandom();
+
+        posX[i] = position.x;
+        posY[i] = position.y;
+        velX[i] = std::cos(angle) * speed;
+        velY[i] = std::sin(angle) * speed;
+        age[i] = 0.0f;
+        lifetime[i] = settings.minLifetime + (settings.maxLifetime - settings.minLifetime) * NextRandom();
+    }
+}
+
+void ParticleEmitter::EmitOverTime(float rate, float deltaTime, const glm::vec2& position, const glm::vec2& direction)
+{
+    emitAccumulator += rate * deltaTime;
+    const int count = static_cast<int>(emitAccumulator);
+    emitAccumulator -= static_cast<float>(count);
+    Emit(count, position, direction);
+}
+
+void ParticleEmitter::Simulate(float deltaTime)
+{
+    // folyamatos kibocsátás a spawn-terület egy véletlen pontjából
+    if (settings.spawnRate > 0.0f) {
+        spawnAccumulator += settings.spawnRate * deltaTime;
+        const int spawnCount = static_cast<int>(spawnAccumulator);
+        spawnAccumulator -= static_cast<float>(spawnCount);
+        for (int n = 0; n < spawnCount; ++n) {
+            const glm::vec2 offset(
+                (NextRandom() * 2.0f - 1.0f) * settings.spawnAreaHalfExtent.x,
+                (NextRandom() * 2.0f - 1.0f) * settings.spawnAreaHalfExtent.y);
+            Emit(1, spawnCenter + offset);
+        }
+    }
+
+    if (used == 0)
+        return;
+
+    const float damping = std::max(0.0f, 1.0f - settings.drag * deltaTime);
+    const float accelX = settings.acceleration.x * deltaTime;
+    const float accelY = settings.acceleration.y * deltaTime;
+
+    // a halott slotokat is léptetjük: elágazás nélkül olcsóbb, mint kihagyni őket
+    const int n = (used + 3) & ~3;
+    float* __restrict px = posX.data();
+    float* __restrict py = posY.data();
+    float* __restrict vx = velX.data();
+    float* __restrict vy = velY.data();
+    float* __restrict a = age.data();
+
+#ifdef RAVENS_PARTICLES_SSE
+    const __m128 dt4 = _mm_set1_ps(deltaTime);
+    const __m128 damp4 = _mm_set1_ps(damping);
+    const __m128 ax4 = _mm_set1_ps(accelX);
+    const __m128 ay4 = _mm_set1_ps(accelY);
+    for (int i = 0; i < n; i += 4) {
+        const __m128 newVx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vx + i), ax4), damp4);
+        const __m128 newVy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vy + i), ay4), damp4);
+        _mm_storeu_ps(vx + i, newVx);
+        _mm_storeu_ps(vy + i, newVy);
+        _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(newVx, dt4)));
+        _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(newVy, dt4)));
+        _mm_storeu_ps(a + i, _mm_add_ps(_mm_loadu_ps(a + i), dt4));
+    }
+#else
+    for (int i = 0; i < n; ++i) {
+        vx[i] = (vx[i] + accelX) * damping;
+        vy[i] = (vy[i] + accelY) * damping;
+        px[i] += vx[i] * deltaTime;
+        py[i] += vy[i] * deltaTime;
+        a[i] += deltaTime;
+    }
+#endif
+}
+
+int ParticleEmitter::AppendInstances(std::vector<SpriteInstance>& out) const
+{
+    int alive = 0;
+    for (int i = 0; i < used; ++i) {
+        if (age[i] >= lifetime[i])
+            continue;
+
+        const float t = age[i] / lifetime[i];
+        const float size = settings.startSize + (settings.endSize - settings.startSize) * t;
+        const glm::vec4 color = settings.startColor + (settings.endColor - settings.startColor) * t;
+        out.push_back({ glm::vec2(posX[i], posY[i]), glm::vec2(size), glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+            InstancedSpriteRenderer::PackColor(color) });
+        ++alive;
+    }
+    return alive;
+}
+
+ParticleSystem::ParticleSystem(ThreadPool* workers)
+    : workers(workers)
+{
+}
+
+ParticleEmitter& ParticleSystem::CreateEmitter(const ParticleEmitterSettings& settings)
+{
+    emitters.push_back(std::make_unique<ParticleEmitter>(settings));
+    return *emitters.back();
+}
+
+void ParticleSystem::Update(float deltaTime)
+{
+    ALLOCATION_SCOPE("ParticleSystem::Update");
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+
+    // a kibocsátók függetlenek (saját puffer, saját RNG), egy feladat = egy kibocsátó
+    const int emitterCount = static_cast<int>(emitters.size());
+    auto simulateRange = [this, deltaTime](int begin, int end) {
+        for (int e = begin; e < end; ++e)
+            emitters[e]->Simulate(deltaTime);
+    };
+
+    if (workers && emitterCount > 1)
+        workers->ParallelFor(emitterCount, 1, simulateRange);
+    else
+        simulateRange(0, emitterCount);
+
+    stats.updateMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    stats.particleCount = 0; // a BuildInstances hívások gyűjtik össze az élő részecskéket
+}
+
+void ParticleSystem::BuildInstances(ParticleBlendMode blendMode, std::vector<SpriteInstance>& out)
+{
+    out.clear();
+    for (const auto& emitter : emitters)
+        if (emitter->GetBlendMode() == blendMode)
+            stats.particleCount += emitter->AppendInstances(out);
+}
@@ -0,0 +1,97 @@
+﻿#pragma once
+#include <cstdint>
+#include <glm.hpp>
+#include <memory>
+#include <vector>
+#include "../Renderer/InstancedSpriteRenderer.h"
+
+class ThreadPool;
+
+enum class ParticleBlendMode { Alpha = 0, Additive = 1, Count = 2 };
+
+struct ParticleEmitterSettings
+{
+    int capacity = 1024;
+    ParticleBlendMode blendMode = ParticleBlendMode::Alpha;
+
+    float minLifetime = 0.3f, maxLifetime = 0.6f;
+    float minSpeed = 0.0f, maxSpeed = 50.0f;
+    float spreadRadians = 6.2831853f;    // Emit irány körüli szórás (teljes kör alapból)
+    glm::vec2 acceleration{ 0.0f };
+    float drag = 0.0f;                   // sebesség-csillapítás 1/s
+
+    float startSize = 6.0f, endSize = 0.0f;
+    glm::vec4 startColor{ 1.0f };
+    glm::vec4 endColor{ 1.0f, 1.0f, 1.0f, 0.0f };
+
+    // folyamatos kibocsátás (db/s) a spawn-középpont körüli téglalapban (pl. por)
+    float spawnRate = 0.0f;
+    glm::vec2 spawnAreaHalfExtent{ 0.0f };
+
+    // a véletlen sorozat kezdőállapota; 0: kibocsátónként eltérő, a létrehozás sorrendjéből
+    uint32_t seed = 0;
+};
+
+// Egy kibocsátó saját gyűrűpufferrel: az új részecske mindig a legrégebbi helyére kerül,
+// így nincs tömörítés, a szimuláció pedig a teljes SoA tömbön SIMD-del fut.
+class ParticleEmitter
+{
+public:
+    explicit ParticleEmitter(const ParticleEmitterSettings& settings);
+
+    void Emit(int count, const glm::vec2& position, const glm::vec2& direction = glm::vec2(0.0f));
+    // rate db/s a deltaTime alatt; a tört részt a következő hívásra viszi, így a sűrűség nem függ az FPS-től
+    void EmitOverTime(float rate, float deltaTime, const glm::vec2& position, const glm::vec2& direction = glm::vec2(0.0f));
+    void SetSpawnCenter(const glm::vec2& center) { spawnCenter = center; }
+
+    void Simulate(float deltaTime);
+
+    // a még élő részecskék példányait hozzáfűzi, visszaadja a számukat
+    int AppendInstances(std::vector<SpriteInstance>& out) const;
+
+    ParticleBlendMode GetBlendMode() const { return settings.blendMode; }
+    int GetCapacity() const { return capacity; }
+
+private:
+    ParticleEmitterSettings settings;
+    int capacity;
+    int head = 0;
+    int used = 0;   // eddig valaha írt slotok (<= capacity); csak ennyit szimulálunk
+    uint32_t rng;
+    float spawnAccumulator = 0.0f;
+    float emitAccumulator = 0.0f;
+    glm::vec2 spawnCenter{ 0.0f };
+
+    std::vector<float> posX, posY;
+    std::vector<float> velX, velY;
+    std::vector<float> age, lifetime;
+
+    float NextRandom();
+};
+
+class ParticleSystem
+{
+public:
+    struct Stats
+    {
+        int particleCount = 0;
+        double updateMs = 0.0;
+    };
+
+    explicit ParticleSystem(ThreadPool* workers = nullptr);
+
+    ParticleEmitter& CreateEmitter(const ParticleEmitterSettings& settings);
+
+    // kibocsátónként párhuzamosan szimulál
+    void Update(float deltaTime);
+
+    // egy blend-módhoz tartozó összes kibocsátó példányai egy listába (egy rajzolás)
+    void BuildInstances(ParticleBlendMode blendMode, std::vector<SpriteInstance>& out);
+
+    const Stats& GetStats() const { return stats; }
+
+private:
+    ThreadPool* workers;
+    std::vector<std::unique_ptr<ParticleEmitter>> emitters;
+    Stats stats;
+};
@@ -0,0 +1,73 @@
+﻿#include "PlayerHud.h"
+#include "../Core/Globals.h"
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    // a csíkok ferdék: a felső él balra tolva (a korábbi paralelogramma-VAO-k formája)
+    constexpr float kBarWidth = 300.0f;
+    constexpr float kBarHeight = 25.0f;
+    constexpr float kBarSlant = -15.0f;
+    constexpr float kBorderSlant = -20.0f;
+    constexpr float kDashBarHeight = 8.0f;
+    constexpr float kHealthTextScale = 2.0f;
+    constexpr float kDashTextScale = 1.0f;
+
+    const glm::vec4 kBorderColor(1.0f, 1.0f, 1.0f, 1.0f);
+    const glm::vec4 kBarBackground(0.3f, 0.3f, 0.3f, 1.0f);
+    const glm::vec4 kHealthColor(0.0f, 1.0f, 0.0f, 1.0f);
+    const glm::vec4 kDashCharging(0.2f, 0.45f, 0.6f, 1.0f);
+    const glm::vec4 kDashReady(0.3f, 0.8f, 1.0f, 1.0f);
+    const glm::vec4 kHealthTextColor(1.0f, 1.0f, 1.0f, 1.0f);
+}
+
+PlayerHud::PlayerHud(UIRenderer& ui, const BitmapFont& font)
+    : ui(ui), font(font)
+{
+    const float screenWidth = (float)Globals::WindowWidth;
+    const glm::vec2 borderPos(screenWidth - kBarWidth - 36.5f, 16.0f);
+    const glm::vec2 barPos(screenWidth - kBarWidth - 30.0f, 20.0f);
+
+    // keret -> csík: létrehozási sorrendben rajzolódnak
+    ui.AddPanel({ borderPos + glm::vec2(-kBorderSlant, 0.0f), glm::vec2(kBarWidth + 8.0f, 33.0f), kBorderSlant }, kBorderColor);
+    healthBar = ui.AddBar({ barPos + glm::vec2(-kBarSlant, 0.0f), glm::vec2(kBarWidth, kBarHeight), kBarSlant },
+        kBarBackground, kHealthColor, UIRenderer::FillDirection::RightToLeft);
+
+    // a dash a keret fölött, ugyanolyan dőléssel
+    const float dashSlant = kBarSlant * kDashBarHeight / kBarHeight;
+    dashBar = ui.AddBar({ glm::vec2(barPos.x - kBarSlant, borderPos.y + 33.0f + 6.0f), glm::vec2(kBarWidth, kDashBarHeight), dashSlant },
+        kBarBackground, kDashReady, UIRenderer::FillDirection::RightToLeft);
+
+    // a szövegek a csíkok után: fölöttük rajzolódnak. Az életerő a csík bal végén, függőlegesen
+    // középen; a dash ideje a dash-csíktól balra, jobbra igazítva
+    healthText = ui.AddText(glm::vec2(barPos.x - kBarSlant + 8.0f, barPos.y + 7.0f), 16, kHealthTextScale, kHealthTextColor);
+    dashTextAnchor = glm::vec2(barPos.x - kBarSlant - 6.0f, borderPos.y + 33.0f + 6.0f + 1.0f);
+    dashText = ui.AddText(dashTextAnchor, 8, kDashTextScale, kDashReady);
+}
+
+void PlayerHud::Update(int currentHealth, int maxHealth, float dashCooldown)
+{
+    // 0 alatt és a maximum fölött nincs kitöltés
+    const bool validHealth = currentHealth > 0 && currentHealth <= maxHealth;
+    ui.SetBarValue(healthBar, validHealth ? (float)currentHealth / (float)maxHealth : 0.0f);
+
+    const float charge = 1.0f - glm::clamp(dashCooldown / Globals::DashCooldownInSeconds, 0.0f, 1.0f);
+    ui.SetBarValue(dashBar, charge);
+    ui.SetColor(dashBar, dashCooldown > 0.0f ? kDashCharging : kDashReady);
+
+    // tizedmásodpercre kerekítve: a szöveg legfeljebb tízszer változik másodpercenként, a többi
+    // képkockán a SetText a tárolt elrendezést hagyja
+    char text[32];
+    std::snprintf(text, sizeof(text), "%d/%d", currentHealth > 0 ? currentHealth : 0, maxHealth);
+    ui.SetText(healthText, text);
+
+    if (dashCooldown > 0.0f)
+        std::snprintf(text, sizeof(text), "%.1f", std::ceil(dashCooldown * 10.0f) / 10.0f);
+    else
+        std::snprintf(text, sizeof(text), "DASH");
+    const float width = font.MeasureWidth(text, kDashTextScale);
+    ui.SetShape(dashText, { glm::vec2(dashTextAnchor.x - width, dashTextAnchor.y) });
+    ui.SetText(dashText, text);
+    ui.SetColor(dashText, dashCooldown > 0.0f ? kDashCharging : kDashReady);
+}
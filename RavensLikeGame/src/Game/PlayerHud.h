@@ -0,0 +1,24 @@
+﻿#pragma once
+#include "../Core/UIRenderer.h"
+
+// A játékos HUD-ja: életerő-csík kerettel (benne az életerő számmal) és fölötte a dash
+// töltődése a hátralévő idővel. A widgetek egyszer jönnek létre; képkockánként csak az értékek
+// mennek át, az újraépítésről (és a szöveg újra elrendezéséről) a UIRenderer dönt.
+class PlayerHud
+{
+public:
+    // a font a szövegek igazításához (a UIRenderer-nek is ez a fontja)
+    PlayerHud(UIRenderer& ui, const BitmapFont& font);
+
+    // dashCooldown: a hátralévő idő (DashState::cooldown), 0: kész
+    void Update(int currentHealth, int maxHealth, float dashCooldown);
+
+private:
+    UIRenderer& ui;
+    const BitmapFont& font;
+    UIRenderer::WidgetId healthBar;
+    UIRenderer::WidgetId healthText;
+    UIRenderer::WidgetId dashBar;
+    UIRenderer::WidgetId dashText;
+    glm::vec2 dashTextAnchor{ 0.0f };   // a dash-szöveg jobb vége az alapvonalon
+};
@@ -0,0 +1,273 @@
+﻿#include "ProjectileSystem.h"
+#include "../Core/AllocationTracker.h"
+#include "../Core/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+ProjectileSystem::ProjectileSystem(int capacity, ThreadPool* workers)
+    : capacity(capacity), workers(workers)
+{
+    posX.resize(capacity);
+    posY.resize(capacity);
+    velX.resize(capacity);
+    velY.resize(capacity);
+    age.resize(capacity);
+    lifetime.resize(capacity);
+    radius.resize(capacity);
+    color.resize(capacity);
+    hits.reserve(1024);
+
+    const int chunkCount = (capacity + kChunkSize - 1) / kChunkSize;
+    chunkAlive.resize(chunkCount);
+    chunkHits.resize(chunkCount);
+    for (std::vector<ProjectileHit>& chunkHit : chunkHits)
+        chunkHit.reserve(256);
+}
+
+bool ProjectileSystem::Spawn(const glm::vec2& position, const glm::vec2& velocity,
+    float life, float r, const glm::vec4& rgba)
+{
+    if (count >= capacity)
+        return false;
+
+    const int i = count++;
+    posX[i] = position.x;
+    posY[i] = position.y;
+    velX[i] = velocity.x;
+    velY[i] = velocity.y;
+    age[i] = 0.0f;
+    lifetime[i] = life;
+    radius[i] = r;
+    color[i] = InstancedSpriteRenderer::PackColor(rgba);
+    maxRadius = std::max(maxRadius, r);
+    return true;
+}
+
+void ProjectileSystem::Update(float deltaTime, const TileMap& map, const IsoGrid& grid,
+    const std::vector<glm::vec2>& entityPositions, float entityRadius)
+{
+    ALLOCATION_SCOPE("ProjectileSystem::Update");
+    hits.clear();
+    if (count == 0)
+        return;
+
+    RefreshWalkable(map);
+
+    // entitás broadphase: rács a célpontokra, cella >= entitás + lövedék sugár (a kötegek csak olvassák)
+    if (!entityPositions.empty())
+        entityGrid.Build(entityPositions.data(), static_cast<int>(entityPositions.size()), entityRadius + maxRadius);
+
+    // a kötegek függetlenek: mindegyik a saját tartományát integrálja és tömöríti
+    const UpdateParams params{ deltaTime, &grid, &entityPositions, entityRadius };
+    const int chunkCount = (count + kChunkSize - 1) / kChunkSize;
+    auto updateRange = [this, &params](int begin, int end) {
+        for (int chunk = begin; chunk < end; ++chunk)
+            chunkAlive[chunk] = UpdateChunk(chunk, params);
+    };
+
+    if (workers && chunkCount > 1)
+        workers->ParallelFor(chunkCount, 1, updateRange);
+    else
+        updateRange(0, chunkCount);
+
+    // a találatok kötegsorrendben, így a kimenet nem függ a szálak ütemezésétől
+    for (int chunk = 0; chunk < chunkCount; ++chunk)
+        hits.insert(hits.end(), chunkHits[chunk].begin(), chunkHits[chunk].end());
+    CloseGaps(chunkCount);
+}
+
+int ProjectileSystem::UpdateChunk(int chunk, const UpdateParams& params)
+{
+    const int begin = chunk * kChunkSize;
+    const int end = std::min(begin + kChunkSize, count);
+    std::vector<ProjectileHit>& chunkHit = chunkHits[chunk];
+    chunkHit.clear();
+
+    // 1) integrálás: tiszta, elágazás nélküli ciklus a SoA tömbökön (a fordító vektorizálja)
+    const float deltaTime = params.deltaTime;
+    float* __restrict px = posX.data();
+    float* __restrict py = posY.data();
+    const float* __restrict vx = velX.data();
+    const float* __restrict vy = velY.data();
+    float* __restrict a = age.data();
+    for (int i = begin; i < end; ++i) {
+        px[i] += vx[i] * deltaTime;
+        py[i] += vy[i] * deltaTime;
+        a[i] += deltaTime;
+    }
+
+    // 2) lejárat, fal és entitás ütközés; a halottak helyére a köteg utolsó eleme kerül,
+    // így a túlélők a köteg elején maradnak
+    const std::vector<glm::vec2>& entityPositions = *params.entityPositions;
+    const bool hasEntities = !entityPositions.empty();
+    int alive = end;
+    for (int i = begin; i < alive; ) {
+        if (age[i] >= lifetime[i]) {
+            CopyProjectile(--alive, i);
+            continue;
+        }
+
+        const glm::vec2 p(posX[i], posY[i]);
+        if (IsWallAt(*params.grid, p.x, p.y)) {
+            chunkHit.push_back({ p, -1 });
+            CopyProjectile(--alive, i);
+            continue;
+        }
+
+        if (hasEntities) {
+            const float hitDistance = params.entityRadius + radius[i];
+            int hitEntity = -1;
+            entityGrid.ForEachNear(p, [&](int e) {
+                if (hitEntity < 0) {
+                    const glm::vec2 d = entityPositions[e] - p;
+                    if (glm::dot(d, d) < hitDistance * hitDistance)
+                        hitEntity = e;
+                }
+            });
+
+            if (hitEntity >= 0) {
+                chunkHit.push_back({ p, hitEntity });
+                CopyProjectile(--alive, i);
+                continue;
+            }
+        }
+        ++i;
+    }
+    return alive - begin;
+}
+
+void ProjectileSystem::CloseGaps(int chunkCount)
+{
+    int newCount = 0;
+    for (int chunk = 0; chunk < chunkCount; ++chunk)
+        newCount += chunkAlive[chunk];
+
+    // Az új hossz alatti lyukakba a tömb végéről, felülről lefelé kerülnek a túlélők: pontosan
+    // annyi, ahány túlélő az új hossz mögött maradt, vagyis legfeljebb a képkockában kiesettek száma.
+    int source = chunkCount - 1;
+    int sourceEnd = source * kChunkSize + chunkAlive[source];
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        const int holeEnd = std::min((chunk + 1) * kChunkSize, newCount);
+        for (int hole = chunk * kChunkSize + chunkAlive[chunk]; hole < holeEnd; ++hole) {
+            while (sourceEnd == source * kChunkSize) {
+                --source;
+                sourceEnd = source * kChunkSize + chunkAlive[source];
+            }
+            CopyProjectile(--sourceEnd, hole);
+        }
+    }
+    count = newCount;
+}
+
+void ProjectileSystem::BuildInstances(std::vector<SpriteInstance>& out) const
+{
+    out.resize(count);
+    for (int i = 0; i < count; ++i) {
+        const float size = radius[i] * 2.0f;
+        out[i] = { glm::vec2(posX[i], posY[i]), glm::vec2(size), glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), color[i] };
+    }
+}
+
+void ProjectileSystem::RefreshWalkable(const TileMap& map)
+{
+    if (walkableRevision == map.GetRevision())
+        return;
+
+    walkableRevision = map.GetRevision();
+    walkableWidth = map.GetWidth();
+    walkableHeight = map.GetHeight();
+    walkable.resize(static_cast<size_t>(walkableWidth) * walkableHeight);
+    for (int y = 0; y < walkableHeight; ++y)
+        for (int x = 0; x < walkableWidth; ++x)
+            walkable[y * walkableWidth + x] = map.IsTileWalkable(x, y) ? 1 : 0;
+}
+
+bool ProjectileSystem::IsWallAt(const IsoGrid& grid, float x, float y) const
+{
+    const glm::ivec2 tile = grid.WorldToTile(glm::vec2(x, y));
+    if (tile.x < 0 || tile.y < 0 || tile.x >= walkableWidth || tile.y >= walkableHeight)
+        return true; // pályán kívül: elnyeli a lövedéket
+    return walkable[tile.y * walkableWidth + tile.x] == 0;
+}
+
+void ProjectileSystem::CopyProjectile(int from, int to)
+{
+    posX[to] = posX[from];
+    posY[to] = posY[from];
+    velX[to] = velX[from];
+    velY[to] = velY[from];
+    age[to] = age[from];
+    lifetime[to] = lifetime[from];
+    radius[to] = radius[from];
+    color[to] = color[from];
+}
+
+void ProjectileSystem::Benchmark(int projectileCount, int entityCount, int frames)
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr int kMapSize = 128;
+    constexpr float kDeltaTime = 1.0f / 60.0f;
+
+    // körben fal, belül szórt falcsempék (~5%): a lövedékek egy része falba csapódik
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<std::vector<int>> tiles(kMapSize, std::vector<int>(kMapSize, 0));
+    for (int y = 0; y < kMapSize; ++y)
+        for (int x = 0; x < kMapSize; ++x)
+            if (x == 0 || y == 0 || x == kMapSize - 1 || y == kMapSize - 1 || unit(random) < 0.05f)
+                tiles[y][x] = 1;
+    TileMap map;
+    map.SetTiles(tiles);
+
+    IsoGrid grid;
+    grid.halfWidth = 64.0f;
+    grid.halfHeight = 32.0f;
+    auto randomPoint = [&]() {
+        return grid.TileCenter(1 + static_cast<int>(unit(random) * (kMapSize - 2)), 1 + static_cast<int>(unit(random) * (kMapSize - 2)))
+            + glm::vec2(unit(random) - 0.5f, unit(random) - 0.5f) * grid.halfHeight;
+    };
+
+    std::vector<glm::vec2> entities(entityCount);
+    for (glm::vec2& entity : entities)
+        entity = randomPoint();
+
+    // ugyanaz a lövedék-utánpótlás mindkét futásnál: a spawn saját, újraindított RNG-t kap
+    std::vector<SpriteInstance> instances;
+    ThreadPool workers;
+    std::cout << "Projectiles, " << projectileCount << " alive, " << entityCount << " targets, " << frames << " frames:" << std::endl;
+    for (ThreadPool* pool : { static_cast<ThreadPool*>(nullptr), &workers }) {
+        ProjectileSystem projectiles(projectileCount, pool);
+        std::mt19937 spawnRandom(5678);
+        double updateMs = 0.0, instancesMs = 0.0, maxUpdateMs = 0.0;
+        size_t wallHits = 0, entityHits = 0;
+        for (int frame = 0; frame < frames; ++frame) {
+            while (projectiles.GetCount() < projectileCount) {
+                const float angle = unit(spawnRandom) * 6.2831853f;
+                const glm::vec2 position = grid.TileCenter(1 + static_cast<int>(unit(spawnRandom) * (kMapSize - 2)), 1 + static_cast<int>(unit(spawnRandom) * (kMapSize - 2)))
+                    + glm::vec2(unit(spawnRandom) - 0.5f, unit(spawnRandom) - 0.5f) * grid.halfHeight;
+                projectiles.Spawn(position, glm::vec2(std::cos(angle), std::sin(angle)) * 700.0f, 1.5f, 4.0f, glm::vec4(1.0f));
+            }
+
+            auto start = Clock::now();
+            projectiles.Update(kDeltaTime, map, grid, entities, 10.0f);
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            updateMs += ms;
+            maxUpdateMs = std::max(maxUpdateMs, ms);
+            for (const ProjectileHit& hit : projectiles.GetHits())
+                ++(hit.entity < 0 ? wallHits : entityHits);
+
+            start = Clock::now();
+            projectiles.BuildInstances(instances);
+            instancesMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+        const double runs = static_cast<double>(std::max(frames, 1));
+        const unsigned int threads = pool ? pool->GetWorkerCount() + 1 : 1;
+        std::cout << "  " << threads << " thread(s):\n"
+            << "    Update:         " << updateMs / runs << " ms avg, " << maxUpdateMs << " ms max\n"
+            << "    BuildInstances: " << instancesMs / runs << " ms avg\n"
+            << "    hits per frame: " << wallHits / runs << " wall, " << entityHits / runs << " entity" << std::endl;
+    }
+}
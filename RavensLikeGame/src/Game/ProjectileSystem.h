@@ -0,0 +1,88 @@
+﻿#pragma once
+#include <cstdint>
+#include <glm.hpp>
+#include <vector>
+#include "SpatialGrid.h"
+#include "TileMap.h"
+#include "../Core/IsoGrid.h"
+#include "../Renderer/InstancedSpriteRenderer.h"
+
+class ThreadPool;
+
+struct ProjectileHit
+{
+    glm::vec2 position;
+    int entity;     // -1: falba csapódott
+};
+
+// Fix kapacitású, SoA tárolású lövedék-készlet: nincs new/delete lövedékenként,
+// a halott elemek helyére a tömb végéről kerül túlélő, így a tömb mindig tömör.
+// Thread poollal az Update kötegenként párhuzamosan integrál és selejtez.
+class ProjectileSystem
+{
+public:
+    static constexpr int kDefaultCapacity = 200000;
+
+    explicit ProjectileSystem(int capacity = kDefaultCapacity, ThreadPool* workers = nullptr);
+
+    // false, ha a készlet tele van
+    bool Spawn(const glm::vec2& position, const glm::vec2& velocity,
+        float lifetime, float radius, const glm::vec4& color);
+
+    // entityPositions: ütközhető entitások középpontjai (lehet üres)
+    void Update(float deltaTime, const TileMap& map, const IsoGrid& grid,
+        const std::vector<glm::vec2>& entityPositions, float entityRadius);
+
+    void BuildInstances(std::vector<SpriteInstance>& out) const;
+
+    const std::vector<ProjectileHit>& GetHits() const { return hits; }
+    int GetCount() const { return count; }
+    int GetCapacity() const { return capacity; }
+    void Clear() { count = 0; }
+
+    // "--bench-projectiles": projectileCount lövedék egy 128x128-as pályán entityCount célponttal,
+    // folyamatos utánpótlással; az Update (egy szálon és thread poollal) és a BuildInstances
+    // ideje képkockánként
+    static void Benchmark(int projectileCount, int entityCount, int frames);
+
+private:
+    // egy köteg ennyi egymás utáni lövedék; a kötegek egymástól függetlenül frissülnek
+    static constexpr int kChunkSize = 8192;
+
+    struct UpdateParams
+    {
+        float deltaTime;
+        const IsoGrid* grid;
+        const std::vector<glm::vec2>* entityPositions;
+        float entityRadius;
+    };
+
+    int capacity;
+    int count = 0;
+    float maxRadius = 0.0f;
+    ThreadPool* workers;
+
+    std::vector<float> posX, posY;
+    std::vector<float> velX, velY;
+    std::vector<float> age, lifetime;
+    std::vector<float> radius;
+    std::vector<uint32_t> color;
+
+    std::vector<ProjectileHit> hits;
+    SpatialGrid entityGrid;
+
+    // kötegenként: a köteg elejére tömörített túlélők száma és a köteg találatai
+    std::vector<int> chunkAlive;
+    std::vector<std::vector<ProjectileHit>> chunkHits;
+
+    // A TileMap járhatósága lapos bájt-tömbként (revízióváltáskor frissül)
+    std::vector<uint8_t> walkable;
+    int walkableWidth = 0, walkableHeight = 0;
+    unsigned int walkableRevision = ~0u;
+
+    void RefreshWalkable(const TileMap& map);
+    bool IsWallAt(const IsoGrid& grid, float x, float y) const;
+    int UpdateChunk(int chunk, const UpdateParams& params);
+    void CloseGaps(int chunkCount);
+    void CopyProjectile(int from, int to);
+};
@@ -0,0 +1,64 @@
+#include "SpatialGrid.h"
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    constexpr int kMaxGridCells = 1 << 20;
+
+    bool IsFinite(const glm::vec2& p)
+    {
+        return std::isfinite(p.x) && std::isfinite(p.y);
+    }
+}
+
+void SpatialGrid::Build(const glm::vec2* positions, int count, float minCellSize)
+{
+    // NaN / végtelen pozíció nem kerül a rácsba: a kiterjedésbe és a cellaindexbe számolva
+    // az int-konverzió nem definiált, és a rács méretét is elrontaná
+    glm::vec2 minPos(std::numeric_limits<float>::max());
+    glm::vec2 maxPos(std::numeric_limits<float>::lowest());
+    int finiteCount = 0;
+    for (int i = 0; i < count; ++i) {
+        if (!IsFinite(positions[i]))
+            continue;
+        minPos = glm::min(minPos, positions[i]);
+        maxPos = glm::max(maxPos, positions[i]);
+        ++finiteCount;
+    }
+    if (finiteCount == 0) {
+        cellStart.clear();
+        return;
+    }
+
+    cellSize = std::max(minCellSize, 1.0f);
+    const glm::vec2 extent = maxPos - minPos;
+    while ((extent.x / cellSize + 1.0f) * (extent.y / cellSize + 1.0f) > static_cast<float>(kMaxGridCells))
+        cellSize *= 2.0f;
+
+    gridMin = minPos;
+    gridWidth = static_cast<int>(extent.x / cellSize) + 1;
+    gridHeight = static_cast<int>(extent.y / cellSize) + 1;
+
+    cellStart.assign(static_cast<size_t>(gridWidth) * gridHeight + 1, 0);
+    itemCell.resize(count);
+    sortedItems.resize(finiteCount);
+
+    for (int i = 0; i < count; ++i) {
+        if (!IsFinite(positions[i])) {
+            itemCell[i] = -1;
+            continue;
+        }
+        const glm::ivec2 c = CellOf(positions[i]);
+        itemCell[i] = c.y * gridWidth + c.x;
+        ++cellStart[itemCell[i] + 1];
+    }
+    for (size_t c = 1; c < cellStart.size(); ++c)
+        cellStart[c] += cellStart[c - 1];
+
+    cellFill.assign(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < count; ++i) {
+        if (itemCell[i] >= 0)
+            sortedItems[cellFill[itemCell[i]]++] = i;
+    }
+}
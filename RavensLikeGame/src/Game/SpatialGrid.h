@@ -0,0 +1,50 @@
+﻿#pragma once
+#include <algorithm>
+#include <cmath>
+#include <glm.hpp>
+#include <vector>
+
+// Egyenletes rács pontokhoz (counting sort: cellStart + rendezett indexek).
+// Minden képkockán újraépíthető allokáció nélkül; a cella legalább akkora,
+// mint a lekérdezési sugár, így a 3x3 szomszéd cella mindig elég.
+// A nem véges (NaN / végtelen) pozíciójú elemek kimaradnak: egy lekérdezés sem adja vissza őket.
+class SpatialGrid
+{
+public:
+    void Build(const glm::vec2* positions, int count, float minCellSize);
+
+    template <typename Fn>
+    void ForEachNear(const glm::vec2& p, Fn&& fn) const
+    {
+        if (cellStart.empty() || !std::isfinite(p.x) || !std::isfinite(p.y))
+            return;
+
+        const glm::ivec2 c = CellOf(p);
+        for (int y = std::max(0, c.y - 1); y <= std::min(gridHeight - 1, c.y + 1); ++y) {
+            for (int x = std::max(0, c.x - 1); x <= std::min(gridWidth - 1, c.x + 1); ++x) {
+                const int cell = y * gridWidth + x;
+                for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k)
+                    fn(sortedItems[k]);
+            }
+        }
+    }
+
+    float GetCellSize() const { return cellSize; }
+
+private:
+    glm::vec2 gridMin{ 0.0f };
+    int gridWidth = 0, gridHeight = 0;
+    float cellSize = 1.0f;
+    std::vector<int> cellStart;
+    std::vector<int> sortedItems;
+    std::vector<int> itemCell;
+    std::vector<int> cellFill;
+
+    glm::ivec2 CellOf(const glm::vec2& p) const
+    {
+        // a rácson kívül eső pont a legközelebbi szélső cellához tartozik
+        const int cx = static_cast<int>((p.x - gridMin.x) / cellSize);
+        const int cy = static_cast<int>((p.y - gridMin.y) / cellSize);
+        return glm::ivec2(std::clamp(cx, 0, gridWidth - 1), std::clamp(cy, 0, gridHeight - 1));
+    }
+};
@@ -1,16 +1,38 @@
 #include "TileMap.h"
-#include <fstream>
+#include "../Core/VirtualFileSystem.h"
+#include <charconv>
 #include <iostream>
 
-bool TileMap::Load(const std::string& path)
+namespace
 {
-    std::ifstream file(path);
-    if (!file.is_open()) {
+    // a kvetkez szkzzel elvlasztott egsz; hinyz/hibs rtknl 0 (mint a stream-es olvassnl)
+    int ReadInt(const char*& cursor, const char* end)
+    {
+        while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n'))
+            ++cursor;
+
+        int value = 0;
+        const std::from_chars_result result = std::from_chars(cursor, end, value);
+        if (result.ec != std::errc())
+            return 0;
+        cursor = result.ptr;
+        return value;
+    }
+}
+
+bool TileMap::Load(const std::string& path, TextureCache& textures)
+{
+    // a trkp szvegt helyben, msols nlkl rtelmezzk (csomagolva a lekpezett archvumbl)
+    AssetData file;
+    if (!VirtualFileSystem::Get().Read(path, file)) {
         std::cerr << "Failed to load map: " << path << std::endl;
         return false;
     }
 
-    file >> mapHeight >> mapWidth;
+    const char* cursor = file.Text().data();
+    const char* end = cursor + file.Size();
+    mapHeight = ReadInt(cursor, end);
+    mapWidth = ReadInt(cursor, end);
 
     if (mapHeight <= 0 || mapWidth <= 0) {
         std::cerr << "Invalid map size in file: " << path << std::endl;
@@ -21,17 +43,21 @@ bool TileMap::Load(const std::string& path)
 
     for (int y = 0; y < mapHeight; y++)
         for (int x = 0; x < mapWidth; x++)
-            file >> tiles[y][x];
+            tiles[y][x] = ReadInt(cursor, end);
 
-    tileTextures[0].LoadFromFile("assets/textures/tiles/green.png");
-    tileTextures[1].LoadFromFile("assets/textures/tiles/vertical_wall.png");
-    tileTextures[2].LoadFromFile("assets/textures/tiles/horizontal_wall.png");
-    tileTextures[3].LoadFromFile("assets/textures/tiles/topleft_wall_curve.png");
-    tileTextures[4].LoadFromFile("assets/textures/tiles/topright_wall_curve.png");
-    tileTextures[5].LoadFromFile("assets/textures/tiles/bottomright_wall_curve.png");
-    tileTextures[6].LoadFromFile("assets/textures/tiles/bottomleft_wall_curve.png");
+    tileTextures[0] = textures.AcquireAsync("assets/textures/tiles/green.png");
+    tileTextures[1] = textures.AcquireAsync("assets/textures/tiles/vertical_wall.png");
+    tileTextures[2] = textures.AcquireAsync("assets/textures/tiles/horizontal_wall.png");
+    tileTextures[3] = textures.AcquireAsync("assets/textures/tiles/topleft_wall_curve.png");
+    tileTextures[4] = textures.AcquireAsync("assets/textures/tiles/topright_wall_curve.png");
+    tileTextures[5] = textures.AcquireAsync("assets/textures/tiles/bottomright_wall_curve.png");
+    tileTextures[6] = textures.AcquireAsync("assets/textures/tiles/bottomleft_wall_curve.png");
 
     tileSize = 16.0f;
+    ++revision;
+    ++blockerRevision;
+    changeLog.clear();
+    changeLogBaseRevision = revision;
 
     return true;
 }
@@ -40,8 +66,8 @@ void TileMap::Draw(SpriteRenderer& renderer) {
     for (int y = 0; y < mapHeight; y++) {
         for (int x = 0; x < mapWidth; x++) {
             int id = tiles[y][x];
-            if (id >= 0 && id < 7)
-                renderer.DrawSprite(tileTextures[id],
+            if (id >= 0 && id < 7 && tileTextures[id])
+                renderer.DrawSprite(*tileTextures[id],
                     glm::vec2(x * tileSize, y * tileSize),
                     glm::vec2(tileSize, tileSize));
         }
@@ -77,4 +103,62 @@ bool TileMap::IsAreaWalkable(float x, float y, float width, float height) const
     }
 
     return true;
+}
+
+void TileMap::SetTiles(const std::vector<std::vector<int>>& data)
+{
+    tiles = data;
+    mapHeight = static_cast<int>(tiles.size());
+    mapWidth = mapHeight > 0 ? static_cast<int>(tiles[0].size()) : 0;
+    ++revision;
+    ++blockerRevision;
+    changeLog.clear();
+    changeLogBaseRevision = revision;
+}
+
+void TileMap::SetTile(int x, int y, int id)
+{
+    if (x < 0 || y < 0 || x >= mapWidth || y >= mapHeight || tiles[y][x] == id)
+        return;
+
+    if (IsBlockerID(tiles[y][x]) != IsBlockerID(id))
+        ++blockerRevision;
+
+    tiles[y][x] = id;
+    ++revision;
+
+    // a napl felt eldobjuk, ha betelt; a nla rgebbi revzikra teljes frissts jr
+    if (changeLog.size() >= kMaxChangeLog) {
+        const size_t drop = changeLog.size() / 2;
+        changeLogBaseRevision = changeLog[drop - 1].revision;
+        changeLog.erase(changeLog.begin(), changeLog.begin() + drop);
+    }
+    changeLog.push_back({ revision, glm::ivec2(x, y) });
+}
+
+bool TileMap::GetChangesSince(unsigned int sinceRevision, std::vector<glm::ivec2>& out) const
+{
+    if (sinceRevision < changeLogBaseRevision)
+        return false;
+
+    for (const TileChange& change : changeLog)
+        if (change.revision > sinceRevision)
+            out.push_back(change.cell);
+    return true;
+}
+
+bool TileMap::IsTileWalkable(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= mapWidth || y >= mapHeight)
+        return false;
+
+    const int tileID = tiles[y][x];
+    return tileID >= 0 && tileID < 7 && walkable[tileID];
+}
+
+bool TileMap::BlocksSight(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= mapWidth || y >= mapHeight)
+        return true;
+    return IsBlockerID(tiles[y][x]);
 }
\ No newline at end of file
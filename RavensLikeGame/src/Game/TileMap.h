@@ -2,19 +2,52 @@
 #include <vector>
 #include <string>
 #include <glm.hpp>
-#include "../Renderer/Texture.h"
+#include "../Renderer/TextureCache.h"
 #include "../Renderer/SpriteRenderer.h"
 
 class TileMap {
 public:
-    bool Load(const std::string& path);
+    // a csempe-textrk a cache-bl, httrben tltdnek: jratltskor nincs j dekdols/feltlts
+    bool Load(const std::string& path, TextureCache& textures);
     void Draw(SpriteRenderer& renderer);
     bool IsWalkable(float worldX, float worldY) const;
     bool IsAreaWalkable(float x, float y, float width, float height) const;
+
+    void SetTiles(const std::vector<std::vector<int>>& data);
+    void SetTile(int x, int y, int id);
+
+    int GetWidth() const { return mapWidth; }
+    int GetHeight() const { return mapHeight; }
+    int GetTile(int x, int y) const { return tiles[y][x]; }
+    bool IsTileWalkable(int x, int y) const;
+    bool BlocksSight(int x, int y) const;
+    const std::vector<std::vector<int>>& GetTiles() const { return tiles; }
+
+    // Minden csempe-vltozsnl n; a rcsra pl cache-ek ezzel vetik ssze magukat
+    unsigned int GetRevision() const { return revision; }
+    // Csak akkor n, ha egy csempe ltst takar llapota vltozik (falak: 1..6)
+    unsigned int GetBlockerRevision() const { return blockerRevision; }
+
+    // A sinceRevision ta megvltozott csempk (ismtldhetnek) az out vgre.
+    // false, ha a napl ezt mr nem fedi le (pl. SetTiles volt): ilyenkor teljes frissts kell.
+    bool GetChangesSince(unsigned int sinceRevision, std::vector<glm::ivec2>& out) const;
 private:
     std::vector<std::vector<int>> tiles;
-    Texture tileTextures[7];
+    TextureRef tileTextures[7];
     bool walkable[7] = { true, false, false, false, false, false, false };
     int mapWidth = 0, mapHeight = 0;
     float tileSize = 64.0f;
+    unsigned int revision = 0;
+    unsigned int blockerRevision = 0;
+
+    struct TileChange
+    {
+        unsigned int revision;
+        glm::ivec2 cell;
+    };
+    std::vector<TileChange> changeLog;
+    unsigned int changeLogBaseRevision = 0;  // ennl rgebbi revzirl nincs napl
+    static constexpr size_t kMaxChangeLog = 4096;
+
+    static bool IsBlockerID(int id) { return id >= 1 && id <= 6; }
 };
\ No newline at end of file
@@ -0,0 +1,144 @@
+﻿#include "AsyncTextureLoader.h"
+#include "../Core/ThreadPool.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+AsyncTextureLoader::AsyncTextureLoader(ThreadPool& pool)
+    : pool(pool), decodedQueue(kQueueCapacity)
+{
+}
+
+AsyncTextureLoader::~AsyncTextureLoader()
+{
+    // a futó dekódolások a sorba írnak: meg kell várni őket
+    while (inFlight.load(std::memory_order_acquire) > 0) {
+        std::unique_ptr<Decoded> dropped;
+        if (!decodedQueue.TryPop(dropped))
+            std::this_thread::yield();
+    }
+}
+
+uint64_t AsyncTextureLoader::Request(const std::string& path, const TextureImportSettings& settings)
+{
+    const uint64_t ticket = nextTicket.fetch_add(1, std::memory_order_relaxed);
+    inFlight.fetch_add(1, std::memory_order_relaxed);
+
+    pool.Submit([this, ticket, path, settings]() {
+        auto decoded = std::make_unique<Decoded>();
+        decoded->ticket = ticket;
+        decoded->settings = settings;
+        decoded->ok = TextureImporter::Import(path, settings, decoded->image);
+
+        // tele sornál a GL szál még nem vette át a korábbiakat: a kép a mellék-listára kerül,
+        // a worker szál szabadon marad a következő feladatnak
+        if (!decodedQueue.TryPush(decoded)) {
+            std::lock_guard<std::mutex> lock(overflowMutex);
+            overflow.push_back(std::move(decoded));
+            hasOverflow.store(true, std::memory_order_release);
+        }
+        inFlight.fetch_sub(1, std::memory_order_release);
+    });
+    return ticket;
+}
+
+void AsyncTextureLoader::Update(size_t budgetBytes, std::vector<Completed>& completed)
+{
+    // a PBO-k az első Update-ben jönnek létre: a kérések már a GL kontextus előtt indulhatnak
+    if (pixelBuffers[0] == 0)
+        for (GLBuffer& buffer : pixelBuffers)
+            buffer = GLBuffer::Create();
+
+    std::unique_ptr<Decoded> decoded;
+    while (decodedQueue.TryPop(decoded)) {
+        Upload upload;
+        upload.decoded = std::move(decoded);
+        uploads.push_back(std::move(upload));
+    }
+    if (hasOverflow.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(overflowMutex);
+        for (std::unique_ptr<Decoded>& spilled : overflow) {
+            Upload upload;
+            upload.decoded = std::move(spilled);
+            uploads.push_back(std::move(upload));
+        }
+        overflow.clear();
+        hasOverflow.store(false, std::memory_order_relaxed);
+    }
+
+    while (!uploads.empty()) {
+        Upload& upload = uploads.front();
+        if (upload.decoded->ok && !UploadRows(upload, budgetBytes))
+            break;
+
+        Completed done;
+        done.ticket = upload.decoded->ticket;
+        done.texture = std::move(upload.texture);
+        done.image = std::move(upload.decoded->image);
+        completed.push_back(std::move(done));
+        uploads.pop_front();
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+bool AsyncTextureLoader::UploadRows(Upload& upload, size_t& budgetBytes)
+{
+    const ImportedTexture& image = upload.decoded->image;
+    const int levelCount = static_cast<int>(image.levels.size());
+    if (budgetBytes == 0)
+        return false;
+
+    if (upload.texture == 0) {
+        // a teljes lánc helyfoglalása adat nélkül; a tartalom darabonként PBO-ból jön
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        upload.texture = GLTexture::Create();
+        glBindTexture(GL_TEXTURE_2D, upload.texture);
+        for (int i = 0; i < levelCount; ++i)
+            glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, image.levels[i].width, image.levels[i].height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        TextureImporter::ConfigureSampling(levelCount, upload.decoded->settings);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, upload.texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    while (upload.level < levelCount) {
+        const ImportedTexture::Level& level = image.levels[upload.level];
+        const size_t rowBytes = static_cast<size_t>(level.width) * 4;
+
+        // amíg van keret, legalább egy sor megy, különben egy széles kép sosem haladna
+        if (budgetBytes == 0)
+            return false;
+        const size_t remainingRows = static_cast<size_t>(level.height - upload.row);
+        const int rows = static_cast<int>(std::min(remainingRows, std::max<size_t>(1, budgetBytes / rowBytes)));
+        const size_t bytes = rowBytes * rows;
+
+        // árva puffer minden darabnál: a driver nem vár az előző feltöltés befejezésére
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[nextPixelBuffer]);
+        nextPixelBuffer = (nextPixelBuffer + 1) % kPixelBufferCount;
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (mapped) {
+            std::memcpy(mapped, level.pixels.data() + rowBytes * upload.row, bytes);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glTexSubImage2D(GL_TEXTURE_2D, upload.level, 0, upload.row, level.width, rows, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+        else {
+            // leképezés nélkül közvetlenül a kliens memóriából
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glTexSubImage2D(GL_TEXTURE_2D, upload.level, 0, upload.row, level.width, rows, GL_RGBA, GL_UNSIGNED_BYTE,
+                level.pixels.data() + rowBytes * upload.row);
+        }
+
+        budgetBytes -= std::min(budgetBytes, bytes);
+        upload.row += rows;
+        if (upload.row >= level.height) {
+            upload.row = 0;
+            ++upload.level;
+        }
+    }
+    return true;
+}
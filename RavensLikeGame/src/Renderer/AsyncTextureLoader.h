@@ -0,0 +1,80 @@
+﻿#pragma once
+#include "TextureImporter.h"
+#include "GLHandle.h"
+#include "../Core/LockFreeQueue.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// PNG dekódolás (TextureImporter::Import) a worker szálakon; a kész képek zármentes soron
+// jutnak a GL szálhoz, ahol Update képkockánként legfeljebb a megadott bájtnyit tölt fel
+// pixel buffer objecteken át, soronkénti darabokban. A textúra csak a teljes lánc
+// feltöltése után adódik át, így félkész kép sosem látszik.
+class AsyncTextureLoader
+{
+public:
+    struct Completed
+    {
+        uint64_t ticket = 0;
+        GLTexture texture;          // üres, ha a betöltés nem sikerült; a hívóé lesz
+        ImportedTexture image;      // a CPU-oldali lánc (pl. az IsoRenderer hálójához)
+    };
+
+    // GL kontextus nélkül is létrehozható; GL csak az Update-hez és a destruktorhoz kell
+    explicit AsyncTextureLoader(ThreadPool& pool);
+    ~AsyncTextureLoader();
+
+    AsyncTextureLoader(const AsyncTextureLoader&) = delete;
+    AsyncTextureLoader& operator=(const AsyncTextureLoader&) = delete;
+
+    // Bármely szálról; a visszakapott jegy azonosítja a kész textúrát
+    uint64_t Request(const std::string& path, const TextureImportSettings& settings);
+
+    // GL szál: a kész dekódolások átvétele és legfeljebb budgetBytes feltöltése;
+    // a teljesen feltöltött textúrák a completed végére kerülnek
+    void Update(size_t budgetBytes, std::vector<Completed>& completed);
+
+    size_t GetPendingCount() const { return inFlight.load(std::memory_order_relaxed) + uploads.size(); }
+
+private:
+    struct Decoded
+    {
+        uint64_t ticket = 0;
+        bool ok = false;
+        TextureImportSettings settings;
+        ImportedTexture image;
+    };
+
+    struct Upload
+    {
+        std::unique_ptr<Decoded> decoded;
+        GLTexture texture;
+        int level = 0;
+        int row = 0;
+    };
+
+    static constexpr size_t kQueueCapacity = 64;
+    static constexpr int kPixelBufferCount = 2;
+
+    ThreadPool& pool;
+    LockFreeQueue<std::unique_ptr<Decoded>> decodedQueue;
+    // ha a sor tele van, a worker ide teszi a képet és megy tovább (nem pörög a GL szálra várva)
+    std::mutex overflowMutex;
+    std::vector<std::unique_ptr<Decoded>> overflow;
+    std::atomic<bool> hasOverflow{ false };
+    std::atomic<size_t> inFlight{ 0 };
+    std::atomic<uint64_t> nextTicket{ 1 };
+
+    std::deque<Upload> uploads;
+    GLBuffer pixelBuffers[kPixelBufferCount];
+    int nextPixelBuffer = 0;
+
+    // false, ha az aktuális szint még nincs kész (elfogyott a keret)
+    bool UploadRows(Upload& upload, size_t& budgetBytes);
+};
@@ -0,0 +1,202 @@
+﻿#include "BitmapFont.h"
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+    enum class Accent : uint8_t { None, Acute, Diaeresis, DoubleAcute };
+
+    struct GlyphArt
+    {
+        uint32_t codepoint;
+        const char* rows;
+    };
+
+    struct AccentedArt
+    {
+        uint32_t codepoint;
+        uint32_t base;
+        Accent accent;
+    };
+
+    constexpr GlyphArt kGlyphArt[] = {
+#define FONT_GLYPH(codepoint, rows) { (uint32_t)codepoint, rows },
+#define FONT_ACCENTED(codepoint, base, accent)
+#include "BitmapFontGlyphs.inl"
+#undef FONT_ACCENTED
+#undef FONT_GLYPH
+    };
+
+    constexpr AccentedArt kAccentedArt[] = {
+#define FONT_GLYPH(codepoint, rows)
+#define FONT_ACCENTED(codepoint, base, accent) { (uint32_t)codepoint, (uint32_t)base, Accent::accent },
+#include "BitmapFontGlyphs.inl"
+#undef FONT_ACCENTED
+#undef FONT_GLYPH
+    };
+
+    // az ékezetek a cella két felső sorában (ugyanabban a formában, mint a glifek)
+    const char* AccentRows(Accent accent)
+    {
+        switch (accent) {
+        case Accent::Acute:       return "...#. ..#..";
+        case Accent::Diaeresis:   return "..... .#.#.";
+        case Accent::DoubleAcute: return "..#.# .#.#.";
+        default:                  return nullptr;
+        }
+    }
+
+    constexpr int kGlyphWidth = 5;
+    constexpr int kGlyphHeight = 8;
+    constexpr int kDescent = 1;             // az alapvonal alatti sorok
+    constexpr float kAdvance = 6.0f;
+    // egy pixel térköz a cellák között: a skálázott négyszögek széle se lóg át a szomszédba
+    constexpr int kCellWidth = 8;
+    constexpr int kCellHeight = 10;
+    constexpr int kColumns = 16;
+    constexpr int kAtlasWidth = kColumns * kCellWidth;
+    constexpr uint32_t kFallback = '?';
+    constexpr uint32_t kReplacement = 0xFFFD;
+
+    // RGBA8, premultiplikált fehér: a ui.frag a csúcsszínnel szoroz
+    void PlotRows(std::vector<uint8_t>& pixels, int cellX, int cellY, const char* rows, int rowCount)
+    {
+        for (int row = 0; row < rowCount; ++row) {
+            const int y = cellY + (kGlyphHeight - 1 - row);     // a textúra első sora a v = 0
+            for (int column = 0; column < kGlyphWidth; ++column) {
+                const bool set = rows[row * (kGlyphWidth + 1) + column] == '#';
+                uint8_t* texel = &pixels[((size_t)y * kAtlasWidth + cellX + column) * 4];
+                std::fill(texel, texel + 4, set ? 255 : 0);
+            }
+        }
+    }
+}
+
+BitmapFont::BitmapFont()
+{
+    constexpr int glyphArtCount = (int)(sizeof(kGlyphArt) / sizeof(kGlyphArt[0]));
+    int accentCellCount = 0;
+    for (const AccentedArt& art : kAccentedArt)
+        accentCellCount += art.accent != Accent::None ? 1 : 0;
+
+    // glifek, ékezetes glifek, végül a fehér cella
+    const int cellCount = glyphArtCount + accentCellCount + 1;
+    const int atlasHeight = ((cellCount + kColumns - 1) / kColumns) * kCellHeight;
+    std::vector<uint8_t> pixels((size_t)kAtlasWidth * atlasHeight * 4, 0);
+
+    int cell = 0;
+    auto placeCell = [&](const char* rows, Accent accent) {
+        const int cellX = (cell % kColumns) * kCellWidth;
+        const int cellY = (cell / kColumns) * kCellHeight;
+        ++cell;
+        PlotRows(pixels, cellX, cellY, rows, kGlyphHeight);
+        if (const char* accentRows = AccentRows(accent))
+            PlotRows(pixels, cellX, cellY, accentRows, 2);
+
+        Glyph glyph;
+        glyph.uvRect = glm::vec4((float)cellX / kAtlasWidth, (float)cellY / atlasHeight,
+            (float)(cellX + kGlyphWidth) / kAtlasWidth, (float)(cellY + kGlyphHeight) / atlasHeight);
+        glyph.offset = glm::vec2(0.0f, -(float)kDescent);
+        glyph.size = glm::vec2((float)kGlyphWidth, (float)kGlyphHeight);
+        glyph.advance = kAdvance;
+        glyph.visible = std::any_of(rows, rows + (kGlyphWidth + 1) * kGlyphHeight - 1, [](char c) { return c == '#'; });
+        return glyph;
+    };
+
+    for (const GlyphArt& art : kGlyphArt) {
+        const Glyph glyph = placeCell(art.rows, Accent::None);
+        if (art.codepoint < 128)
+            ascii[art.codepoint] = glyph;
+        else
+            extraGlyphs.push_back({ art.codepoint, glyph });
+    }
+    for (const AccentedArt& art : kAccentedArt) {
+        const GlyphArt* base = std::find_if(std::begin(kGlyphArt), std::end(kGlyphArt),
+            [&](const GlyphArt& glyph) { return glyph.codepoint == art.base; });
+        if (base == std::end(kGlyphArt))
+            continue;
+        // ékezet nélkül az alapbetű cellája
+        const Glyph glyph = art.accent != Accent::None ? placeCell(base->rows, art.accent) : GetGlyph(art.base);
+        extraGlyphs.push_back({ art.codepoint, glyph });
+    }
+    std::sort(extraGlyphs.begin(), extraGlyphs.end(),
+        [](const ExtraGlyph& a, const ExtraGlyph& b) { return a.codepoint < b.codepoint; });
+
+    const int whiteX = (cell % kColumns) * kCellWidth;
+    const int whiteY = (cell / kColumns) * kCellHeight;
+    for (int y = whiteY; y < whiteY + kCellHeight; ++y)
+        std::fill(&pixels[((size_t)y * kAtlasWidth + whiteX) * 4], &pixels[((size_t)y * kAtlasWidth + whiteX + kCellWidth) * 4], 255);
+    whiteUv = glm::vec2((whiteX + kCellWidth * 0.5f) / kAtlasWidth, (whiteY + kCellHeight * 0.5f) / atlasHeight);
+
+    atlas = GLTexture::Create();
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, kAtlasWidth, atlasHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+const BitmapFont::Glyph& BitmapFont::GetGlyph(uint32_t codepoint) const
+{
+    if (codepoint < 128) {
+        const Glyph& glyph = ascii[codepoint];
+        return glyph.advance > 0.0f ? glyph : ascii[kFallback];
+    }
+    auto it = std::lower_bound(extraGlyphs.begin(), extraGlyphs.end(), codepoint,
+        [](const ExtraGlyph& glyph, uint32_t value) { return glyph.codepoint < value; });
+    return it != extraGlyphs.end() && it->codepoint == codepoint ? it->glyph : ascii[kFallback];
+}
+
+float BitmapFont::MeasureWidth(std::string_view utf8, float scale) const
+{
+    float width = 0.0f, line = 0.0f;
+    size_t index = 0;
+    while (index < utf8.size()) {
+        const uint32_t codepoint = DecodeUtf8(utf8, index);
+        if (codepoint == '\n') {
+            line = 0.0f;
+            continue;
+        }
+        line += GetGlyph(codepoint).advance;
+        width = std::max(width, line);
+    }
+    return width * scale;
+}
+
+uint32_t BitmapFont::DecodeUtf8(std::string_view text, size_t& index)
+{
+    const uint8_t lead = (uint8_t)text[index];
+    if (lead < 0x80) {
+        ++index;
+        return lead;
+    }
+
+    int length = 0;
+    uint32_t codepoint = 0;
+    if ((lead & 0xE0) == 0xC0) { length = 2; codepoint = lead & 0x1F; }
+    else if ((lead & 0xF0) == 0xE0) { length = 3; codepoint = lead & 0x0F; }
+    else if ((lead & 0xF8) == 0xF0) { length = 4; codepoint = lead & 0x07; }
+    if (length == 0 || index + length > text.size()) {
+        ++index;
+        return kReplacement;
+    }
+
+    for (int i = 1; i < length; ++i) {
+        const uint8_t next = (uint8_t)text[index + i];
+        if ((next & 0xC0) != 0x80) {
+            ++index;
+            return kReplacement;
+        }
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    // túl hosszú kódolás és a helyettesítő (surrogate) tartomány sem érvényes
+    static constexpr uint32_t minimum[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+    if (codepoint < minimum[length] || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        ++index;
+        return kReplacement;
+    }
+    index += length;
+    return codepoint;
+}
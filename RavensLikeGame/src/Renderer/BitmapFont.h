@@ -0,0 +1,53 @@
+﻿#pragma once
+#include "GLHandle.h"
+#include <cstdint>
+#include <glm.hpp>
+#include <string_view>
+#include <vector>
+
+// Pixeles HUD-font: a glifek a forrásban vannak (BitmapFontGlyphs.inl), az atlasz betöltéskor
+// épül belőlük fájl és raszterizálás nélkül. Az atlasz egy RGBA8 textúra a glifekkel és egy
+// fehér cellával, így a UIRenderer sima elemei és a szöveg egy rajzolásban mennek (SetFont).
+// Egész skálán, NEAREST szűréssel éles; a toll az alapvonal bal végén áll (bal-alsó origó).
+class BitmapFont
+{
+public:
+    struct Glyph
+    {
+        glm::vec4 uvRect{ 0.0f };   // (u0, v0, u1, v1), v0 a cella alja
+        glm::vec2 offset{ 0.0f };   // a négyszög bal-alsó sarka a tollhoz képest (1x skálán)
+        glm::vec2 size{ 0.0f };
+        float advance = 0.0f;
+        bool visible = false;       // szóköz: csak előrelép
+    };
+
+    // GL szál: az atlasz felépítése és feltöltése
+    BitmapFont();
+
+    // ismeretlen kódpont: a '?' glifje
+    const Glyph& GetGlyph(uint32_t codepoint) const;
+    // a leghosszabb sor szélessége pixelben; '\n' új sort kezd
+    float MeasureWidth(std::string_view utf8, float scale = 1.0f) const;
+    float GetLineHeight() const { return kLineHeight; }
+
+    unsigned int GetAtlas() const { return atlas; }
+    const glm::vec2& GetWhiteUv() const { return whiteUv; }
+
+    // A text[index]-en kezdődő kódpont; index a következő karakterre lép. Hibás vagy
+    // csonka bájtsorozat: U+FFFD, egy bájtot lép.
+    static uint32_t DecodeUtf8(std::string_view text, size_t& index);
+
+    static constexpr float kLineHeight = 10.0f;
+
+private:
+    struct ExtraGlyph
+    {
+        uint32_t codepoint;
+        Glyph glyph;
+    };
+
+    GLTexture atlas;
+    glm::vec2 whiteUv{ 0.5f };
+    Glyph ascii[128];
+    std::vector<ExtraGlyph> extraGlyphs;    // ASCII-n kívül, kódpont szerint rendezve
+};
@@ -0,0 +1,125 @@
+﻿// A beépített HUD-font glifjei (5x8-as cella, 6 pixeles előrelépés) X-makró listaként:
+//     FONT_GLYPH(kódpont, "8 sor, fentről lefelé, szóközzel elválasztva")
+//     FONT_ACCENTED(kódpont, alapbetű, ékezet)
+// '#': kitöltött pixel. A 6. sor az alapvonal, a 7. a lelógó száraké (g, j, p, q, y); a
+// kisbetűk törzse a 2. sortól kezdődik, így az ékezet a 0-1. sorba kerül. A nagybetűk
+// ékezetes változata nem fér a cellába: azokat a BitmapFont az alapbetűvel rajzolja.
+// Új glifnél elég ide felvenni, az atlasz és a keresőtábla ebből épül.
+
+FONT_GLYPH(' ', "..... ..... ..... ..... ..... ..... ..... .....")
+FONT_GLYPH('!', "..#.. ..#.. ..#.. ..#.. ..#.. ..... ..#.. .....")
+FONT_GLYPH('"', ".#.#. .#.#. ..... ..... ..... ..... ..... .....")
+FONT_GLYPH('#', ".#.#. .#.#. ##### .#.#. ##### .#.#. .#.#. .....")
+FONT_GLYPH('$', "..#.. .#### #.#.. .###. ..#.# ####. ..#.. .....")
+FONT_GLYPH('%', "##... ##..# ...#. ..#.. .#... #..## ...## .....")
+FONT_GLYPH('&', ".##.. #..#. #.#.. .#... #.#.# #..#. .##.# .....")
+FONT_GLYPH('\'', "..#.. ..#.. ..... ..... ..... ..... ..... .....")
+FONT_GLYPH('(', "...#. ..#.. .#... .#... .#... ..#.. ...#. .....")
+FONT_GLYPH(')', ".#... ..#.. ...#. ...#. ...#. ..#.. .#... .....")
+FONT_GLYPH('*', "..... ..#.. #.#.# .###. #.#.# ..#.. ..... .....")
+FONT_GLYPH('+', "..... ..#.. ..#.. ##### ..#.. ..#.. ..... .....")
+FONT_GLYPH(',', "..... ..... ..... ..... ..... .##.. ..#.. .#...")
+FONT_GLYPH('-', "..... ..... ..... ##### ..... ..... ..... .....")
+FONT_GLYPH('.', "..... ..... ..... ..... ..... .##.. .##.. .....")
+FONT_GLYPH('/', "..... ....# ...#. ..#.. .#... #.... ..... .....")
+FONT_GLYPH('0', ".###. #...# #..## #.#.# ##..# #...# .###. .....")
+FONT_GLYPH('1', "..#.. .##.. ..#.. ..#.. ..#.. ..#.. .###. .....")
+FONT_GLYPH('2', ".###. #...# ....# ...#. ..#.. .#... ##### .....")
+FONT_GLYPH('3', "##### ...#. ..#.. ...#. ....# #...# .###. .....")
+FONT_GLYPH('4', "...#. ..##. .#.#. #..#. ##### ...#. ...#. .....")
+FONT_GLYPH('5', "##### #.... ####. ....# ....# #...# .###. .....")
+FONT_GLYPH('6', "..##. .#... #.... ####. #...# #...# .###. .....")
+FONT_GLYPH('7', "##### ....# ...#. ..#.. .#... .#... .#... .....")
+FONT_GLYPH('8', ".###. #...# #...# .###. #...# #...# .###. .....")
+FONT_GLYPH('9', ".###. #...# #...# .#### ....# ...#. .##.. .....")
+FONT_GLYPH(':', "..... .##.. .##.. ..... .##.. .##.. ..... .....")
+FONT_GLYPH(';', "..... .##.. .##.. ..... .##.. ..#.. .#... .....")
+FONT_GLYPH('<', "...#. ..#.. .#... #.... .#... ..#.. ...#. .....")
+FONT_GLYPH('=', "..... ..... ##### ..... ##### ..... ..... .....")
+FONT_GLYPH('>', ".#... ..#.. ...#. ....# ...#. ..#.. .#... .....")
+FONT_GLYPH('?', ".###. #...# ....# ...#. ..#.. ..... ..#.. .....")
+FONT_GLYPH('@', ".###. #...# ....# .##.# #.#.# #.#.# .###. .....")
+FONT_GLYPH('A', ".###. #...# #...# ##### #...# #...# #...# .....")
+FONT_GLYPH('B', "####. #...# #...# ####. #...# #...# ####. .....")
+FONT_GLYPH('C', ".###. #...# #.... #.... #.... #...# .###. .....")
+FONT_GLYPH('D', "###.. #..#. #...# #...# #...# #..#. ###.. .....")
+FONT_GLYPH('E', "##### #.... #.... ####. #.... #.... ##### .....")
+FONT_GLYPH('F', "##### #.... #.... ####. #.... #.... #.... .....")
+FONT_GLYPH('G', ".###. #...# #.... #.### #...# #...# .#### .....")
+FONT_GLYPH('H', "#...# #...# #...# ##### #...# #...# #...# .....")
+FONT_GLYPH('I', ".###. ..#.. ..#.. ..#.. ..#.. ..#.. .###. .....")
+FONT_GLYPH('J', "..### ...#. ...#. ...#. ...#. #..#. .##.. .....")
+FONT_GLYPH('K', "#...# #..#. #.#.. ##... #.#.. #..#. #...# .....")
+FONT_GLYPH('L', "#.... #.... #.... #.... #.... #.... ##### .....")
+FONT_GLYPH('M', "#...# ##.## #.#.# #.#.# #...# #...# #...# .....")
+FONT_GLYPH('N', "#...# #...# ##..# #.#.# #..## #...# #...# .....")
+FONT_GLYPH('O', ".###. #...# #...# #...# #...# #...# .###. .....")
+FONT_GLYPH('P', "####. #...# #...# ####. #.... #.... #.... .....")
+FONT_GLYPH('Q', ".###. #...# #...# #...# #.#.# #..#. .##.# .....")
+FONT_GLYPH('R', "####. #...# #...# ####. #.#.. #..#. #...# .....")
+FONT_GLYPH('S', ".#### #.... #.... .###. ....# ....# ####. .....")
+FONT_GLYPH('T', "##### ..#.. ..#.. ..#.. ..#.. ..#.. ..#.. .....")
+FONT_GLYPH('U', "#...# #...# #...# #...# #...# #...# .###. .....")
+FONT_GLYPH('V', "#...# #...# #...# #...# #...# .#.#. ..#.. .....")
+FONT_GLYPH('W', "#...# #...# #...# #.#.# #.#.# #.#.# .#.#. .....")
+FONT_GLYPH('X', "#...# #...# .#.#. ..#.. .#.#. #...# #...# .....")
+FONT_GLYPH('Y', "#...# #...# .#.#. ..#.. ..#.. ..#.. ..#.. .....")
+FONT_GLYPH('Z', "##### ....# ...#. ..#.. .#... #.... ##### .....")
+FONT_GLYPH('[', ".###. .#... .#... .#... .#... .#... .###. .....")
+FONT_GLYPH('\\', "..... #.... .#... ..#.. ...#. ....# ..... .....")
+FONT_GLYPH(']', ".###. ...#. ...#. ...#. ...#. ...#. .###. .....")
+FONT_GLYPH('^', "..#.. .#.#. #...# ..... ..... ..... ..... .....")
+FONT_GLYPH('_', "..... ..... ..... ..... ..... ..... ..... #####")
+FONT_GLYPH('`', ".#... ..#.. ..... ..... ..... ..... ..... .....")
+FONT_GLYPH('a', "..... ..... .###. ....# .#### #...# .#### .....")
+FONT_GLYPH('b', "#.... #.... #.##. ##..# #...# #...# ####. .....")
+FONT_GLYPH('c', "..... ..... .###. #.... #.... #...# .###. .....")
+FONT_GLYPH('d', "....# ....# .##.# #..## #...# #...# .#### .....")
+FONT_GLYPH('e', "..... ..... .###. #...# ##### #.... .###. .....")
+FONT_GLYPH('f', "..##. .#..# .#... ###.. .#... .#... .#... .....")
+FONT_GLYPH('g', "..... ..... .#### #...# #...# .#### ....# .###.")
+FONT_GLYPH('h', "#.... #.... #.##. ##..# #...# #...# #...# .....")
+FONT_GLYPH('i', "..#.. ..... .##.. ..#.. ..#.. ..#.. .###. .....")
+FONT_GLYPH('j', "...#. ..... ..##. ...#. ...#. ...#. #..#. .##..")
+FONT_GLYPH('k', "#.... #.... #..#. #.#.. ##... #.#.. #..#. .....")
+FONT_GLYPH('l', ".##.. ..#.. ..#.. ..#.. ..#.. ..#.. .###. .....")
+FONT_GLYPH('m', "..... ..... ##.#. #.#.# #.#.# #...# #...# .....")
+FONT_GLYPH('n', "..... ..... #.##. ##..# #...# #...# #...# .....")
+FONT_GLYPH('o', "..... ..... .###. #...# #...# #...# .###. .....")
+FONT_GLYPH('p', "..... ..... ####. #...# #...# ####. #.... #....")
+FONT_GLYPH('q', "..... ..... .#### #...# #...# .#### ....# ....#")
+FONT_GLYPH('r', "..... ..... #.##. ##..# #.... #.... #.... .....")
+FONT_GLYPH('s', "..... ..... .###. #.... .###. ....# ####. .....")
+FONT_GLYPH('t', ".#... .#... ###.. .#... .#... .#..# ..##. .....")
+FONT_GLYPH('u', "..... ..... #...# #...# #...# #..## .##.# .....")
+FONT_GLYPH('v', "..... ..... #...# #...# #...# .#.#. ..#.. .....")
+FONT_GLYPH('w', "..... ..... #...# #...# #.#.# #.#.# .#.#. .....")
+FONT_GLYPH('x', "..... ..... #...# .#.#. ..#.. .#.#. #...# .....")
+FONT_GLYPH('y', "..... ..... #...# #...# #...# .#### ....# .###.")
+FONT_GLYPH('z', "..... ..... ##### ...#. ..#.. .#... ##### .....")
+FONT_GLYPH('{', "...#. ..#.. ..#.. .#... ..#.. ..#.. ...#. .....")
+FONT_GLYPH('|', "..#.. ..#.. ..#.. ..#.. ..#.. ..#.. ..#.. .....")
+FONT_GLYPH('}', ".#... ..#.. ..#.. ...#. ..#.. ..#.. .#... .....")
+FONT_GLYPH('~', "..... ..... .#... #.#.# ...#. ..... ..... .....")
+
+// a magyar kisbetűk: az alapbetű törzse + ékezet a két felső sorban
+FONT_ACCENTED(0x00E1, 'a', Acute)
+FONT_ACCENTED(0x00E9, 'e', Acute)
+FONT_ACCENTED(0x00ED, 'i', Acute)
+FONT_ACCENTED(0x00F3, 'o', Acute)
+FONT_ACCENTED(0x00F6, 'o', Diaeresis)
+FONT_ACCENTED(0x0151, 'o', DoubleAcute)
+FONT_ACCENTED(0x00FA, 'u', Acute)
+FONT_ACCENTED(0x00FC, 'u', Diaeresis)
+FONT_ACCENTED(0x0171, 'u', DoubleAcute)
+
+// nagybetűk: az alapbetű (lásd fent)
+FONT_ACCENTED(0x00C1, 'A', None)
+FONT_ACCENTED(0x00C9, 'E', None)
+FONT_ACCENTED(0x00CD, 'I', None)
+FONT_ACCENTED(0x00D3, 'O', None)
+FONT_ACCENTED(0x00D6, 'O', None)
+FONT_ACCENTED(0x0150, 'O', None)
+FONT_ACCENTED(0x00DA, 'U', None)
+FONT_ACCENTED(0x00DC, 'U', None)
+FONT_ACCENTED(0x0170, 'U', None)
@@ -0,0 +1,221 @@
+﻿#include "CommandBuffer.h"
+#include "../Core/AllocationTracker.h"
+#include "RadixSort.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr uint32_t kOrderMask = (1u << CommandBuffer::kOrderBits) - 1;
+
+    // Kulcs: pass (4 bit) | [sorrend (24) | program (12) | textúra (12) | VAO (12)] ordered pass-oknál,
+    // az opaque pass-nál az állapot kerül előre: pass | program | textúra | VAO | sorrend.
+    // Az azonosítóknak csak az alsó 12 bitje kerül a kulcsba: a csoportosításhoz elég,
+    // a végrehajtó a teljes azonosítót hasonlítja.
+    constexpr int kPassShift = 60;
+    constexpr int kIdBits = 12;
+    constexpr uint64_t kIdMask = (1u << kIdBits) - 1;
+
+    uint32_t QuantizeUnit(float value)
+    {
+        const float clamped = std::clamp(value, 0.0f, 1.0f);
+        return static_cast<uint32_t>(std::lround(clamped * static_cast<float>(kOrderMask)));
+    }
+
+    void SetCapability(GLenum capability, bool enabled)
+    {
+        if (enabled)
+            glEnable(capability);
+        else
+            glDisable(capability);
+    }
+}
+
+uint32_t CommandBuffer::BackToFront(float depth)
+{
+    return QuantizeUnit((1.0f - depth) * 0.5f);
+}
+
+uint32_t CommandBuffer::FrontToBack(float depth)
+{
+    return QuantizeUnit((depth + 1.0f) * 0.5f);
+}
+
+void CommandBuffer::PushUniform(int location, UniformType type, const float* values, size_t count)
+{
+    if (location < 0)
+        return;
+    uniforms.push_back({ location, type, static_cast<uint32_t>(data.size()) });
+    data.insert(data.end(), values, values + count);
+}
+
+void CommandBuffer::SetInt(int location, int value)
+{
+    float bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    PushUniform(location, UniformType::Int, &bits, 1);
+}
+
+void CommandBuffer::SetFloat(int location, float value)
+{
+    PushUniform(location, UniformType::Float, &value, 1);
+}
+
+void CommandBuffer::SetVec2(int location, const glm::vec2& value)
+{
+    PushUniform(location, UniformType::Vec2, &value[0], 2);
+}
+
+void CommandBuffer::SetVec3(int location, const glm::vec3& value)
+{
+    PushUniform(location, UniformType::Vec3, &value[0], 3);
+}
+
+void CommandBuffer::SetVec4(int location, const glm::vec4& value)
+{
+    PushUniform(location, UniformType::Vec4, &value[0], 4);
+}
+
+void CommandBuffer::SetMat4(int location, const glm::mat4& value)
+{
+    PushUniform(location, UniformType::Mat4, &value[0][0], 16);
+}
+
+void CommandBuffer::Record(RenderPass pass, uint32_t order, DrawCommand command)
+{
+    const uint64_t stateBits = ((command.program & kIdMask) << (2 * kIdBits))
+        | ((command.texture & kIdMask) << kIdBits)
+        | (command.vao & kIdMask);
+    const uint64_t orderBits = order & kOrderMask;
+
+    command.key = static_cast<uint64_t>(pass) << kPassShift;
+    if (pass == RenderPass::WorldOpaque)
+        command.key |= (stateBits << kOrderBits) | orderBits;
+    else
+        command.key |= (orderBits << (3 * kIdBits)) | stateBits;
+
+    command.firstUniform = pendingUniforms;
+    command.uniformCount = static_cast<uint16_t>(uniforms.size() - pendingUniforms);
+    pendingUniforms = static_cast<uint32_t>(uniforms.size());
+    commands.push_back(command);
+}
+
+void CommandBuffer::Clear()
+{
+    commands.clear();
+    uniforms.clear();
+    data.clear();
+    pendingUniforms = 0;
+}
+
+CommandBuffer& CommandQueue::CreateBuffer()
+{
+    buffers.push_back(std::make_unique<CommandBuffer>());
+    return *buffers.back();
+}
+
+void CommandQueue::ApplyUniforms(const CommandBuffer& buffer, const DrawCommand& command)
+{
+    for (uint32_t i = 0; i < command.uniformCount; ++i) {
+        const CommandBuffer::UniformWrite& write = buffer.uniforms[command.firstUniform + i];
+        const float* values = buffer.data.data() + write.offset;
+        switch (write.type)
+        {
+        case CommandBuffer::UniformType::Int: {
+            int value;
+            std::memcpy(&value, values, sizeof(value));
+            glUniform1i(write.location, value);
+            break;
+        }
+        case CommandBuffer::UniformType::Float: glUniform1f(write.location, values[0]); break;
+        case CommandBuffer::UniformType::Vec2:  glUniform2fv(write.location, 1, values); break;
+        case CommandBuffer::UniformType::Vec3:  glUniform3fv(write.location, 1, values); break;
+        case CommandBuffer::UniformType::Vec4:  glUniform4fv(write.location, 1, values); break;
+        case CommandBuffer::UniformType::Mat4:  glUniformMatrix4fv(write.location, 1, GL_FALSE, values); break;
+        }
+    }
+    lastStats.uniformWrites += command.uniformCount;
+}
+
+void CommandQueue::Submit()
+{
+    ALLOCATION_SCOPE("CommandQueue::Submit");
+    using Clock = std::chrono::steady_clock;
+    lastStats = Stats();
+
+    const auto sortStart = Clock::now();
+    items.clear();
+    for (uint32_t b = 0; b < buffers.size(); ++b) {
+        const std::vector<DrawCommand>& commands = buffers[b]->commands;
+        for (uint32_t c = 0; c < commands.size(); ++c)
+            items.push_back({ commands[c].key, b, c });
+    }
+    RadixSortByKey(items, scratch, [](const SortItem& item) { return item.key; });
+    lastStats.sortMs = std::chrono::duration<double, std::milli>(Clock::now() - sortStart).count();
+    lastStats.commands = items.size();
+
+    if (!items.empty()) {
+        // a blend és a mélységteszt a sor után visszaáll; a mélységírás az alapértelmezettre (be)
+        const bool blendWasEnabled = glIsEnabled(GL_BLEND) == GL_TRUE;
+        const bool depthTestWasEnabled = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+
+        // ismeretlen kiinduló állapot: az első parancs mindent beállít
+        uint32_t program = ~0u, texture = ~0u, vao = ~0u;
+        int state = -1;
+        glActiveTexture(GL_TEXTURE0);
+
+        for (const SortItem& item : items) {
+            const CommandBuffer& buffer = *buffers[item.buffer];
+            const DrawCommand& command = buffer.commands[item.command];
+
+            if (command.program != program) {
+                glUseProgram(command.program);
+                program = command.program;
+                ++lastStats.programBinds;
+            }
+            if (command.state != state) {
+                const int changed = state < 0 ? 0xFF : (state ^ command.state);
+                if (changed & kStateBlend)
+                    SetCapability(GL_BLEND, command.state & kStateBlend);
+                if (changed & kStateDepthTest)
+                    SetCapability(GL_DEPTH_TEST, command.state & kStateDepthTest);
+                if (changed & kStateDepthWrite)
+                    glDepthMask((command.state & kStateDepthWrite) ? GL_TRUE : GL_FALSE);
+                state = command.state;
+                ++lastStats.stateChanges;
+            }
+            if (command.texture != texture) {
+                glBindTexture(GL_TEXTURE_2D, command.texture);
+                texture = command.texture;
+                ++lastStats.textureBinds;
+            }
+            if (command.vao != vao) {
+                glBindVertexArray(command.vao);
+                vao = command.vao;
+                ++lastStats.vaoBinds;
+            }
+
+            ApplyUniforms(buffer, command);
+            if (command.bindInstances)
+                command.bindInstances(command.binderContext, command.baseInstance);
+
+            if (command.instanceCount > 0)
+                glDrawArraysInstanced(command.primitive, command.first, command.count, command.instanceCount);
+            else
+                glDrawArrays(command.primitive, command.first, command.count);
+        }
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDepthMask(GL_TRUE);
+        SetCapability(GL_BLEND, blendWasEnabled);
+        SetCapability(GL_DEPTH_TEST, depthTestWasEnabled);
+    }
+
+    for (const std::unique_ptr<CommandBuffer>& buffer : buffers)
+        buffer->Clear();
+}
@@ -0,0 +1,131 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm.hpp>
+#include <memory>
+#include <vector>
+
+// Rajzolási pass-ok végrehajtási sorrendben (a kulcs legfelső 4 bitje)
+enum class RenderPass : uint8_t
+{
+    WorldOpaque = 0,    // állapot szerint csoportosítva, azon belül elölről-hátra
+    WorldBlended,       // a megadott sorrendben (hátulról-előre), azon belül állapot szerint
+    UI,                 // rögzítési sorrendben
+    Count
+};
+
+// DrawCommand::state bitjei
+enum RenderStateFlags : uint8_t
+{
+    kStateBlend = 1 << 0,
+    kStateDepthTest = 1 << 1,
+    kStateDepthWrite = 1 << 2,
+};
+
+// Egy rögzített rajzolás. POD: rögzítéskor nincs GL-hívás, így bármelyik szálon készülhet.
+struct DrawCommand
+{
+    // a VAO-hoz kötött példány-attribútumok eltolása (GL 3.3-ban nincs base instance);
+    // a VAO már kötve van, amikor a végrehajtó meghívja
+    using InstanceBinder = void (*)(const void* context, uint32_t baseInstance);
+
+    uint64_t key = 0;           // CommandBuffer::Record tölti ki
+    uint32_t program = 0;
+    uint32_t texture = 0;       // GL_TEXTURE_2D a 0-s egységen; 0: nincs
+    uint32_t vao = 0;
+    uint32_t primitive = 0;     // GL_TRIANGLES, GL_TRIANGLE_FAN...
+    int32_t first = 0;
+    int32_t count = 0;
+    int32_t instanceCount = 0;  // 0: nem instanced
+    uint32_t baseInstance = 0;
+    InstanceBinder bindInstances = nullptr;
+    const void* binderContext = nullptr;
+    uint32_t firstUniform = 0;  // a saját pufferének uniform-tömbjében
+    uint16_t uniformCount = 0;
+    uint8_t state = kStateBlend | kStateDepthTest | kStateDepthWrite;
+};
+
+// Szálanként egy rögzítő puffer. A Set* hívások a következő Record-hoz gyűlnek; a helyek
+// előre lekérdezett uniform-helyek (glGetUniformLocation csak a GL szálon hívható).
+class CommandBuffer
+{
+public:
+    static constexpr int kOrderBits = 24;
+
+    // NDC z -> sorrend a pass-on belül (nagyobb z = hátrébb)
+    static uint32_t BackToFront(float depth);
+    static uint32_t FrontToBack(float depth);
+
+    void SetInt(int location, int value);
+    void SetFloat(int location, float value);
+    void SetVec2(int location, const glm::vec2& value);
+    void SetVec3(int location, const glm::vec3& value);
+    void SetVec4(int location, const glm::vec4& value);
+    void SetMat4(int location, const glm::mat4& value);
+
+    // order: a pass-on belüli sorrend (24 bit; BackToFront / FrontToBack / rögzítési sorszám)
+    void Record(RenderPass pass, uint32_t order, DrawCommand command);
+
+    void Clear();
+    size_t GetCommandCount() const { return commands.size(); }
+
+private:
+    friend class CommandQueue;
+
+    enum class UniformType : uint8_t { Int, Float, Vec2, Vec3, Vec4, Mat4 };
+
+    struct UniformWrite
+    {
+        int32_t location;
+        UniformType type;
+        uint32_t offset;    // a data tömbben (float-ok; az int bitre másolva)
+    };
+
+    std::vector<DrawCommand> commands;
+    std::vector<UniformWrite> uniforms;
+    std::vector<float> data;
+    uint32_t pendingUniforms = 0;   // az első, még parancshoz nem rendelt uniform
+
+    void PushUniform(int location, UniformType type, const float* values, size_t count);
+};
+
+// A pufferek összefésülése, rendezése és végrehajtása a GL szálon, minimális állapotváltással.
+class CommandQueue
+{
+public:
+    struct Stats
+    {
+        size_t commands = 0;
+        size_t programBinds = 0;
+        size_t textureBinds = 0;
+        size_t vaoBinds = 0;
+        size_t stateChanges = 0;
+        size_t uniformWrites = 0;
+        double sortMs = 0.0;
+    };
+
+    // Új rögzítő puffer; a fő szálon, a rögzítés előtt (a pufferek a sor élettartamáig élnek).
+    // Több szálról rögzítve mindegyik szál a sajátjába ír; azonos kulcsnál a pufferek
+    // létrehozási sorrendje, azon belül a rögzítési sorrend marad.
+    CommandBuffer& CreateBuffer();
+
+    // rendez, végrehajt, majd üríti a puffereket; a rögzítő szálak ekkorra végezzenek
+    void Submit();
+
+    const Stats& GetLastStats() const { return lastStats; }
+
+private:
+    struct SortItem
+    {
+        uint64_t key;
+        uint32_t buffer;
+        uint32_t command;
+    };
+
+    std::vector<std::unique_ptr<CommandBuffer>> buffers;
+    std::vector<SortItem> items;
+    std::vector<SortItem> scratch;
+    Stats lastStats;
+
+    void ApplyUniforms(const CommandBuffer& buffer, const DrawCommand& command);
+};
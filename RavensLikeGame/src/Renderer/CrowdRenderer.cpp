@@ -0,0 +1,137 @@
+﻿#include "CrowdRenderer.h"
+#include "../Core/AllocationTracker.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+CrowdRenderer::CrowdRenderer(Shader& shader)
+    : shader(shader)
+{
+    InitRenderData();
+}
+
+void CrowdRenderer::InitRenderData()
+{
+    // alul-középre igazított egység quad: a példány pozíciója a láb
+    float quadVertices[] = {
+        // pos          // tex
+        -0.5f, 0.0f,    0.0f, 0.0f,
+         0.5f, 0.0f,    1.0f, 0.0f,
+         0.5f, 1.0f,    1.0f, 1.0f,
+
+        -0.5f, 0.0f,    0.0f, 0.0f,
+         0.5f, 1.0f,    1.0f, 1.0f,
+        -0.5f, 1.0f,    0.0f, 1.0f
+    };
+
+    vao = GLVertexArray::Create();
+    quadVBO = GLBuffer::Create();
+    instanceVBO = GLBuffer::Create();
+
+    glBindVertexArray(vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+    // egész attribútumok: a shader bitenként bontja ki, nincs normalizálás
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glEnableVertexAttribArray(2);
+    glVertexAttribIPointer(2, 2, GL_SHORT, sizeof(CrowdInstance), (void*)offsetof(CrowdInstance, x));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(CrowdInstance), (void*)offsetof(CrowdInstance, packed));
+    glVertexAttribDivisor(3, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    tableBuffer = GLBuffer::Create();
+    tableTexture = GLTexture::Create();
+}
+
+int CrowdRenderer::AddClip(const glm::vec4* uvRects, int directionCount, int framesPerDirection)
+{
+    if (GetClipCount() >= kMaxClips || directionCount <= 0 || framesPerDirection <= 0)
+        return -1;
+
+    const int clip = GetClipCount();
+    for (int direction = 0; direction < kDirections; ++direction)
+        for (int frame = 0; frame < kMaxFrames; ++frame)
+            uvTable.push_back(uvRects[(direction % directionCount) * framesPerDirection + frame % framesPerDirection]);
+    tableDirty = true;
+    return clip;
+}
+
+bool CrowdRenderer::Pack(const glm::vec2& feet, const glm::vec2& origin, int direction, int frame, int clip, CrowdInstance& out)
+{
+    const glm::vec2 local = glm::round((feet - origin) * kPositionScale);
+    if (local.x < INT16_MIN || local.x > INT16_MAX || local.y < INT16_MIN || local.y > INT16_MAX)
+        return false;
+
+    out.x = static_cast<int16_t>(local.x);
+    out.y = static_cast<int16_t>(local.y);
+    out.packed = (static_cast<uint32_t>(direction) & (kDirections - 1))
+        | ((static_cast<uint32_t>(frame) & (kMaxFrames - 1)) << kDirectionBits)
+        | ((static_cast<uint32_t>(clip) & (kMaxClips - 1)) << (kDirectionBits + kFrameBits));
+    return true;
+}
+
+void CrowdRenderer::UploadTable()
+{
+    glBindBuffer(GL_TEXTURE_BUFFER, tableBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, uvTable.size() * sizeof(glm::vec4), uvTable.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glBindTexture(GL_TEXTURE_BUFFER, tableTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, tableBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    tableDirty = false;
+}
+
+void CrowdRenderer::Draw(const std::vector<CrowdInstance>& instances, const glm::vec2& origin, const glm::vec2& spriteSize,
+    const Texture& sheet, const glm::mat4& projection, const glm::mat4& view)
+{
+    ALLOCATION_SCOPE("CrowdRenderer::Draw");
+    lastUploadBytes = 0;
+    if (instances.empty() || uvTable.empty())
+        return;
+    if (tableDirty)
+        UploadTable();
+
+    shader.Use();
+    shader.SetMat4("projection", projection);
+    shader.SetMat4("view", view);
+    shader.SetVec2("origin", origin);
+    shader.SetFloat("positionScale", kPositionScale);
+    shader.SetVec2("spriteSize", spriteSize);
+    shader.SetVec4("isoGrid", spriteDepth.grid);
+    shader.SetVec4("isoDepth", spriteDepth.depth);
+    shader.SetInt("sprite", 0);
+    shader.SetInt("uvTable", 1);
+    sheet.Bind(0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_BUFFER, tableTexture);
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    const size_t bytes = instances.size() * sizeof(CrowdInstance);
+    // orphaning: a driver új tárat ad, nem kell az előző képkocka rajzolására várni
+    instanceCapacity = std::max(instances.size(), instanceCapacity);
+    glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(CrowdInstance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    lastUploadBytes = bytes;
+
+    // alfa-tesztelt pixel-art: a szereplők mélységet írnak, így egymást is helyesen takarják
+    glBindVertexArray(vao);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(instances.size()));
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE0);
+    sheet.Unbind();
+}
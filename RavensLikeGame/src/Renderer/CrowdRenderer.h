@@ -0,0 +1,70 @@
+﻿#pragma once
+#include "Shader.h"
+#include "Texture.h"
+#include "../Core/IsoGrid.h"
+#include <cstdint>
+#include <glm.hpp>
+#include <vector>
+
+// Egy szereplő képkockánként feltöltött adata: 8 bájt (crowd.vert 2..3-as location).
+// A pozíció a láb (a sprite alja közepe) a rajzolási origóhoz képest, 1/kPositionScale
+// pixelben; a packed: irány (0..2. bit) | képkocka (3..4.) | klip (5..15.).
+struct CrowdInstance
+{
+    int16_t x;
+    int16_t y;
+    uint32_t packed;
+};
+static_assert(sizeof(CrowdInstance) == 8, "CrowdInstance must stay 8 bytes");
+
+// Sok 8 irányú animált szereplő egyetlen instanced rajzolással.
+// Az UV-téglalapokat nem a CPU választja ki: a klipek (irány × képkocka táblák) egy texture
+// bufferbe kerülnek, és a vertex shader a példány irányából, képkockájából és klipjéből
+// keresi ki. Minden szereplő ugyanakkora (spriteSize) és ugyanarról a lapról rajzolódik.
+class CrowdRenderer
+{
+public:
+    static constexpr int kDirectionBits = 3;
+    static constexpr int kFrameBits = 2;
+    static constexpr int kClipBits = 11;
+    static constexpr int kDirections = 1 << kDirectionBits;
+    static constexpr int kMaxFrames = 1 << kFrameBits;
+    static constexpr int kMaxClips = 1 << kClipBits;
+    // fél pixeles lépés: az origó körül ±16383 pixel fér el, ami jóval nagyobb a képernyőnél
+    static constexpr float kPositionScale = 2.0f;
+
+    CrowdRenderer(Shader& shader);
+
+    // uvRects[irány * framesPerDirection + képkocka]; a kMaxFrames-nél rövidebb animációk
+    // körbeérnek (a képkocka a frames-szel vett maradék). -1, ha betelt a tábla.
+    int AddClip(const glm::vec4* uvRects, int directionCount, int framesPerDirection);
+
+    // false, ha a láb az origó körüli tartományon kívül esik (úgyis képen kívül van: eldobható)
+    static bool Pack(const glm::vec2& feet, const glm::vec2& origin, int direction, int frame, int clip, CrowdInstance& out);
+
+    // origin: a Pack-nél használt pont (jellemzően a kamera közepe)
+    void Draw(const std::vector<CrowdInstance>& instances, const glm::vec2& origin, const glm::vec2& spriteSize,
+        const Texture& sheet, const glm::mat4& projection, const glm::mat4& view);
+
+    // a szereplők mélysége a láb csempéjének átlójából (IsoGrid::GetSpriteDepthParams)
+    void SetSpriteDepth(const IsoGrid::SpriteDepthParams& params) { spriteDepth = params; }
+
+    size_t GetLastUploadBytes() const { return lastUploadBytes; }
+    int GetClipCount() const { return static_cast<int>(uvTable.size() / (kDirections * kMaxFrames)); }
+
+private:
+    Shader& shader;
+    GLVertexArray vao;
+    GLBuffer quadVBO, instanceVBO;
+    GLBuffer tableBuffer;
+    GLTexture tableTexture;
+    size_t instanceCapacity = 0;
+    size_t lastUploadBytes = 0;
+    IsoGrid::SpriteDepthParams spriteDepth;
+
+    std::vector<glm::vec4> uvTable;     // [klip][irány][képkocka]
+    bool tableDirty = false;
+
+    void InitRenderData();
+    void UploadTable();
+};
@@ -0,0 +1,148 @@
+﻿#include "DynamicResolution.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+DynamicResolution::DynamicResolution(Shader& upscaleShader, int windowWidth, int windowHeight, const Settings& settings)
+    : shader(upscaleShader), settings(settings),
+    windowWidth(windowWidth), windowHeight(windowHeight),
+    scale(settings.maxScale)
+{
+    // a target mindig a legnagyobb skálához foglalt; kisebb skálán csak a bal-alsó részét használjuk,
+    // így skálaváltáskor nincs újrafoglalás
+    colorTexture = GLTexture::Create();
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, windowWidth, windowHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    depthRenderbuffer = GLRenderbuffer::Create();
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, windowWidth, windowHeight);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    fbo = GLFramebuffer::Create();
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    valid = (status == GL_FRAMEBUFFER_COMPLETE);
+    if (!valid)
+        std::cerr << "Dynamic resolution framebuffer incomplete: 0x" << std::hex << status << std::dec
+            << " (rendering at native resolution)" << std::endl;
+
+    vao = GLVertexArray::Create();
+    for (GLQuery& query : timerQueries)
+        query = GLQuery::Create();
+}
+
+int DynamicResolution::SceneWidth() const
+{
+    return std::max(1, static_cast<int>(std::lround(windowWidth * scale)));
+}
+
+int DynamicResolution::SceneHeight() const
+{
+    return std::max(1, static_cast<int>(std::lround(windowHeight * scale)));
+}
+
+void DynamicResolution::BeginScene(float clearR, float clearG, float clearB)
+{
+    if (!valid)
+        return;
+
+    CollectGpuTime();
+    UpdateScale();
+
+    glBeginQuery(GL_TIME_ELAPSED, timerQueries[queryIndex]);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, SceneWidth(), SceneHeight());
+    glClearColor(clearR, clearG, clearB, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void DynamicResolution::EndScene()
+{
+    if (!valid)
+        return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    queryIssued[queryIndex] = true;
+    queryIndex = (queryIndex + 1) % kQueryCount;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, windowWidth, windowHeight);
+
+    // teljes képernyős háromszög; a forrás a target (0,0)-(scale,scale) része
+    const GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    const GLboolean blend = glIsEnabled(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+
+    shader.Use();
+    shader.SetInt("scene", 0);
+    shader.SetVec2("sourceSize", glm::vec2(static_cast<float>(SceneWidth()), static_cast<float>(SceneHeight())));
+    shader.SetVec2("textureSize", glm::vec2(static_cast<float>(windowWidth), static_cast<float>(windowHeight)));
+    shader.SetVec2("outputSize", glm::vec2(static_cast<float>(windowWidth), static_cast<float>(windowHeight)));
+    shader.SetInt("sharpBilinear", filter == UpscaleFilter::SharpBilinear ? 1 : 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    if (depthTest) glEnable(GL_DEPTH_TEST);
+    if (blend) glEnable(GL_BLEND);
+}
+
+void DynamicResolution::CollectGpuTime()
+{
+    // a most újrahasznosítandó query a legrégebbi; ha még nincs kész, kihagyjuk (nem várunk rá)
+    if (!queryIssued[queryIndex])
+        return;
+
+    GLuint available = 0;
+    glGetQueryObjectuiv(timerQueries[queryIndex], GL_QUERY_RESULT_AVAILABLE, &available);
+    queryIssued[queryIndex] = false;
+    if (!available)
+        return;
+
+    GLuint64 elapsedNs = 0;
+    glGetQueryObjectui64v(timerQueries[queryIndex], GL_QUERY_RESULT, &elapsedNs);
+    const float gpuMs = static_cast<float>(elapsedNs) * 1e-6f;
+
+    averageGpuMs = hasAverage ? averageGpuMs + (gpuMs - averageGpuMs) * settings.smoothing : gpuMs;
+    hasAverage = true;
+}
+
+void DynamicResolution::UpdateScale()
+{
+    ++framesSinceChange;
+    if (!hasAverage || framesSinceChange < settings.cooldownFrames)
+        return;
+
+    float newScale = scale;
+    if (averageGpuMs > settings.budgetMs)
+        newScale = std::max(settings.minScale, scale - settings.scaleStep);
+    else if (averageGpuMs < settings.budgetMs * settings.lowerThreshold)
+        newScale = std::min(settings.maxScale, scale + settings.scaleStep);
+
+    if (std::abs(newScale - scale) < 1e-4f)
+        return;
+
+    std::cout << "Dynamic resolution: scale " << scale << " -> " << newScale
+        << " (" << static_cast<int>(std::lround(windowWidth * newScale)) << "x"
+        << static_cast<int>(std::lround(windowHeight * newScale))
+        << ", GPU " << averageGpuMs << " ms, budget " << settings.budgetMs << " ms)" << std::endl;
+
+    scale = newScale;
+    framesSinceChange = 0;
+}
@@ -0,0 +1,67 @@
+﻿#pragma once
+#include "Shader.h"
+
+// A világ és a sprite-ok egy offscreen framebufferbe kerülnek, aminek a felbontását a mért
+// GPU-idő alapján egy egyszerű szabályzó állítja; a végén a kép az ablakra nagyítódik
+// (nearest vagy sharp-bilinear, hogy a pixel-art éles maradjon). A UI ezután natívan rajzol.
+class DynamicResolution
+{
+public:
+    enum class UpscaleFilter { Nearest, SharpBilinear };
+
+    struct Settings
+    {
+        float budgetMs = 14.0f;       // cél GPU-idő a jelenetre
+        float minScale = 0.5f;
+        float maxScale = 1.0f;
+        float scaleStep = 0.05f;
+        float lowerThreshold = 0.80f; // budget * ez alatt lehet felskálázni
+        float smoothing = 0.1f;       // a mért idő exponenciális átlaga
+        int cooldownFrames = 30;      // két váltás között eltelt minimum képkocka
+    };
+
+    DynamicResolution(Shader& upscaleShader, int windowWidth, int windowHeight, const Settings& settings);
+    DynamicResolution(Shader& upscaleShader, int windowWidth, int windowHeight)
+        : DynamicResolution(upscaleShader, windowWidth, windowHeight, Settings()) {}
+
+    DynamicResolution(const DynamicResolution&) = delete;
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+    // a jelenet az offscreen targetbe (a skálázott viewporttal), színnel és mélységgel törölve
+    void BeginScene(float clearR, float clearG, float clearB);
+    // vissza az ablakra, nagyítás; utána a UI natív felbontáson rajzolhat
+    void EndScene();
+
+    float GetScale() const { return scale; }
+    float GetAverageGpuMs() const { return averageGpuMs; }
+
+    UpscaleFilter GetFilter() const { return filter; }
+    void SetFilter(UpscaleFilter f) { filter = f; }
+
+private:
+    static constexpr int kQueryCount = 3;   // ennyi képkocka késéssel olvassuk a GPU időt (nincs várakozás)
+
+    Shader& shader;
+    Settings settings;
+    int windowWidth, windowHeight;
+    float scale;
+    UpscaleFilter filter = UpscaleFilter::SharpBilinear;
+
+    GLFramebuffer fbo;
+    GLTexture colorTexture;
+    GLRenderbuffer depthRenderbuffer;
+    GLVertexArray vao;
+    bool valid = false;
+
+    GLQuery timerQueries[kQueryCount];
+    bool queryIssued[kQueryCount] = {};
+    int queryIndex = 0;
+    float averageGpuMs = 0.0f;
+    bool hasAverage = false;
+    int framesSinceChange = 0;
+
+    int SceneWidth() const;
+    int SceneHeight() const;
+    void CollectGpuTime();
+    void UpdateScale();
+};
@@ -0,0 +1,365 @@
+﻿#include "GLBackend.h"
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+namespace
+{
+    enum FunctionId : size_t
+    {
+#define GL_FUNCTION(ret, name, params, args) Id_##name,
+#include "GLFunctions.inl"
+#undef GL_FUNCTION
+        FunctionCount
+    };
+
+    constexpr const char* kFunctionNames[FunctionCount] = {
+#define GL_FUNCTION(ret, name, params, args) #name,
+#include "GLFunctions.inl"
+#undef GL_FUNCTION
+    };
+
+    // GL_COMPLETION_STATUS_KHR (KHR_parallel_shader_compile): a null fordítás azonnal kész
+    constexpr GLenum kCompletionStatus = 0x91B1;
+
+    GLBackend::Kind installedKind = GLBackend::Kind::OpenGL;
+    bool driverCaptured = false;
+    GLFunctionTable driverTable;
+    GLFunctionTable nullTable;      // a rögzítő backend is ide továbbít
+
+    // --- Null backend állapota
+    GLuint nextObjectName = 1;
+    std::vector<unsigned char> mappedScratch;
+
+    // --- Rögzítő backend állapota
+    std::array<size_t, FunctionCount> callCounts = {};
+    std::vector<std::string> callLog;
+    bool logCalls = true;
+    FunctionId loggedFunction = FunctionCount;
+
+    template <typename T>
+    T NullResult()
+    {
+        if constexpr (!std::is_void_v<T>)
+            return T{};
+    }
+
+    // Általános null függvények: nem csinálnak semmit, 0 / nullptr az eredmény
+#define GL_FUNCTION(ret, name, params, args) ret APIENTRY Null_##name params { return NullResult<ret>(); }
+#include "GLFunctions.inl"
+#undef GL_FUNCTION
+
+    // Ahol a hívó a választ felhasználja, ott a sikeres ág kell
+    void APIENTRY NullGenNames(GLsizei n, GLuint* names)
+    {
+        for (GLsizei i = 0; i < n; ++i)
+            names[i] = nextObjectName++;
+    }
+
+    GLuint APIENTRY NullCreateShader(GLenum)
+    {
+        return nextObjectName++;
+    }
+
+    GLuint APIENTRY NullCreateProgram()
+    {
+        return nextObjectName++;
+    }
+
+    void APIENTRY NullGetShaderiv(GLuint, GLenum pname, GLint* params)
+    {
+        *params = (pname == GL_COMPILE_STATUS || pname == kCompletionStatus) ? GL_TRUE : 0;
+    }
+
+    void APIENTRY NullGetProgramiv(GLuint, GLenum pname, GLint* params)
+    {
+        *params = (pname == GL_LINK_STATUS || pname == kCompletionStatus) ? GL_TRUE : 0;
+    }
+
+    void APIENTRY NullGetIntegerv(GLenum pname, GLint* data)
+    {
+        const int count = pname == GL_VIEWPORT ? 4 : 1;
+        for (int i = 0; i < count; ++i)
+            data[i] = 0;
+    }
+
+    void APIENTRY NullGetFloatv(GLenum pname, GLfloat* data)
+    {
+        const int count = pname == GL_COLOR_CLEAR_VALUE ? 4 : 1;
+        for (int i = 0; i < count; ++i)
+            data[i] = 0.0f;
+    }
+
+    const GLubyte* APIENTRY NullGetString(GLenum name)
+    {
+        const char* value = name == GL_VERSION ? "3.3 (null backend)" : "Null";
+        return reinterpret_cast<const GLubyte*>(value);
+    }
+
+    const GLubyte* APIENTRY NullGetStringi(GLenum, GLuint)
+    {
+        return reinterpret_cast<const GLubyte*>("");
+    }
+
+    GLenum APIENTRY NullCheckFramebufferStatus(GLenum)
+    {
+        return GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    void APIENTRY NullGetQueryObjectuiv(GLuint, GLenum, GLuint* params)
+    {
+        *params = GL_TRUE;     // GL_QUERY_RESULT_AVAILABLE: az eredmény (0 ns) mindig kész
+    }
+
+    void APIENTRY NullGetQueryObjectui64v(GLuint, GLenum, GLuint64* params)
+    {
+        *params = 0;
+    }
+
+    void* APIENTRY NullMapBufferRange(GLenum, GLintptr, GLsizeiptr length, GLbitfield)
+    {
+        // a feltöltés CPU-oldali része (a másolás a leképezett tárba) így is mérhető
+        if (mappedScratch.size() < static_cast<size_t>(length))
+            mappedScratch.resize(static_cast<size_t>(length));
+        return mappedScratch.data();
+    }
+
+    GLboolean APIENTRY NullUnmapBuffer(GLenum)
+    {
+        return GL_TRUE;
+    }
+
+    GLFunctionTable MakeNullTable()
+    {
+        GLFunctionTable table;
+#define GL_FUNCTION(ret, name, params, args) table.name##Ptr = &Null_##name;
+#include "GLFunctions.inl"
+#undef GL_FUNCTION
+        table.glGenBuffersPtr = &NullGenNames;
+        table.glGenFramebuffersPtr = &NullGenNames;
+        table.glGenQueriesPtr = &NullGenNames;
+        table.glGenRenderbuffersPtr = &NullGenNames;
+        table.glGenTexturesPtr = &NullGenNames;
+        table.glGenVertexArraysPtr = &NullGenNames;
+        table.glCreateShaderPtr = &NullCreateShader;
+        table.glCreateProgramPtr = &NullCreateProgram;
+        table.glGetShaderivPtr = &NullGetShaderiv;
+        table.glGetProgramivPtr = &NullGetProgramiv;
+        table.glGetIntegervPtr = &NullGetIntegerv;
+        table.glGetFloatvPtr = &NullGetFloatv;
+        table.glGetStringPtr = &NullGetString;
+        table.glGetStringiPtr = &NullGetStringi;
+        table.glCheckFramebufferStatusPtr = &NullCheckFramebufferStatus;
+        table.glGetQueryObjectuivPtr = &NullGetQueryObjectuiv;
+        table.glGetQueryObjectui64vPtr = &NullGetQueryObjectui64v;
+        table.glMapBufferRangePtr = &NullMapBufferRange;
+        table.glUnmapBufferPtr = &NullUnmapBuffer;
+        return table;
+    }
+
+    // --- Rögzítés: "glName(arg, arg...)" soronként. A mutatók tartalma nem kerül a naplóba
+    // (csak hogy van-e), kivéve a szövegeket (uniform-nevek); a lebegőpontos értékek a
+    // legrövidebb visszaolvasható alakban, így a napló gépfüggetlenül összevethető.
+    template <typename T>
+    void AppendArgument(std::string& line, T value, bool& first)
+    {
+        if (!first)
+            line += ", ";
+        first = false;
+
+        if constexpr (std::is_pointer_v<T>) {
+            // csak a bemenő szöveg: a kimenő puffer (pl. info log) itt még nincs kitöltve
+            if constexpr (std::is_same_v<std::remove_pointer_t<T>, const GLchar>) {
+                if (value) {
+                    line += '"';
+                    line += value;
+                    line += '"';
+                }
+                else {
+                    line += '0';
+                }
+            }
+            else {
+                line += value ? "&" : "0";
+            }
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            char buffer[32];
+            const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            line.append(buffer, result.ptr);
+        }
+        else if constexpr (std::is_signed_v<T>) {
+            line += std::to_string(static_cast<long long>(value));
+        }
+        else {
+            line += std::to_string(static_cast<unsigned long long>(value));
+        }
+    }
+
+    template <typename... Args>
+    void LogArguments(Args... values)
+    {
+        std::string line = kFunctionNames[loggedFunction];
+        line += '(';
+        [[maybe_unused]] bool first = true;   // argumentum nélküli hívásnál nincs használva
+        (AppendArgument(line, values, first), ...);
+        line += ')';
+        callLog.push_back(std::move(line));
+    }
+
+    // true: a hívás argumentumait is naplózni kell
+    bool CountCall(FunctionId function)
+    {
+        ++callCounts[function];
+        loggedFunction = function;
+        return logCalls;
+    }
+
+#define GL_FUNCTION(ret, name, params, args) \
+    ret APIENTRY Record_##name params \
+    { \
+        if (CountCall(Id_##name)) \
+            LogArguments args; \
+        return nullTable.name##Ptr args; \
+    }
+#include "GLFunctions.inl"
+#undef GL_FUNCTION
+
+    GLFunctionTable MakeRecordingTable()
+    {
+        GLFunctionTable table;
+#define GL_FUNCTION(ret, name, params, args) table.name##Ptr = &Record_##name;
+#include "GLFunctions.inl"
+#undef GL_FUNCTION
+        return table;
+    }
+}
+
+GLFunctionTable GLFunctionTable::Capture()
+{
+    GLFunctionTable table;
+#define GL_FUNCTION(ret, name, params, args) table.name##Ptr = glad_##name;
+#include "GLFunctions.inl"
+#undef GL_FUNCTION
+    return table;
+}
+
+void GLFunctionTable::Apply() const
+{
+#define GL_FUNCTION(ret, name, params, args) glad_##name = name##Ptr;
+#include "GLFunctions.inl"
+#undef GL_FUNCTION
+}
+
+bool GLBackend::Install(Kind kind, GLADloadproc loader)
+{
+    switch (kind)
+    {
+    case Kind::OpenGL:
+        if (!driverCaptured) {
+            if (!loader || !gladLoadGLLoader(loader)) {
+                std::cerr << "Failed to load the OpenGL functions" << std::endl;
+                return false;
+            }
+            driverTable = GLFunctionTable::Capture();
+            driverCaptured = true;
+        }
+        driverTable.Apply();
+        break;
+    case Kind::Null:
+        nullTable = MakeNullTable();
+        nullTable.Apply();
+        break;
+    case Kind::Recording:
+        nullTable = MakeNullTable();
+        MakeRecordingTable().Apply();
+        ResetRecording();
+        break;
+    }
+    installedKind = kind;
+    return true;
+}
+
+GLBackend::Kind GLBackend::GetKind()
+{
+    return installedKind;
+}
+
+void GLBackend::ResetRecording()
+{
+    callCounts.fill(0);
+    callLog.clear();
+}
+
+void GLBackend::SetLogCalls(bool enabled)
+{
+    logCalls = enabled;
+}
+
+size_t GLBackend::GetCallCount(std::string_view function)
+{
+    for (size_t i = 0; i < FunctionCount; ++i) {
+        if (function == kFunctionNames[i])
+            return callCounts[i];
+    }
+    return 0;
+}
+
+size_t GLBackend::GetTotalCallCount()
+{
+    size_t total = 0;
+    for (size_t count : callCounts)
+        total += count;
+    return total;
+}
+
+const std::vector<std::string>& GLBackend::GetCallLog()
+{
+    return callLog;
+}
+
+bool GLBackend::SaveCallLog(const std::string& path)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to write GL call log: " << path << std::endl;
+        return false;
+    }
+    for (const std::string& line : callLog)
+        file << line << '\n';
+    return static_cast<bool>(file);
+}
+
+bool GLBackend::MatchesCallLog(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open GL call log: " << path << std::endl;
+        return false;
+    }
+
+    std::string expected;
+    size_t line = 0;
+    for (; std::getline(file, expected); ++line) {
+        if (!expected.empty() && expected.back() == '\r')
+            expected.pop_back();
+        if (line >= callLog.size()) {
+            std::cerr << "GL call log mismatch at line " << line + 1 << ": expected " << expected
+                << ", recording ended" << std::endl;
+            return false;
+        }
+        if (callLog[line] != expected) {
+            std::cerr << "GL call log mismatch at line " << line + 1 << ": expected " << expected
+                << ", got " << callLog[line] << std::endl;
+            return false;
+        }
+    }
+    if (line != callLog.size()) {
+        std::cerr << "GL call log mismatch at line " << line + 1 << ": expected end of log, got "
+            << callLog[line] << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A GLFunctions.inl-ben felsorolt glad függvénymutatók pillanatképe
+struct GLFunctionTable
+{
+#define GL_FUNCTION(ret, name, params, args) decltype(glad_##name) name##Ptr = nullptr;
+#include "GLFunctions.inl"
+#undef GL_FUNCTION
+
+    static GLFunctionTable Capture();   // a jelenleg telepített mutatók
+    void Apply() const;                 // visszaírja őket a glad-ba
+};
+
+// A renderer osztályok (IsoRenderer, SpriteRenderer, UIRenderer, Shader, Texture...) a glad
+// függvénymutatóin át hívják a GL-t; a backend ezeket a mutatókat cseréli, így a hívó kód
+// változatlan marad, és a valódi backendnél nincs plusz indirekció.
+//
+//   OpenGL:    a driver (gladLoadGLLoader)
+//   Null:      minden hívás no-op, GPU és kontextus nélkül is fut. A név-generálók egyedi
+//              neveket adnak, a fordítás/linkelés/framebuffer sikeres, a leképezett puffer
+//              egy CPU-oldali átmeneti tár: a képkocka-összeállítás CPU-költsége mérhető.
+//   Recording: mint a Null, de minden hívást számol és (ha kell) naplóz: hívásszám-ellenőrzéshez
+//              és "golden" összevetéshez.
+// Csak a fő (GL) szálról, GL-hívások között váltható.
+class GLBackend
+{
+public:
+    enum class Kind { OpenGL, Null, Recording };
+
+    // OpenGL-hez kell a loader (pl. glfwGetProcAddress); a driver mutatói megmaradnak,
+    // így később vissza lehet rájuk váltani
+    static bool Install(Kind kind, GLADloadproc loader = nullptr);
+    static Kind GetKind();
+
+    // --- Recording backend
+    static void ResetRecording();
+    static void SetLogCalls(bool enabled);      // alapból be; benchmarkhoz ki (csak számlálás)
+    static size_t GetCallCount(std::string_view function);
+    static size_t GetTotalCallCount();
+    static const std::vector<std::string>& GetCallLog();
+
+    static bool SaveCallLog(const std::string& path);
+    // a napló soronkénti összevetése egy mentett naplóval; az első eltérést kiírja
+    static bool MatchesCallLog(const std::string& path);
+};
@@ -0,0 +1,90 @@
+﻿// A renderer által használt GL belépési pontok X-makró listája (a glad.h típusaiból):
+//     GL_FUNCTION(visszatérési típus, név, (paraméterek), (argumentumok))
+// A GLBackend (null / rögzítő backend) és a GLStats (hívás-statisztika) ezen át cseréli le
+// a glad függvénymutatóit.
+// Új GL-hívás bevezetésekor ide is fel kell venni: a listán kívüli függvényt a null backend
+// nem pótolja (GPU nélkül nullptr marad), és a rögzítő backend meg a GLStats sem látja.
+
+GL_FUNCTION(void, glActiveTexture, (GLenum texture), (texture))
+GL_FUNCTION(void, glAttachShader, (GLuint program, GLuint shader), (program, shader))
+GL_FUNCTION(void, glBeginQuery, (GLenum target, GLuint id), (target, id))
+GL_FUNCTION(void, glBindBuffer, (GLenum target, GLuint buffer), (target, buffer))
+GL_FUNCTION(void, glBindFramebuffer, (GLenum target, GLuint framebuffer), (target, framebuffer))
+GL_FUNCTION(void, glBindRenderbuffer, (GLenum target, GLuint renderbuffer), (target, renderbuffer))
+GL_FUNCTION(void, glBindTexture, (GLenum target, GLuint texture), (target, texture))
+GL_FUNCTION(void, glBindVertexArray, (GLuint array), (array))
+GL_FUNCTION(void, glBlendFunc, (GLenum sfactor, GLenum dfactor), (sfactor, dfactor))
+GL_FUNCTION(void, glBufferData, (GLenum target, GLsizeiptr size, const void *data, GLenum usage), (target, size, data, usage))
+GL_FUNCTION(void, glBufferSubData, (GLenum target, GLintptr offset, GLsizeiptr size, const void *data), (target, offset, size, data))
+GL_FUNCTION(GLenum, glCheckFramebufferStatus, (GLenum target), (target))
+GL_FUNCTION(void, glClear, (GLbitfield mask), (mask))
+GL_FUNCTION(void, glClearColor, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha), (red, green, blue, alpha))
+GL_FUNCTION(void, glClearDepth, (GLdouble depth), (depth))
+GL_FUNCTION(void, glCompileShader, (GLuint shader), (shader))
+GL_FUNCTION(GLuint, glCreateProgram, (void), ())
+GL_FUNCTION(GLuint, glCreateShader, (GLenum type), (type))
+GL_FUNCTION(void, glDeleteBuffers, (GLsizei n, const GLuint *buffers), (n, buffers))
+GL_FUNCTION(void, glDeleteFramebuffers, (GLsizei n, const GLuint *framebuffers), (n, framebuffers))
+GL_FUNCTION(void, glDeleteProgram, (GLuint program), (program))
+GL_FUNCTION(void, glDeleteQueries, (GLsizei n, const GLuint *ids), (n, ids))
+GL_FUNCTION(void, glDeleteRenderbuffers, (GLsizei n, const GLuint *renderbuffers), (n, renderbuffers))
+GL_FUNCTION(void, glDeleteShader, (GLuint shader), (shader))
+GL_FUNCTION(void, glDeleteTextures, (GLsizei n, const GLuint *textures), (n, textures))
+GL_FUNCTION(void, glDeleteVertexArrays, (GLsizei n, const GLuint *arrays), (n, arrays))
+GL_FUNCTION(void, glDepthFunc, (GLenum func), (func))
+GL_FUNCTION(void, glDepthMask, (GLboolean flag), (flag))
+GL_FUNCTION(void, glDetachShader, (GLuint program, GLuint shader), (program, shader))
+GL_FUNCTION(void, glDisable, (GLenum cap), (cap))
+GL_FUNCTION(void, glDrawArrays, (GLenum mode, GLint first, GLsizei count), (mode, first, count))
+GL_FUNCTION(void, glDrawArraysInstanced, (GLenum mode, GLint first, GLsizei count, GLsizei instancecount), (mode, first, count, instancecount))
+GL_FUNCTION(void, glEnable, (GLenum cap), (cap))
+GL_FUNCTION(void, glEnableVertexAttribArray, (GLuint index), (index))
+GL_FUNCTION(void, glEndQuery, (GLenum target), (target))
+GL_FUNCTION(void, glFramebufferRenderbuffer, (GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer), (target, attachment, renderbuffertarget, renderbuffer))
+GL_FUNCTION(void, glFramebufferTexture2D, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level), (target, attachment, textarget, texture, level))
+GL_FUNCTION(void, glGenBuffers, (GLsizei n, GLuint *buffers), (n, buffers))
+GL_FUNCTION(void, glGenFramebuffers, (GLsizei n, GLuint *framebuffers), (n, framebuffers))
+GL_FUNCTION(void, glGenQueries, (GLsizei n, GLuint *ids), (n, ids))
+GL_FUNCTION(void, glGenRenderbuffers, (GLsizei n, GLuint *renderbuffers), (n, renderbuffers))
+GL_FUNCTION(void, glGenTextures, (GLsizei n, GLuint *textures), (n, textures))
+GL_FUNCTION(void, glGenVertexArrays, (GLsizei n, GLuint *arrays), (n, arrays))
+GL_FUNCTION(GLenum, glGetError, (void), ())
+GL_FUNCTION(void, glGetFloatv, (GLenum pname, GLfloat *data), (pname, data))
+GL_FUNCTION(void, glGetIntegerv, (GLenum pname, GLint *data), (pname, data))
+GL_FUNCTION(void, glGetProgramBinary, (GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary), (program, bufSize, length, binaryFormat, binary))
+GL_FUNCTION(void, glGetProgramInfoLog, (GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog), (program, bufSize, length, infoLog))
+GL_FUNCTION(void, glGetProgramiv, (GLuint program, GLenum pname, GLint *params), (program, pname, params))
+GL_FUNCTION(void, glGetQueryObjectui64v, (GLuint id, GLenum pname, GLuint64 *params), (id, pname, params))
+GL_FUNCTION(void, glGetQueryObjectuiv, (GLuint id, GLenum pname, GLuint *params), (id, pname, params))
+GL_FUNCTION(void, glGetShaderInfoLog, (GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog), (shader, bufSize, length, infoLog))
+GL_FUNCTION(void, glGetShaderiv, (GLuint shader, GLenum pname, GLint *params), (shader, pname, params))
+GL_FUNCTION(const GLubyte*, glGetString, (GLenum name), (name))
+GL_FUNCTION(const GLubyte*, glGetStringi, (GLenum name, GLuint index), (name, index))
+GL_FUNCTION(GLint, glGetUniformLocation, (GLuint program, const GLchar *name), (program, name))
+GL_FUNCTION(GLboolean, glIsEnabled, (GLenum cap), (cap))
+GL_FUNCTION(void, glLineWidth, (GLfloat width), (width))
+GL_FUNCTION(void, glLinkProgram, (GLuint program), (program))
+GL_FUNCTION(void*, glMapBufferRange, (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access), (target, offset, length, access))
+GL_FUNCTION(void, glPixelStorei, (GLenum pname, GLint param), (pname, param))
+GL_FUNCTION(void, glProgramBinary, (GLuint program, GLenum binaryFormat, const void *binary, GLsizei length), (program, binaryFormat, binary, length))
+GL_FUNCTION(void, glProgramParameteri, (GLuint program, GLenum pname, GLint value), (program, pname, value))
+GL_FUNCTION(void, glRenderbufferStorage, (GLenum target, GLenum internalformat, GLsizei width, GLsizei height), (target, internalformat, width, height))
+GL_FUNCTION(void, glShaderSource, (GLuint shader, GLsizei count, const GLchar *const*string, const GLint *length), (shader, count, string, length))
+GL_FUNCTION(void, glTexBuffer, (GLenum target, GLenum internalformat, GLuint buffer), (target, internalformat, buffer))
+GL_FUNCTION(void, glTexImage2D, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels), (target, level, internalformat, width, height, border, format, type, pixels))
+GL_FUNCTION(void, glTexParameteri, (GLenum target, GLenum pname, GLint param), (target, pname, param))
+GL_FUNCTION(void, glTexSubImage2D, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels), (target, level, xoffset, yoffset, width, height, format, type, pixels))
+GL_FUNCTION(void, glUniform1f, (GLint location, GLfloat v0), (location, v0))
+GL_FUNCTION(void, glUniform1i, (GLint location, GLint v0), (location, v0))
+GL_FUNCTION(void, glUniform2fv, (GLint location, GLsizei count, const GLfloat *value), (location, count, value))
+GL_FUNCTION(void, glUniform3f, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2), (location, v0, v1, v2))
+GL_FUNCTION(void, glUniform3fv, (GLint location, GLsizei count, const GLfloat *value), (location, count, value))
+GL_FUNCTION(void, glUniform4f, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3), (location, v0, v1, v2, v3))
+GL_FUNCTION(void, glUniform4fv, (GLint location, GLsizei count, const GLfloat *value), (location, count, value))
+GL_FUNCTION(void, glUniformMatrix4fv, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value))
+GL_FUNCTION(GLboolean, glUnmapBuffer, (GLenum target), (target))
+GL_FUNCTION(void, glUseProgram, (GLuint program), (program))
+GL_FUNCTION(void, glVertexAttribDivisor, (GLuint index, GLuint divisor), (index, divisor))
+GL_FUNCTION(void, glVertexAttribIPointer, (GLuint index, GLint size, GLenum type, GLsizei stride, const void *pointer), (index, size, type, stride, pointer))
+GL_FUNCTION(void, glVertexAttribPointer, (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer), (index, size, type, normalized, stride, pointer))
+GL_FUNCTION(void, glViewport, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height))
@@ -0,0 +1,146 @@
+﻿#include "GLHandle.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    constexpr int kTypeCount = static_cast<int>(GLObjectType::Count);
+
+    size_t liveCounts[kTypeCount] = {};
+    size_t doubleDeletes = 0;
+
+#ifdef RAVENS_TRACK_GL_OBJECTS
+    // típusonként néhány tucat élő név: a lineáris keresés elég
+    std::vector<GLuint>& LiveNames(GLObjectType type)
+    {
+        static std::vector<GLuint> names[kTypeCount];
+        return names[static_cast<int>(type)];
+    }
+#endif
+}
+
+GLuint GLObjectTracker::Generate(GLObjectType type)
+{
+    GLuint name = 0;
+    switch (type) {
+    case GLObjectType::Buffer:       glGenBuffers(1, &name); break;
+    case GLObjectType::VertexArray:  glGenVertexArrays(1, &name); break;
+    case GLObjectType::Texture:      glGenTextures(1, &name); break;
+    case GLObjectType::Renderbuffer: glGenRenderbuffers(1, &name); break;
+    case GLObjectType::Framebuffer:  glGenFramebuffers(1, &name); break;
+    case GLObjectType::Query:        glGenQueries(1, &name); break;
+    case GLObjectType::Program:      name = glCreateProgram(); break;
+    default: break;
+    }
+    return name;
+}
+
+void GLObjectTracker::Delete(GLObjectType type, GLuint name)
+{
+    OnDelete(type, name);
+    switch (type) {
+    case GLObjectType::Buffer:       glDeleteBuffers(1, &name); break;
+    case GLObjectType::VertexArray:  glDeleteVertexArrays(1, &name); break;
+    case GLObjectType::Texture:      glDeleteTextures(1, &name); break;
+    case GLObjectType::Renderbuffer: glDeleteRenderbuffers(1, &name); break;
+    case GLObjectType::Framebuffer:  glDeleteFramebuffers(1, &name); break;
+    case GLObjectType::Query:        glDeleteQueries(1, &name); break;
+    case GLObjectType::Program:      glDeleteProgram(name); break;
+    default: break;
+    }
+}
+
+void GLObjectTracker::OnCreate(GLObjectType type, GLuint name)
+{
+    if (name == 0)
+        return;
+    ++liveCounts[static_cast<int>(type)];
+#ifdef RAVENS_TRACK_GL_OBJECTS
+    LiveNames(type).push_back(name);
+#endif
+}
+
+void GLObjectTracker::OnDelete(GLObjectType type, GLuint name)
+{
+    if (name == 0)
+        return;
+#ifdef RAVENS_TRACK_GL_OBJECTS
+    // a GL egy már törölt nevet csendben figyelmen kívül hagy (vagy egy azóta újra kiadottat
+    // töröl): itt derül ki
+    std::vector<GLuint>& names = LiveNames(type);
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it == names.end()) {
+        ++doubleDeletes;
+        std::cerr << "GL " << GetTypeName(type) << " " << name << " deleted twice (or never tracked)" << std::endl;
+        return;
+    }
+    *it = names.back();
+    names.pop_back();
+#endif
+    size_t& count = liveCounts[static_cast<int>(type)];
+    if (count == 0) {
+        ++doubleDeletes;
+        return;
+    }
+    --count;
+}
+
+size_t GLObjectTracker::GetLiveCount(GLObjectType type)
+{
+    return liveCounts[static_cast<int>(type)];
+}
+
+size_t GLObjectTracker::GetTotalLiveCount()
+{
+    size_t total = 0;
+    for (size_t count : liveCounts)
+        total += count;
+    return total;
+}
+
+size_t GLObjectTracker::GetDoubleDeleteCount()
+{
+    return doubleDeletes;
+}
+
+const char* GLObjectTracker::GetTypeName(GLObjectType type)
+{
+    switch (type) {
+    case GLObjectType::Buffer:       return "buffer";
+    case GLObjectType::VertexArray:  return "vertex array";
+    case GLObjectType::Texture:      return "texture";
+    case GLObjectType::Renderbuffer: return "renderbuffer";
+    case GLObjectType::Framebuffer:  return "framebuffer";
+    case GLObjectType::Query:        return "query";
+    case GLObjectType::Program:      return "program";
+    default:                         return "?";
+    }
+}
+
+bool GLObjectTracker::ReportLeaks()
+{
+    const size_t live = GetTotalLiveCount();
+    if (live == 0 && doubleDeletes == 0)
+        return true;
+
+    if (live > 0)
+        std::cerr << "GL objects leaked at shutdown: " << live << std::endl;
+    for (int i = 0; i < kTypeCount; ++i) {
+        const GLObjectType type = static_cast<GLObjectType>(i);
+        if (liveCounts[i] == 0)
+            continue;
+        std::cerr << "   " << GetTypeName(type) << ": " << liveCounts[i];
+#ifdef RAVENS_TRACK_GL_OBJECTS
+        std::cerr << " (";
+        const std::vector<GLuint>& names = LiveNames(type);
+        for (size_t n = 0; n < names.size(); ++n)
+            std::cerr << (n ? ", " : "") << names[n];
+        std::cerr << ")";
+#endif
+        std::cerr << std::endl;
+    }
+    if (doubleDeletes > 0)
+        std::cerr << "GL objects deleted twice: " << doubleDeletes << std::endl;
+    return false;
+}
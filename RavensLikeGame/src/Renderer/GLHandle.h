@@ -0,0 +1,113 @@
+﻿#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+
+// Debug buildben alapból be; release-ben a RAVENS_TRACK_GL_OBJECTS definiálásával kérhető
+#if defined(_DEBUG) && !defined(RAVENS_TRACK_GL_OBJECTS)
+#define RAVENS_TRACK_GL_OBJECTS 1
+#endif
+
+enum class GLObjectType
+{
+    Buffer,
+    VertexArray,
+    Texture,
+    Renderbuffer,
+    Framebuffer,
+    Query,
+    Program,
+    Count
+};
+
+// Élő GL-objektumok nyilvántartása típusonként. A darabszám mindig számolódik; a nevek
+// listája (dupla törlés, ismeretlen név törlése, a szivárgott nevek kiírása) csak
+// RAVENS_TRACK_GL_OBJECTS mellett. Csak a fő (GL) szálról.
+class GLObjectTracker
+{
+public:
+    // glGen* / glCreateProgram és glDelete*, típus szerint (a GLHandle hívja)
+    static GLuint Generate(GLObjectType type);
+    static void Delete(GLObjectType type, GLuint name);
+
+    static void OnCreate(GLObjectType type, GLuint name);
+    static void OnDelete(GLObjectType type, GLuint name);
+
+    static size_t GetLiveCount(GLObjectType type);
+    static size_t GetTotalLiveCount();
+    static size_t GetDoubleDeleteCount();
+    static const char* GetTypeName(GLObjectType type);
+
+    // leállításkor, az összes tulajdonos megszűnése után: a még élő objektumokat és a dupla
+    // törléseket kiírja; hiba nélkül true
+    static bool ReportLeaks();
+};
+
+// Egy GL-objektum kizárólagos tulajdonosa: mozgatható, nem másolható, a destruktor törli.
+// A név GLuint-ként olvasható (glBindTexture(GL_TEXTURE_2D, texture)), így a hívó kód a GL
+// függvényeket változatlanul hívja; a tulajdonjog csak a Create-tel, az átvevő
+// konstruktorral (máshol létrehozott név, pl. TextureImporter::Upload) és a mozgatással vándorol.
+template<GLObjectType Type>
+class GLHandle
+{
+public:
+    GLHandle() = default;
+    explicit GLHandle(GLuint adoptedName)
+        : name(adoptedName)
+    {
+        GLObjectTracker::OnCreate(Type, name);
+    }
+    ~GLHandle() { Reset(); }
+
+    GLHandle(const GLHandle&) = delete;
+    GLHandle& operator=(const GLHandle&) = delete;
+
+    GLHandle(GLHandle&& other) noexcept
+        : name(other.name)
+    {
+        other.name = 0;
+    }
+
+    GLHandle& operator=(GLHandle&& other) noexcept
+    {
+        if (this != &other) {
+            Reset();
+            name = other.name;
+            other.name = 0;
+        }
+        return *this;
+    }
+
+    static GLHandle Create() { return GLHandle(GLObjectTracker::Generate(Type)); }
+
+    GLuint Get() const { return name; }
+    operator GLuint() const { return name; }
+
+    // a tulajdonjog átadása törlés nélkül (a hívó felel a névért)
+    GLuint Release()
+    {
+        const GLuint released = name;
+        if (released)
+            GLObjectTracker::OnDelete(Type, released);
+        name = 0;
+        return released;
+    }
+
+    void Reset()
+    {
+        if (name) {
+            GLObjectTracker::Delete(Type, name);
+            name = 0;
+        }
+    }
+
+private:
+    GLuint name = 0;
+};
+
+using GLBuffer = GLHandle<GLObjectType::Buffer>;
+using GLVertexArray = GLHandle<GLObjectType::VertexArray>;
+using GLTexture = GLHandle<GLObjectType::Texture>;
+using GLRenderbuffer = GLHandle<GLObjectType::Renderbuffer>;
+using GLFramebuffer = GLHandle<GLObjectType::Framebuffer>;
+using GLQuery = GLHandle<GLObjectType::Query>;
+using GLProgram = GLHandle<GLObjectType::Program>;
@@ -0,0 +1,551 @@
+﻿#include "GLStats.h"
+#include "GLBackend.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    enum FunctionId : size_t
+    {
+#define GL_FUNCTION(ret, name, params, args) Id_##name,
+#include "GLFunctions.inl"
+#undef GL_FUNCTION
+        FunctionCount
+    };
+
+    constexpr const char* kFunctionNames[FunctionCount] = {
+#define GL_FUNCTION(ret, name, params, args) #name,
+#include "GLFunctions.inl"
+#undef GL_FUNCTION
+    };
+
+    struct FunctionStats
+    {
+        uint64_t calls = 0;
+        uint64_t redundant = 0;
+    };
+
+    struct PerformanceMessage
+    {
+        std::string text;
+        uint64_t count = 0;     // az aktuális ablakban
+        bool reported = false;  // a szöveg csak először kerül a táblázat alá
+    };
+
+    // A bekapcsolás előtti állapot ismeretlen: az első beállítás sosem felesleges
+    constexpr GLuint kUnknown = ~0u;
+
+    struct TrackedState
+    {
+        GLuint program = kUnknown;
+        GLuint vao = kUnknown;
+        GLuint drawFramebuffer = kUnknown;
+        GLuint readFramebuffer = kUnknown;
+        GLuint renderbuffer = kUnknown;
+        GLenum activeTexture = kUnknown;
+        GLuint depthMask = kUnknown;
+        GLuint depthFunc = kUnknown;
+        uint64_t blendFunc = ~0ull;
+        std::array<GLint, 4> viewport = { -1, -1, -1, -1 };
+        std::unordered_map<uint64_t, GLuint> textures;      // (egység << 32) | target
+        std::unordered_map<GLenum, GLuint> buffers;
+        std::unordered_map<GLenum, bool> capabilities;
+        std::unordered_map<uint64_t, std::vector<unsigned char>> uniforms;  // (program << 32) | hely
+    };
+
+    bool enabled = false;
+    GLStats::Settings activeSettings;
+    GLFunctionTable forward;        // a bekapcsoláskor telepített mutatók (driver / null / rögzítő)
+    TrackedState state;
+    std::array<FunctionStats, FunctionCount> counters = {};
+    int capturedFrames = 0;
+    bool debugHooked = false;
+    std::map<GLuint, PerformanceMessage> performanceMessages;
+    uint64_t windowPerformanceMessages = 0;
+
+    void Count(FunctionId function, bool redundant)
+    {
+        FunctionStats& stats = counters[function];
+        ++stats.calls;
+        if (redundant)
+            ++stats.redundant;
+    }
+
+    // true, ha a kötés már ez volt; egyébként megjegyzi
+    template <typename Map, typename Key>
+    bool SameBinding(Map& bindings, Key key, GLuint name)
+    {
+        auto [it, inserted] = bindings.try_emplace(key, name);
+        if (!inserted && it->second == name)
+            return true;
+        it->second = name;
+        return false;
+    }
+
+    bool SameValue(GLuint& current, GLuint value)
+    {
+        if (current == value)
+            return true;
+        current = value;
+        return false;
+    }
+
+    // -1 helyre írni no-op, ezért az is felesleges
+    bool SameUniform(GLint location, const void* values, size_t bytes)
+    {
+        if (location < 0)
+            return true;
+        if (state.program == kUnknown)
+            return false;
+
+        const uint64_t key = (static_cast<uint64_t>(state.program) << 32) | static_cast<uint32_t>(location);
+        std::vector<unsigned char>& cached = state.uniforms[key];
+        if (cached.size() == bytes && std::memcmp(cached.data(), values, bytes) == 0)
+            return true;
+        const unsigned char* begin = static_cast<const unsigned char*>(values);
+        cached.assign(begin, begin + bytes);
+        return false;
+    }
+
+    // linkeléskor / törléskor a program uniformjai alapértékre állnak
+    void ForgetUniforms(GLuint program)
+    {
+        for (auto it = state.uniforms.begin(); it != state.uniforms.end();) {
+            if ((it->first >> 32) == program)
+                it = state.uniforms.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    // törölt, de kötött objektum helyén a kötés 0 lesz
+    void UnbindDeleted(GLuint& binding, GLsizei n, const GLuint* names)
+    {
+        if (std::find(names, names + n, binding) != names + n)
+            binding = 0;
+    }
+
+    template <typename Map>
+    void UnbindDeleted(Map& bindings, GLsizei n, const GLuint* names)
+    {
+        for (auto& binding : bindings)
+            UnbindDeleted(binding.second, n, names);
+    }
+
+    // Általános burkolók: csak számlálnak
+#define GL_FUNCTION(ret, name, params, args) \
+    ret APIENTRY Stats_##name params \
+    { \
+        Count(Id_##name, false); \
+        return forward.name##Ptr args; \
+    }
+#include "GLFunctions.inl"
+#undef GL_FUNCTION
+
+    // --- Kötések és állapot
+    void APIENTRY TrackUseProgram(GLuint program)
+    {
+        Count(Id_glUseProgram, SameValue(state.program, program));
+        forward.glUseProgramPtr(program);
+    }
+
+    void APIENTRY TrackBindVertexArray(GLuint array)
+    {
+        const bool same = SameValue(state.vao, array);
+        if (!same)
+            state.buffers.erase(GL_ELEMENT_ARRAY_BUFFER);  // a VAO állapota
+        Count(Id_glBindVertexArray, same);
+        forward.glBindVertexArrayPtr(array);
+    }
+
+    void APIENTRY TrackActiveTexture(GLenum texture)
+    {
+        Count(Id_glActiveTexture, SameValue(state.activeTexture, texture));
+        forward.glActiveTexturePtr(texture);
+    }
+
+    void APIENTRY TrackBindTexture(GLenum target, GLuint texture)
+    {
+        const bool same = state.activeTexture != kUnknown
+            && SameBinding(state.textures, (static_cast<uint64_t>(state.activeTexture) << 32) | target, texture);
+        Count(Id_glBindTexture, same);
+        forward.glBindTexturePtr(target, texture);
+    }
+
+    void APIENTRY TrackBindBuffer(GLenum target, GLuint buffer)
+    {
+        Count(Id_glBindBuffer, SameBinding(state.buffers, target, buffer));
+        forward.glBindBufferPtr(target, buffer);
+    }
+
+    void APIENTRY TrackBindFramebuffer(GLenum target, GLuint framebuffer)
+    {
+        bool same;
+        if (target == GL_DRAW_FRAMEBUFFER)
+            same = SameValue(state.drawFramebuffer, framebuffer);
+        else if (target == GL_READ_FRAMEBUFFER)
+            same = SameValue(state.readFramebuffer, framebuffer);
+        else {
+            same = state.drawFramebuffer == framebuffer && state.readFramebuffer == framebuffer;
+            state.drawFramebuffer = state.readFramebuffer = framebuffer;
+        }
+        Count(Id_glBindFramebuffer, same);
+        forward.glBindFramebufferPtr(target, framebuffer);
+    }
+
+    void APIENTRY TrackBindRenderbuffer(GLenum target, GLuint renderbuffer)
+    {
+        Count(Id_glBindRenderbuffer, SameValue(state.renderbuffer, renderbuffer));
+        forward.glBindRenderbufferPtr(target, renderbuffer);
+    }
+
+    bool SameCapability(GLenum capability, bool value)
+    {
+        auto [it, inserted] = state.capabilities.try_emplace(capability, value);
+        if (!inserted && it->second == value)
+            return true;
+        it->second = value;
+        return false;
+    }
+
+    void APIENTRY TrackEnable(GLenum capability)
+    {
+        Count(Id_glEnable, SameCapability(capability, true));
+        forward.glEnablePtr(capability);
+    }
+
+    void APIENTRY TrackDisable(GLenum capability)
+    {
+        Count(Id_glDisable, SameCapability(capability, false));
+        forward.glDisablePtr(capability);
+    }
+
+    void APIENTRY TrackDepthMask(GLboolean flag)
+    {
+        Count(Id_glDepthMask, SameValue(state.depthMask, flag));
+        forward.glDepthMaskPtr(flag);
+    }
+
+    void APIENTRY TrackDepthFunc(GLenum func)
+    {
+        Count(Id_glDepthFunc, SameValue(state.depthFunc, func));
+        forward.glDepthFuncPtr(func);
+    }
+
+    void APIENTRY TrackBlendFunc(GLenum sfactor, GLenum dfactor)
+    {
+        const uint64_t blend = (static_cast<uint64_t>(sfactor) << 32) | dfactor;
+        const bool same = state.blendFunc == blend;
+        state.blendFunc = blend;
+        Count(Id_glBlendFunc, same);
+        forward.glBlendFuncPtr(sfactor, dfactor);
+    }
+
+    void APIENTRY TrackViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        const std::array<GLint, 4> viewport = { x, y, width, height };
+        const bool same = state.viewport == viewport;
+        state.viewport = viewport;
+        Count(Id_glViewport, same);
+        forward.glViewportPtr(x, y, width, height);
+    }
+
+    // --- Uniformok (a kötött program szerint)
+    void APIENTRY TrackUniform1i(GLint location, GLint v0)
+    {
+        Count(Id_glUniform1i, SameUniform(location, &v0, sizeof(v0)));
+        forward.glUniform1iPtr(location, v0);
+    }
+
+    void APIENTRY TrackUniform1f(GLint location, GLfloat v0)
+    {
+        Count(Id_glUniform1f, SameUniform(location, &v0, sizeof(v0)));
+        forward.glUniform1fPtr(location, v0);
+    }
+
+    void APIENTRY TrackUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+    {
+        const GLfloat values[] = { v0, v1, v2 };
+        Count(Id_glUniform3f, SameUniform(location, values, sizeof(values)));
+        forward.glUniform3fPtr(location, v0, v1, v2);
+    }
+
+    void APIENTRY TrackUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+    {
+        const GLfloat values[] = { v0, v1, v2, v3 };
+        Count(Id_glUniform4f, SameUniform(location, values, sizeof(values)));
+        forward.glUniform4fPtr(location, v0, v1, v2, v3);
+    }
+
+    void APIENTRY TrackUniform2fv(GLint location, GLsizei count, const GLfloat* value)
+    {
+        Count(Id_glUniform2fv, SameUniform(location, value, sizeof(GLfloat) * 2 * count));
+        forward.glUniform2fvPtr(location, count, value);
+    }
+
+    void APIENTRY TrackUniform3fv(GLint location, GLsizei count, const GLfloat* value)
+    {
+        Count(Id_glUniform3fv, SameUniform(location, value, sizeof(GLfloat) * 3 * count));
+        forward.glUniform3fvPtr(location, count, value);
+    }
+
+    void APIENTRY TrackUniform4fv(GLint location, GLsizei count, const GLfloat* value)
+    {
+        Count(Id_glUniform4fv, SameUniform(location, value, sizeof(GLfloat) * 4 * count));
+        forward.glUniform4fvPtr(location, count, value);
+    }
+
+    void APIENTRY TrackUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+    {
+        // a transpose más értéket jelent ugyanazokból a bájtokból: ilyenkor nem hasonlítunk
+        const bool same = !transpose && SameUniform(location, value, sizeof(GLfloat) * 16 * count);
+        Count(Id_glUniformMatrix4fv, same);
+        forward.glUniformMatrix4fvPtr(location, count, transpose, value);
+    }
+
+    // --- Az állapotot érvénytelenítő hívások
+    void APIENTRY TrackLinkProgram(GLuint program)
+    {
+        ForgetUniforms(program);
+        Count(Id_glLinkProgram, false);
+        forward.glLinkProgramPtr(program);
+    }
+
+    void APIENTRY TrackProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length)
+    {
+        ForgetUniforms(program);
+        Count(Id_glProgramBinary, false);
+        forward.glProgramBinaryPtr(program, binaryFormat, binary, length);
+    }
+
+    void APIENTRY TrackDeleteProgram(GLuint program)
+    {
+        ForgetUniforms(program);
+        UnbindDeleted(state.program, 1, &program);
+        Count(Id_glDeleteProgram, false);
+        forward.glDeleteProgramPtr(program);
+    }
+
+    void APIENTRY TrackDeleteTextures(GLsizei n, const GLuint* textures)
+    {
+        UnbindDeleted(state.textures, n, textures);
+        Count(Id_glDeleteTextures, false);
+        forward.glDeleteTexturesPtr(n, textures);
+    }
+
+    void APIENTRY TrackDeleteBuffers(GLsizei n, const GLuint* buffers)
+    {
+        UnbindDeleted(state.buffers, n, buffers);
+        Count(Id_glDeleteBuffers, false);
+        forward.glDeleteBuffersPtr(n, buffers);
+    }
+
+    void APIENTRY TrackDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+    {
+        if (std::find(arrays, arrays + n, state.vao) != arrays + n) {
+            state.vao = 0;
+            state.buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+        }
+        Count(Id_glDeleteVertexArrays, false);
+        forward.glDeleteVertexArraysPtr(n, arrays);
+    }
+
+    void APIENTRY TrackDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+    {
+        UnbindDeleted(state.drawFramebuffer, n, framebuffers);
+        UnbindDeleted(state.readFramebuffer, n, framebuffers);
+        Count(Id_glDeleteFramebuffers, false);
+        forward.glDeleteFramebuffersPtr(n, framebuffers);
+    }
+
+    GLFunctionTable MakeStatsTable()
+    {
+        GLFunctionTable table;
+#define GL_FUNCTION(ret, name, params, args) table.name##Ptr = &Stats_##name;
+#include "GLFunctions.inl"
+#undef GL_FUNCTION
+        table.glUseProgramPtr = &TrackUseProgram;
+        table.glBindVertexArrayPtr = &TrackBindVertexArray;
+        table.glActiveTexturePtr = &TrackActiveTexture;
+        table.glBindTexturePtr = &TrackBindTexture;
+        table.glBindBufferPtr = &TrackBindBuffer;
+        table.glBindFramebufferPtr = &TrackBindFramebuffer;
+        table.glBindRenderbufferPtr = &TrackBindRenderbuffer;
+        table.glEnablePtr = &TrackEnable;
+        table.glDisablePtr = &TrackDisable;
+        table.glDepthMaskPtr = &TrackDepthMask;
+        table.glDepthFuncPtr = &TrackDepthFunc;
+        table.glBlendFuncPtr = &TrackBlendFunc;
+        table.glViewportPtr = &TrackViewport;
+        table.glUniform1iPtr = &TrackUniform1i;
+        table.glUniform1fPtr = &TrackUniform1f;
+        table.glUniform3fPtr = &TrackUniform3f;
+        table.glUniform4fPtr = &TrackUniform4f;
+        table.glUniform2fvPtr = &TrackUniform2fv;
+        table.glUniform3fvPtr = &TrackUniform3fv;
+        table.glUniform4fvPtr = &TrackUniform4fv;
+        table.glUniformMatrix4fvPtr = &TrackUniformMatrix4fv;
+        table.glLinkProgramPtr = &TrackLinkProgram;
+        table.glProgramBinaryPtr = &TrackProgramBinary;
+        table.glDeleteProgramPtr = &TrackDeleteProgram;
+        table.glDeleteTexturesPtr = &TrackDeleteTextures;
+        table.glDeleteBuffersPtr = &TrackDeleteBuffers;
+        table.glDeleteVertexArraysPtr = &TrackDeleteVertexArrays;
+        table.glDeleteFramebuffersPtr = &TrackDeleteFramebuffers;
+        return table;
+    }
+
+    // --- KHR_debug teljesítmény-üzenetek
+    void APIENTRY OnDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity,
+        GLsizei length, const GLchar* message, const void* userParam)
+    {
+        PerformanceMessage& entry = performanceMessages[id];
+        if (entry.text.empty())
+            entry.text.assign(message, length >= 0 ? static_cast<size_t>(length) : std::strlen(message));
+        ++entry.count;
+        ++windowPerformanceMessages;
+    }
+
+    bool HasExtension(const char* name)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; ++i) {
+            const GLubyte* extension = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+            if (extension && std::strcmp(reinterpret_cast<const char*>(extension), name) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    // A driver mutatóival hívandó (a burkolók telepítése előtt / levétele után)
+    void HookDebugOutput(GLADloadproc loader)
+    {
+        if (GLBackend::GetKind() != GLBackend::Kind::OpenGL)
+            return;
+
+        // 4.3 alatt a KHR_debug core profilban utótag nélküli neveket ad
+        if ((!glad_glDebugMessageCallback || !glad_glDebugMessageControl) && loader && HasExtension("GL_KHR_debug")) {
+            glad_glDebugMessageCallback = reinterpret_cast<PFNGLDEBUGMESSAGECALLBACKPROC>(loader("glDebugMessageCallback"));
+            glad_glDebugMessageControl = reinterpret_cast<PFNGLDEBUGMESSAGECONTROLPROC>(loader("glDebugMessageControl"));
+        }
+        if (!glad_glDebugMessageCallback || !glad_glDebugMessageControl) {
+            std::cout << "GL stats: KHR_debug not available, no performance messages" << std::endl;
+            return;
+        }
+
+        glEnable(GL_DEBUG_OUTPUT);
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);   // a számlálók nem szálbiztosak
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+        glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_PERFORMANCE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+        glDebugMessageCallback(&OnDebugMessage, nullptr);
+        debugHooked = true;
+    }
+
+    void UnhookDebugOutput()
+    {
+        if (!debugHooked)
+            return;
+        glDebugMessageCallback(nullptr, nullptr);
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        glDisable(GL_DEBUG_OUTPUT);
+        debugHooked = false;
+    }
+
+    void ResetWindow()
+    {
+        counters.fill(FunctionStats());
+        capturedFrames = 0;
+        windowPerformanceMessages = 0;
+        for (auto& message : performanceMessages)
+            message.second.count = 0;
+    }
+
+    void PrintReport()
+    {
+        const double frames = static_cast<double>(std::max(capturedFrames, 1));
+        uint64_t totalCalls = 0, totalRedundant = 0;
+        std::vector<size_t> order;
+        for (size_t i = 0; i < FunctionCount; ++i) {
+            totalCalls += counters[i].calls;
+            totalRedundant += counters[i].redundant;
+            if (counters[i].calls > 0)
+                order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(), [](size_t a, size_t b) {
+            return counters[a].calls != counters[b].calls ? counters[a].calls > counters[b].calls : a < b;
+        });
+        if (order.size() > static_cast<size_t>(std::max(activeSettings.topCount, 0)))
+            order.resize(static_cast<size_t>(std::max(activeSettings.topCount, 0)));
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "GL calls over " << capturedFrames << " frame(s): " << totalCalls / frames << " per frame, "
+            << totalRedundant / frames << " redundant, " << windowPerformanceMessages << " performance message(s)" << std::endl;
+        std::cout << "   entry point                  calls/frame  redundant/frame" << std::endl;
+        for (size_t i : order) {
+            std::cout << "   " << std::left << std::setw(28) << kFunctionNames[i] << std::right
+                << std::setw(12) << counters[i].calls / frames
+                << std::setw(17) << counters[i].redundant / frames << std::endl;
+        }
+        for (auto& [id, message] : performanceMessages) {
+            if (message.count == 0 || message.reported)
+                continue;
+            std::cout << "   perf " << id << " (x" << message.count << "): " << message.text << std::endl;
+            message.reported = true;
+        }
+        std::cout << std::defaultfloat;
+    }
+}
+
+void GLStats::Enable(const Settings& settings, GLADloadproc loader)
+{
+    activeSettings = settings;
+    activeSettings.captureFrames = std::max(settings.captureFrames, 1);
+    if (enabled) {
+        ResetWindow();
+        return;
+    }
+
+    forward = GLFunctionTable::Capture();
+    HookDebugOutput(loader);
+    state = TrackedState();
+    ResetWindow();
+    MakeStatsTable().Apply();
+    enabled = true;
+}
+
+void GLStats::Disable()
+{
+    if (!enabled)
+        return;
+    forward.Apply();
+    UnhookDebugOutput();
+    enabled = false;
+}
+
+bool GLStats::IsEnabled()
+{
+    return enabled;
+}
+
+void GLStats::EndFrame()
+{
+    if (!enabled)
+        return;
+    if (++capturedFrames < activeSettings.captureFrames)
+        return;
+
+    PrintReport();
+    if (activeSettings.continuous)
+        ResetWindow();
+    else
+        Disable();
+}
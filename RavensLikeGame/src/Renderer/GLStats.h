@@ -0,0 +1,34 @@
+﻿#pragma once
+#include <glad/glad.h>
+
+// Opcionális GL hívás-statisztika. Bekapcsolva a GLFunctions.inl-ben felsorolt glad
+// függvénymutatókat számláló burkolókra cseréli (bármelyik GLBackend fölött), kikapcsolva
+// visszaállítja az eredetieket: ilyenkor nincs semmilyen többletköltség.
+//
+// Belépési pontonként számolja a hívásokat és a feleslegeseket: a már kötött program /
+// textúra / VAO / puffer / framebuffer újrakötése, az állapot ismételt beállítása, és a
+// változatlan értékű (vagy -1 helyre menő) uniform-írás. A KHR_debug teljesítmény-üzeneteit is
+// gyűjti, ha a kontextus adja (debug kontextus ajánlott). A captureFrames képkockás ablak végén
+// a leggyakoribb topCount belépési pontot táblázatban kiírja.
+//
+// A GLBackend::Install-t a bekapcsolás előtt kell hívni (a burkolók az akkor telepített
+// mutatókat hívják tovább). Csak a fő (GL) szálról.
+class GLStats
+{
+public:
+    struct Settings
+    {
+        int captureFrames = 60;     // 1: táblázat minden képkockáról
+        int topCount = 15;
+        bool continuous = false;    // az ablak végén új ablak indul (különben kikapcsol)
+    };
+
+    // loader: a KHR_debug belépési pontjaihoz 4.3 alatti kontextusnál (pl. glfwGetProcAddress)
+    static void Enable(const Settings& settings, GLADloadproc loader = nullptr);
+    static void Enable() { Enable(Settings()); }
+    static void Disable();
+    static bool IsEnabled();
+
+    // képkocka végén (a buffercsere után); kikapcsolva nem csinál semmit
+    static void EndFrame();
+};
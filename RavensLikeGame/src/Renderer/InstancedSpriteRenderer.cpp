@@ -0,0 +1,109 @@
+﻿#include "InstancedSpriteRenderer.h"
+#include "../Core/AllocationTracker.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+
+InstancedSpriteRenderer::InstancedSpriteRenderer(Shader& shader)
+    : shader(shader)
+{
+    InitRenderData();
+}
+
+void InstancedSpriteRenderer::InitRenderData()
+{
+    // origó-középpontú egység quad, két háromszög
+    float quadVertices[] = {
+        // pos          // tex
+        -0.5f, -0.5f,   0.0f, 0.0f,
+         0.5f, -0.5f,   1.0f, 0.0f,
+         0.5f,  0.5f,   1.0f, 1.0f,
+
+        -0.5f, -0.5f,   0.0f, 0.0f,
+         0.5f,  0.5f,   1.0f, 1.0f,
+        -0.5f,  0.5f,   0.0f, 1.0f
+    };
+
+    vao = GLVertexArray::Create();
+    quadVBO = GLBuffer::Create();
+    instanceVBO = GLBuffer::Create();
+
+    glBindVertexArray(vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, center));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, size));
+    glVertexAttribDivisor(3, 1);
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, uvRect));
+    glVertexAttribDivisor(4, 1);
+    glEnableVertexAttribArray(5);
+    glVertexAttribPointer(5, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, color));
+    glVertexAttribDivisor(5, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstancedSpriteRenderer::Draw(const std::vector<SpriteInstance>& instances,
+    const glm::mat4& projection, const glm::mat4& view,
+    const Texture* texture)
+{
+    ALLOCATION_SCOPE("InstancedSpriteRenderer::Draw");
+    lastUploadBytes = 0;
+    if (instances.empty())
+        return;
+
+    shader.Use();
+    shader.SetMat4("projection", projection);
+    shader.SetMat4("view", view);
+    shader.SetInt("useTexture", texture ? 1 : 0);
+    shader.SetInt("sprite", 0);
+    shader.SetVec4("isoGrid", spriteDepth.grid);
+    shader.SetVec4("isoDepth", spriteDepth.depth);
+    if (texture)
+        texture->Bind(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    const size_t bytes = instances.size() * sizeof(SpriteInstance);
+    if (instances.size() > instanceCapacity) {
+        instanceCapacity = std::max(instances.size(), instanceCapacity * 2);
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(SpriteInstance), nullptr, GL_STREAM_DRAW);
+    }
+    else {
+        // orphaning: a driver új tárat ad, nem kell az előző képkocka rajzolására várni
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(SpriteInstance), nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    lastUploadBytes = bytes;
+
+    // áttetsző példányok: a csempék eltakarják őket, de ők nem írnak mélységet
+    glDepthMask(GL_FALSE);
+    glBindVertexArray(vao);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(instances.size()));
+    glBindVertexArray(0);
+    glDepthMask(GL_TRUE);
+
+    if (texture)
+        texture->Unbind();
+}
+
+uint32_t InstancedSpriteRenderer::PackColor(const glm::vec4& color)
+{
+    const glm::vec4 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    return static_cast<uint32_t>(c.r)
+        | (static_cast<uint32_t>(c.g) << 8)
+        | (static_cast<uint32_t>(c.b) << 16)
+        | (static_cast<uint32_t>(c.a) << 24);
+}
@@ -0,0 +1,45 @@
+﻿#pragma once
+#include "Shader.h"
+#include "Texture.h"
+#include "../Core/IsoGrid.h"
+#include <cstdint>
+#include <glm.hpp>
+#include <vector>
+
+// Egy példány = egy középre igazított quad (instanced_sprite.vert 2..5-ös location)
+struct SpriteInstance
+{
+    glm::vec2 center;
+    glm::vec2 size;
+    glm::vec4 uvRect;
+    uint32_t color;     // RGBA8, R a legalsó bájt
+};
+
+// Sok kis sprite (lövedék, részecske) egyetlen instanced rajzolással
+class InstancedSpriteRenderer
+{
+public:
+    InstancedSpriteRenderer(Shader& shader);
+
+    // texture == nullptr: textúra nélküli, lágy szélű kör a példány színével
+    void Draw(const std::vector<SpriteInstance>& instances,
+        const glm::mat4& projection, const glm::mat4& view,
+        const Texture* texture = nullptr);
+
+    // a példányok mélysége a középpont csempéjének átlójából (IsoGrid::GetSpriteDepthParams)
+    void SetSpriteDepth(const IsoGrid::SpriteDepthParams& params) { spriteDepth = params; }
+
+    size_t GetLastUploadBytes() const { return lastUploadBytes; }
+
+    static uint32_t PackColor(const glm::vec4& color);
+
+private:
+    Shader& shader;
+    GLVertexArray vao;
+    GLBuffer quadVBO, instanceVBO;
+    size_t instanceCapacity = 0;
+    size_t lastUploadBytes = 0;
+    IsoGrid::SpriteDepthParams spriteDepth;
+
+    void InitRenderData();
+};
@@ -0,0 +1,125 @@
+﻿#include "IsoMapTextureRenderer.h"
+#include "../Core/Globals.h"
+#include "../Game/TileMap.h"
+#include <glad/glad.h>
+
+IsoMapTextureRenderer::IsoMapTextureRenderer(Shader& shader, const IsoRenderer& iso)
+    : shader(shader), iso(iso)
+{
+    vao = GLVertexArray::Create();
+
+    // egész textúrák: nincs szűrés, texelFetch-csel olvassuk
+    for (GLTexture* texture : { &tileTexture, &visibilityTexture }) {
+        *texture = GLTexture::Create();
+        glBindTexture(GL_TEXTURE_2D, *texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+uint8_t IsoMapTextureRenderer::EncodeTile(int id) const
+{
+    return (id >= 0 && id < iso.GetTileCount()) ? static_cast<uint8_t>(id) : kEmptyTile;
+}
+
+void IsoMapTextureRenderer::UploadAll(const TileMap& map)
+{
+    width = map.GetWidth();
+    height = map.GetHeight();
+
+    staging.resize(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            staging[y * width + x] = EncodeTile(map.GetTile(x, y));
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindTexture(GL_TEXTURE_2D, tileTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, staging.data());
+    glBindTexture(GL_TEXTURE_2D, visibilityTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    lastUploadBytes += staging.size();
+}
+
+void IsoMapTextureRenderer::Sync(const TileMap& map, const uint8_t* visibility, bool visibilityChanged)
+{
+    lastUploadBytes = 0;
+
+    changedCells.clear();
+    const bool sizeChanged = map.GetWidth() != width || map.GetHeight() != height;
+    if (sizeChanged || !map.GetChangesSince(syncedRevision, changedCells)) {
+        UploadAll(map);
+        visibilityChanged = true;
+    }
+    else {
+        for (const glm::ivec2& cell : changedCells)
+            SetTile(cell.x, cell.y, map.GetTile(cell.x, cell.y));
+    }
+    syncedRevision = map.GetRevision();
+
+    hasVisibility = visibility != nullptr;
+    if (hasVisibility && visibilityChanged && width > 0 && height > 0) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glBindTexture(GL_TEXTURE_2D, visibilityTexture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED_INTEGER, GL_UNSIGNED_BYTE, visibility);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        lastUploadBytes += static_cast<size_t>(width) * height;
+    }
+}
+
+void IsoMapTextureRenderer::SetTile(int x, int y, int id)
+{
+    if (x < 0 || y < 0 || x >= width || y >= height)
+        return;
+
+    const uint8_t value = EncodeTile(id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindTexture(GL_TEXTURE_2D, tileTexture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_BYTE, &value);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    lastUploadBytes += 1;
+}
+
+void IsoMapTextureRenderer::Draw(const glm::mat4& projection, const glm::mat4& view)
+{
+    if (width <= 0 || height <= 0)
+        return;
+
+    const auto& uvRects = iso.GetTileUvRects();
+
+    shader.Use();
+    shader.SetMat4("inverseViewProjection", glm::inverse(projection * view));
+    shader.SetInt("textureAtlas", 0);
+    shader.SetInt("tileMap", 1);
+    shader.SetInt("visibilityMap", 2);
+    shader.SetVec4Array("tileUvRects", uvRects.data(), iso.GetTileCount());
+    shader.SetInt("tileCount", iso.GetTileCount());
+    shader.SetVec2("origin", iso.ComputeMapOrigin(height, width));
+    shader.SetVec2("halfTile", glm::vec2(iso.GetHalfTileWidth(), iso.GetHalfTileHeight()));
+    shader.SetVec2("tileQuadSize", glm::vec2(iso.ScaledWidth(), iso.ScaledHeight()));
+    // a quad aljától a felső lap (rombusz) közepéig
+    shader.SetVec2("topFaceCenter", glm::vec2(0.0f, iso.ScaledHeight() - iso.GetHalfTileHeight()));
+    shader.SetVec2("mapSize", glm::vec2(static_cast<float>(width), static_cast<float>(height)));
+    shader.SetInt("useVisibility", hasVisibility ? 1 : 0);
+    shader.SetFloat("rememberedBrightness", iso.GetRememberedBrightness());
+    shader.SetFloat("depthSortKeyRange", Globals::kDepthSortKeyRange);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, iso.GetAtlasTexture());
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, tileTexture);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, visibilityTexture);
+    glActiveTexture(GL_TEXTURE0);
+
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+}
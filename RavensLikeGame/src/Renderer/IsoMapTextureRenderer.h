@@ -0,0 +1,49 @@
+﻿#pragma once
+#include "Shader.h"
+#include "IsoRenderer.h"
+#include <cstdint>
+#include <glm.hpp>
+#include <vector>
+
+class TileMap;
+
+// Az IsoRenderer alternatív módja: a csemperács egy R8UI textúra, a talajt egyetlen
+// teljes képernyős pass rajzolja (pixelenként inverz vetítés -> (col,row) -> atlasz).
+// A CPU költség képkockánként állandó; csempeváltás = egy texeles glTexSubImage2D.
+// A kocka oldallapjai a hátsó szomszédok mintavételezésével jönnek, így nem kell külön geometria.
+class IsoMapTextureRenderer
+{
+public:
+    IsoMapTextureRenderer(Shader& shader, const IsoRenderer& iso);
+
+    // Méretváltáskor teljes feltöltés, egyébként csak a TileMap naplójában szereplő texelek.
+    // visibility (opcionális, sor-folytonos FieldOfView) csak visibilityChanged esetén töltődik fel.
+    void Sync(const TileMap& map, const uint8_t* visibility, bool visibilityChanged);
+
+    void SetTile(int x, int y, int id);
+
+    void Draw(const glm::mat4& projection, const glm::mat4& view);
+
+    // az utolsó Sync során feltöltött bájtok (diagnosztika)
+    size_t GetLastUploadBytes() const { return lastUploadBytes; }
+
+private:
+    static constexpr uint8_t kEmptyTile = 255;
+
+    Shader& shader;
+    const IsoRenderer& iso;
+
+    GLVertexArray vao;                  // üres VAO a gl_VertexID-s teljes képernyős háromszöghöz
+    GLTexture tileTexture;              // R8UI csempe-azonosítók
+    GLTexture visibilityTexture;        // R8UI FieldOfView állapot
+    int width = 0, height = 0;
+    unsigned int syncedRevision = 0;
+    bool hasVisibility = false;
+    size_t lastUploadBytes = 0;
+
+    std::vector<uint8_t> staging;
+    std::vector<glm::ivec2> changedCells;
+
+    void UploadAll(const TileMap& map);
+    uint8_t EncodeTile(int id) const;
+};
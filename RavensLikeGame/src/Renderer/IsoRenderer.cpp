@@ -1,17 +1,21 @@
 ﻿#include "IsoRenderer.h"
+#include "../Core/AllocationTracker.h"
 #include <glad/glad.h>
-#include <stb_image.h>
+#include "TextureImporter.h"
 #include <gtc/matrix_transform.hpp>
 #include <gtc/type_ptr.hpp>
 #include "../Core/Globals.h"
 #include <iostream>
 #include <algorithm>
+#include <cstddef>
 
-IsoRenderer::IsoRenderer(Shader& shader, const std::string& texturePath)
+IsoRenderer::IsoRenderer(Shader& shader, const std::string& texturePath, TextureCache& textures)
     : shader(shader)
 {
-    LoadTexture(texturePath);
+    // amíg az atlasz a háttérben töltődik, a teljes quad rajzolódik a helyőrzővel
+    mesh = TileMesh::FullQuad();
     InitRenderData();
+    LoadTexture(texturePath, textures);
 
     projection = glm::mat4(1.0f);
     view = glm::mat4(1.0f);
@@ -24,13 +28,6 @@ IsoRenderer::IsoRenderer(Shader& shader, const std::string& texturePath)
     }
 }
 
-IsoRenderer::~IsoRenderer()
-{
-    glDeleteVertexArrays(1, &vao);
-    glDeleteBuffers(1, &vbo);
-    glDeleteTextures(1, &textureID);
-}
-
 void IsoRenderer::SetProjection(const glm::mat4& proj)
 {
     projection = proj;
@@ -41,74 +38,131 @@ void IsoRenderer::SetView(const glm::mat4& v)
     view = v;
 }
 
-void IsoRenderer::LoadTexture(const std::string& path)
+TextureImportSettings IsoRenderer::AtlasImportSettings()
 {
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    // Pixel-art mip-lánc: 0.5-ös skálán az 1. szint mintavételeződik, nem a teljes atlasz.
+    // Előskálázás nincs: a 693 széles cellák fele nem egész, így a cellahatárok texelek közepére esnének.
+    TextureImportSettings settings;
+    settings.profile = TextureFilterProfile::PixelArt;
+    settings.mipmaps = MipmapMode::PixelArt;
+    settings.flipVertically = true;
+    return settings;
+}
 
-    int width, height, nrChannels;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 4);
-    if (!data) {
-        std::cerr << "Failed to load texture: " << path << std::endl;
-        return;
+void IsoRenderer::LoadTexture(const std::string& path, TextureCache& textures)
+{
+    atlas = textures.AcquireAsync(path, AtlasImportSettings(), [this](const ImportedTexture& image) { BuildMesh(image); });
+}
+
+void IsoRenderer::BuildMesh(const ImportedTexture& image)
+{
+    // Szoros háló az alfából: a teljes quad helyett csak a nem-átlátszó rész raszterizálódik
+    const ImportedTexture::Level& base = image.levels[0];
+    mesh = TileMesh::BuildFromAlpha(base.pixels.data(), base.width, base.height, static_cast<int>(kTileWidth), kTileCount, kMeshBandHeight);
+    UploadMesh();
+}
+
+void IsoRenderer::UpdateMeshStats()
+{
+    const float quadPixels = ScaledWidth() * ScaledHeight();
+    meshStats.opaqueTriangles = mesh.opaqueTriangles.size() / 3;
+    meshStats.edgeTriangles = mesh.edgeTriangles.size() / 3;
+    meshStats.pixelsPerTile = (mesh.OpaqueArea() + mesh.EdgeArea()) * quadPixels;
+    meshStats.blendedPixelsPerTile = mesh.EdgeArea() * quadPixels;
+    meshStats.quadPixelsPerTile = quadPixels;
+}
+
+bool IsoRenderer::CheckTileMesh(const std::string& texturePath, int mapTileCount)
+{
+    ImportedTexture image;
+    if (!TextureImporter::Import(texturePath, AtlasImportSettings(), image)) {
+        std::cerr << "Tile atlas load failed: " << texturePath << std::endl;
+        return false;
+    }
+
+    const ImportedTexture::Level& base = image.levels[0];
+    const TileMesh tight = TileMesh::BuildFromAlpha(base.pixels.data(), base.width, base.height, static_cast<int>(kTileWidth), kTileCount, kMeshBandHeight);
+    const TileMesh full = TileMesh::FullQuad();
+    const int cellWidth = static_cast<int>(kTileWidth);
+    const TileMesh::Coverage tightCoverage = tight.Measure(base.pixels.data(), base.width, base.height, cellWidth, kTileCount, kTileScale);
+    const TileMesh::Coverage fullCoverage = full.Measure(base.pixels.data(), base.width, base.height, cellWidth, kTileCount, kTileScale);
+
+    std::cout << "Tile mesh (CPU raster, pixel centres, scale " << kTileScale << "):\n"
+        << "  full quad:  " << fullCoverage.meshPixels << " px/tile, " << fullCoverage.blendedPixels << " blended\n"
+        << "  tight mesh: " << tightCoverage.meshPixels << " px/tile, " << tightCoverage.blendedPixels << " blended ("
+        << tight.opaqueTriangles.size() / 3 << " opaque + " << tight.edgeTriangles.size() / 3 << " edge triangles)\n"
+        << "  " << mapTileCount << "-tile map: " << static_cast<int64_t>(fullCoverage.meshPixels) * mapTileCount << " -> "
+        << static_cast<int64_t>(tightCoverage.meshPixels) * mapTileCount << " fragments\n"
+        << "  visible texels outside the hull: " << tightCoverage.uncoveredTexels
+        << ", non-opaque texels in the opaque part: " << tightCoverage.translucentOpaqueTexels << std::endl;
+    return tightCoverage.uncoveredTexels == 0 && tightCoverage.translucentOpaqueTexels == 0;
+}
+
+void IsoRenderer::UploadMesh()
+{
+    const glm::vec2 size(ScaledWidth(), ScaledHeight());
+
+    // opaque háromszögek, utánuk az edge háromszögek egy pufferben (pos, texCoord)
+    std::vector<float> vertices;
+    vertices.reserve((mesh.opaqueTriangles.size() + mesh.edgeTriangles.size()) * 4);
+    for (const auto* triangles : { &mesh.opaqueTriangles, &mesh.edgeTriangles }) {
+        for (const glm::vec2& uv : *triangles) {
+            vertices.push_back(uv.x * size.x);
+            vertices.push_back(uv.y * size.y);
+            vertices.push_back(uv.x);
+            vertices.push_back(uv.y);
+        }
     }
+    opaqueVertexCount = static_cast<int>(mesh.opaqueTriangles.size());
+    UpdateMeshStats();
+    edgeVertexCount = static_cast<int>(mesh.edgeTriangles.size());
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    stbi_image_free(data);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void IsoRenderer::InitRenderData()
 {
-    const float width = ScaledWidth();
-    const float height = ScaledHeight();
-
-    float vertices[] = {
-        // positions       // texCoords
-        0.0f, 0.0f,         0.0f, 0.0f,
-        width, 0.0f,    1.0f, 0.0f,
-        width, height, 1.0f, 1.0f,
-        0.0f, height,   0.0f, 1.0f
-    };
-    unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
-
-    unsigned int ebo;
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &ebo);
+    vao = GLVertexArray::Create();
+    vbo = GLBuffer::Create();
+    samplesQuery = GLQuery::Create();
+    projectionLocation = glGetUniformLocation(shader.ID, "projection");
+    viewLocation = glGetUniformLocation(shader.ID, "view");
 
+    UploadMesh();
     glBindVertexArray(vao);
-
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
+    // példány-attribútumok: eltolás, atlasz UV-téglalap, fényerő
+    instanceVBO = GLBuffer::Create();
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    for (GLuint location = 2; location <= 5; ++location) {
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+    BindInstanceAttributes(0);
+
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-void IsoRenderer::DrawTile(int tileIndex, const glm::vec2& worldPos)
+void IsoRenderer::BindInstanceAttributes(size_t firstInstance) const
 {
-    shader.SetVec4("uvRect", tileUvRects[tileIndex]);
-
-    glm::mat4 model(1.0f);
-    model = glm::translate(model, glm::vec3(worldPos.x, worldPos.y, 0.0f));
-    shader.SetMat4("model", model);
-
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    // a VAO és az instanceVBO legyen kötve; a példány-tartomány eleje az attribútum-offsetben van
+    const size_t base = firstInstance * sizeof(TileInstance);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(TileInstance), (void*)(base + offsetof(TileInstance, offset)));
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(TileInstance), (void*)(base + offsetof(TileInstance, uvRect)));
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(TileInstance), (void*)(base + offsetof(TileInstance, brightness)));
+    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, sizeof(TileInstance), (void*)(base + offsetof(TileInstance, depth)));
 }
 
-void IsoRenderer::DrawMap(const std::vector<std::vector<int>>& mapData)
+void IsoRenderer::BuildInstances(const std::vector<std::vector<int>>& mapData, const uint8_t* visibility)
 {
     const int rows = static_cast<int>(mapData.size());
     const int cols = static_cast<int>(mapData[0].size());
@@ -120,12 +174,8 @@ void IsoRenderer::DrawMap(const std::vector<std::vector<int>>& mapData)
 
     const glm::vec2 origin = ComputeMapOrigin(rows, cols);
 
-    shader.Use();
-    shader.SetMat4("projection", projection);
-    shader.SetMat4("view", view);
-
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glBindVertexArray(vao);
+    // A példányok hátulról-előre sorrendben (a szélekhez); az opaque pass ennek a fordítottja
+    instances.clear();
 
     const int maxS = (rows - 1) + (cols - 1);
     for (int s = maxS; s >= 0; --s) {
@@ -134,7 +184,14 @@ void IsoRenderer::DrawMap(const std::vector<std::vector<int>>& mapData)
         for (int x = xEnd; x >= xStart; --x) {
             int y = s - x;
             int tile = mapData[y][x];
-            if (tile < 0) continue;
+            if (tile < 0 || tile >= kTileCount) continue;
+
+            float brightness = 1.0f;
+            if (visibility) {
+                const uint8_t v = visibility[y * cols + x];
+                if (v == 0) continue;           // még sosem látott: nem rajzoljuk
+                if (v == 1) brightness = kRememberedBrightness;
+            }
 
             // tető (apex) helye
             const float apexX = origin.x + (x - y) * halfW;
@@ -143,11 +200,145 @@ void IsoRenderer::DrawMap(const std::vector<std::vector<int>>& mapData)
             // quad bal-felső sarka (innen rajzol a quad lefelé)
             const glm::vec2 topLeft(apexX - halfW, apexY);
 
-            DrawTile(tile, topLeft);
+            instances.push_back({ topLeft, tileUvRects[tile], brightness, IsoGrid::DepthFromSortKey(static_cast<float>(s)) });
+        }
+    }
+}
+
+void IsoRenderer::UploadInstances()
+{
+    // Opaque pass elölről-hátra: a mélység a rendezési kulcsból jön, így a sorrend csak az
+    // early-Z-t segíti, a helyességhez nem kell (batchelhető lenne textúránként is).
+    opaqueInstances.assign(instances.rbegin(), instances.rend());
+
+    // a puffer: [opaque sorrend][edge sorrend], mindkettő instanceCount hosszú
+    const size_t count = instances.size();
+    const size_t bytes = count * sizeof(TileInstance);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    if (count * 2 > instanceCapacity) {
+        instanceCapacity = instances.capacity() * 2;
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(TileInstance), nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, opaqueInstances.data());
+    glBufferSubData(GL_ARRAY_BUFFER, bytes, bytes, instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void IsoRenderer::DrawMap(const std::vector<std::vector<int>>& mapData, const uint8_t* visibility)
+{
+    BuildInstances(mapData, visibility);
+    if (instances.empty())
+        return;
+    UploadInstances();
+
+    shader.Use();
+    shader.SetMat4("projection", projection);
+    shader.SetMat4("view", view);
+
+    // az előző képkocka mérését csak akkor olvassuk ki, ha már kész (nincs CPU-GPU szinkron)
+    if (samplesQueryPending) {
+        GLuint available = 0;
+        glGetQueryObjectuiv(samplesQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 samples = 0;
+            glGetQueryObjectui64v(samplesQuery, GL_QUERY_RESULT, &samples);
+            lastSamplesPassed = samples;
+            samplesQueryPending = false;
         }
     }
+    const bool measure = !samplesQueryPending;
+    if (measure)
+        glBeginQuery(GL_SAMPLES_PASSED, samplesQuery);
 
+    glBindTexture(GL_TEXTURE_2D, GetAtlasTexture());
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    const size_t count = instances.size();
+
+    // 1) teljesen átlátszatlan belsők: elölről-hátra, blend nélkül, mélységírással
+    if (opaqueVertexCount > 0) {
+        BindInstanceAttributes(0);
+        glDisable(GL_BLEND);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, opaqueVertexCount, static_cast<GLsizei>(count));
+        glEnable(GL_BLEND);
+    }
+
+    // 2) szélek: hátulról-előre, blenddel, mélységteszttel de mélységírás nélkül
+    if (edgeVertexCount > 0) {
+        BindInstanceAttributes(count);
+        glDepthMask(GL_FALSE);
+        glDrawArraysInstanced(GL_TRIANGLES, opaqueVertexCount, edgeVertexCount, static_cast<GLsizei>(count));
+        glDepthMask(GL_TRUE);
+    }
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (measure) {
+        glEndQuery(GL_SAMPLES_PASSED);
+        samplesQueryPending = true;
+    }
+}
+
+void IsoRenderer::RecordMap(CommandBuffer& commands, const std::vector<std::vector<int>>& mapData,
+    const uint8_t* visibility, RenderQueue& edgeQueue, uint32_t edgeBatch)
+{
+    ALLOCATION_SCOPE("IsoRenderer::RecordMap");
+    BuildInstances(mapData, visibility);
+    if (instances.empty())
+        return;
+    UploadInstances();
+
+    // az opaque pass egyetlen parancs; a sorrendje a többi opaque rajzoláshoz képest közömbös
+    if (opaqueVertexCount > 0) {
+        commands.SetMat4(projectionLocation, projection);
+        commands.SetMat4(viewLocation, view);
+        commands.Record(RenderPass::WorldOpaque, 0, MakeCommand(0, opaqueVertexCount, 0, instances.size(),
+            kStateDepthTest | kStateDepthWrite));
+    }
+
+    // A szélek a sorba kerülnek, hátulról-előre sorrendben: a rendezés után minden
+    // csempe-futam egy folytonos példány-tartomány marad (RecordEdges)
+    if (edgeVertexCount > 0) {
+        edgeQueue.Reserve(edgeQueue.GetItems().size() + instances.size());
+        for (size_t i = 0; i < instances.size(); ++i)
+            edgeQueue.Push(instances[i].depth, edgeBatch, static_cast<uint32_t>(i));
+    }
+}
+
+void IsoRenderer::RecordEdges(CommandBuffer& commands, uint32_t order, size_t firstInstance, size_t instanceCount) const
+{
+    if (edgeVertexCount == 0 || instanceCount == 0 || firstInstance + instanceCount > instances.size())
+        return;
+
+    // a szél-sorrendű példányok a puffer második felében
+    commands.SetMat4(projectionLocation, projection);
+    commands.SetMat4(viewLocation, view);
+    commands.Record(RenderPass::WorldBlended, order, MakeCommand(opaqueVertexCount, edgeVertexCount,
+        instances.size() + firstInstance, instanceCount, kStateBlend | kStateDepthTest));
+}
+
+DrawCommand IsoRenderer::MakeCommand(int firstVertex, int vertexCount, size_t baseInstance, size_t instanceCount, uint8_t state) const
+{
+    DrawCommand command;
+    command.program = shader.ID;
+    command.texture = GetAtlasTexture();
+    command.vao = vao;
+    command.primitive = GL_TRIANGLES;
+    command.first = firstVertex;
+    command.count = vertexCount;
+    command.instanceCount = static_cast<int32_t>(instanceCount);
+    command.baseInstance = static_cast<uint32_t>(baseInstance);
+    command.bindInstances = &IsoRenderer::BindInstanceRange;
+    command.binderContext = this;
+    command.state = state;
+    return command;
+}
+
+void IsoRenderer::BindInstanceRange(const void* context, uint32_t baseInstance)
+{
+    const IsoRenderer* renderer = static_cast<const IsoRenderer*>(context);
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->instanceVBO);
+    renderer->BindInstanceAttributes(baseInstance);
 }
 
 glm::vec2 IsoRenderer::ComputeMapOrigin(int rows, int cols) const
@@ -162,4 +353,19 @@ glm::vec2 IsoRenderer::ComputeMapOrigin(int rows, int cols) const
         Globals::WindowWidth * 0.5f - mapW * 0.5f + width * 0.5f,
         Globals::WindowHeight * 0.5f - mapH * 0.5f
     );
+}
+
+glm::ivec2 IsoRenderer::WorldToTile(const glm::vec2& worldPos, int rows, int cols) const
+{
+    // ugyanaz az inverz vetítés, mint a játékos klampelésénél (bias-szal együtt)
+    return GetGrid(rows, cols).WorldToTile(worldPos);
+}
+
+IsoGrid IsoRenderer::GetGrid(int rows, int cols) const
+{
+    IsoGrid grid;
+    grid.origin = ComputeMapOrigin(rows, cols);
+    grid.halfWidth = GetHalfTileWidth();
+    grid.halfHeight = GetHalfTileHeight();
+    return grid;
 }
\ No newline at end of file
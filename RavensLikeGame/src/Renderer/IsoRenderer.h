@@ -1,6 +1,12 @@
 ﻿#pragma once
 #include "Shader.h"
+#include "TileMesh.h"
+#include "TextureCache.h"
+#include "RenderQueue.h"
+#include "CommandBuffer.h"
+#include "../Core/IsoGrid.h"
 #include <array>
+#include <cstdint>
 #include <glm.hpp>
 #include <string>
 #include <vector>
@@ -8,10 +14,40 @@
 class IsoRenderer
 {
 public:
-    IsoRenderer(Shader& shader, const std::string& texturePath);
-    ~IsoRenderer();
+    // az atlasz a cache-ből, háttérben töltődik; a szoros háló akkor épül, amikor megérkezett
+    IsoRenderer(Shader& shader, const std::string& texturePath, TextureCache& textures);
 
-    void DrawMap(const std::vector<std::vector<int>>& mapData);
+    // az atlasz import-beállításai (indításkor ezzel indítható előre a dekódolás)
+    static TextureImportSettings AtlasImportSettings();
+
+    // A szoros háló adatai a rajzolási méreten (az atlasz megérkezéséig a teljes quadé)
+    struct MeshStats
+    {
+        size_t opaqueTriangles = 0;
+        size_t edgeTriangles = 0;
+        float pixelsPerTile = 0.0f;     // a háló területe
+        float blendedPixelsPerTile = 0.0f;
+        float quadPixelsPerTile = 0.0f; // a teljes cella-quad
+    };
+    const MeshStats& GetMeshStats() const { return meshStats; }
+
+    // "--tile-mesh-check": az atlasz hálóját CPU-n raszterizálja, és kiírja a csempénkénti és a
+    // mapTileCount csempés pálya fragmentszámát a teljes quadhoz képest. false, ha a burok látható
+    // texelt vág le, vagy az opaque részbe nem teljesen átlátszatlan texel esik.
+    static bool CheckTileMesh(const std::string& texturePath, int mapTileCount);
+
+    // visibility: opcionális FieldOfView bájt-tömb (sor-folytonos); rejtett csempék kimaradnak,
+    // az emlékezettek sötétebben rajzolódnak. Azonnal rajzol (pl. a lap-cache framebufferébe).
+    void DrawMap(const std::vector<std::vector<int>>& mapData, const uint8_t* visibility = nullptr);
+
+    // Ugyanez parancsokként: az opaque pass egy WorldOpaque parancs, a szélek csempénként
+    // (edgeBatch, példány-sorszám) elemként az edgeQueue-ba kerülnek, hogy a hívó a sprite-okkal
+    // összefésülve rögzítse őket a RecordEdges-szel. A példányokat most tölti fel (GL szál).
+    void RecordMap(CommandBuffer& commands, const std::vector<std::vector<int>>& mapData,
+        const uint8_t* visibility, RenderQueue& edgeQueue, uint32_t edgeBatch);
+
+    // az utolsó RecordMap példányai közül [firstInstance, +instanceCount) szélei, WorldBlended pass
+    void RecordEdges(CommandBuffer& commands, uint32_t order, size_t firstInstance, size_t instanceCount) const;
 
     const glm::mat4& GetProjection() const { return projection; }
     const glm::mat4& GetView() const { return view; }
@@ -20,6 +56,8 @@ public:
     void SetView(const glm::mat4& view);
 
     glm::vec2 ComputeMapOrigin(int rows, int cols) const;
+    glm::ivec2 WorldToTile(const glm::vec2& worldPos, int rows, int cols) const;
+    IsoGrid GetGrid(int rows, int cols) const;
 
     float ScaledWidth()  const { return kTileWidth * kTileScale; }
     float ScaledHeight()  const { return kTileHeight * kTileScale; }
@@ -28,23 +66,66 @@ public:
     float GetHalfTileWidth()  const { return ScaledWidth() * 0.5f; }
     float GetHalfTileHeight() const { return ScaledVisibleHeight() * 0.5f; }
 
+    size_t GetLastDrawnTileCount() const { return instances.size(); }
+
+    // az atlasz és elrendezése más csempe-rajzolóknak (pl. IsoMapTextureRenderer)
+    unsigned int GetAtlasTexture() const { return atlas ? atlas->ID : 0; }
+    const std::array<glm::vec4, 4>& GetTileUvRects() const { return tileUvRects; }
+    int GetTileCount() const { return kTileCount; }
+    float GetRememberedBrightness() const { return kRememberedBrightness; }
+
+    // GL_SAMPLES_PASSED az előző befejezett DrawMap-ből (a két pass együtt; nem blokkol)
+    uint64_t GetLastSamplesPassed() const { return lastSamplesPassed; }
+
 private:
+    // Csempénként egy példány-attribútum rekord (iso.vert 2..4-es location)
+    struct TileInstance
+    {
+        glm::vec2 offset;
+        glm::vec4 uvRect;
+        float brightness;
+        float depth;    // NDC z az iso rendezési kulcsból (IsoGrid::DepthFromSortKey)
+    };
+
     std::array<glm::vec4, 4> tileUvRects;
 
     Shader& shader;
-    unsigned int vao, vbo;
-    unsigned int textureID;
+    GLVertexArray vao;
+    GLBuffer vbo;
+    TileMesh mesh;
+    MeshStats meshStats;
+    int opaqueVertexCount = 0;
+    int edgeVertexCount = 0;
+    GLQuery samplesQuery;
+    bool samplesQueryPending = false;
+    uint64_t lastSamplesPassed = 0;
+    GLBuffer instanceVBO;
+    int projectionLocation = -1;
+    int viewLocation = -1;
+    size_t instanceCapacity = 0;
+    TextureRef atlas;
+    std::vector<TileInstance> instances;
+    std::vector<TileInstance> opaqueInstances;
 
     static constexpr float kTileWidth = 693;
     static constexpr float kTileHeight = 560;
     static constexpr float kTileVisibleHeight = 400;
     static constexpr int kTileCount = 4;
     static constexpr float kTileScale = 0.5f;
+    static constexpr float kRememberedBrightness = 0.35f;
+    static constexpr int kMeshBandHeight = 8;
 
     glm::mat4 projection;
     glm::mat4 view;
 
-    void DrawTile(int tileIndex, const glm::vec2& worldPos);
-    void LoadTexture(const std::string& path);
+    void LoadTexture(const std::string& path, TextureCache& textures);
+    void BuildMesh(const ImportedTexture& image);
+    void UploadMesh();
+    void UpdateMeshStats();
     void InitRenderData();
+    void BindInstanceAttributes(size_t firstInstance) const;
+    void BuildInstances(const std::vector<std::vector<int>>& mapData, const uint8_t* visibility);
+    void UploadInstances();
+    DrawCommand MakeCommand(int firstVertex, int vertexCount, size_t baseInstance, size_t instanceCount, uint8_t state) const;
+    static void BindInstanceRange(const void* context, uint32_t baseInstance);
 };
\ No newline at end of file
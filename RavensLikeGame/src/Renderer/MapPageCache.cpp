@@ -0,0 +1,257 @@
+﻿#include "MapPageCache.h"
+#include "../Core/AllocationTracker.h"
+#include "../Game/TileMap.h"
+#include <glad/glad.h>
+#include <gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+MapPageCache::MapPageCache(Shader& compositeShader, IsoRenderer& iso, size_t budgetBytes)
+    : shader(compositeShader), iso(iso), budgetBytes(budgetBytes)
+{
+    vao = GLVertexArray::Create();
+}
+
+void MapPageCache::Sync(const TileMap& map, const uint8_t* visibility, bool visibilityChanged)
+{
+    ALLOCATION_SCOPE("MapPageCache::Sync");
+    changedCells.clear();
+    const bool sizeChanged = map.GetWidth() != mapWidth || map.GetHeight() != mapHeight;
+    if (sizeChanged || !map.GetChangesSince(syncedRevision, changedCells)) {
+        mapWidth = map.GetWidth();
+        mapHeight = map.GetHeight();
+        cachedVisibility.clear();
+        InvalidateAll();
+    }
+    else {
+        for (const glm::ivec2& cell : changedCells)
+            InvalidateCell(cell.x, cell.y);
+    }
+    syncedRevision = map.GetRevision();
+
+    // a látótér is a kép része: csak a ténylegesen megváltozott csempék lapjai koszolódnak
+    const size_t cellCount = static_cast<size_t>(mapWidth) * mapHeight;
+    if (!visibility) {
+        if (!cachedVisibility.empty()) {
+            cachedVisibility.clear();
+            InvalidateAll();
+        }
+    }
+    else if (cachedVisibility.size() != cellCount) {
+        cachedVisibility.assign(visibility, visibility + cellCount);
+        InvalidateAll();
+    }
+    else if (visibilityChanged) {
+        for (size_t i = 0; i < cellCount; ++i) {
+            if (cachedVisibility[i] != visibility[i]) {
+                cachedVisibility[i] = visibility[i];
+                InvalidateCell(static_cast<int>(i % mapWidth), static_cast<int>(i / mapWidth));
+            }
+        }
+    }
+}
+
+bool MapPageCache::Draw(const TileMap& map, const uint8_t* visibility,
+    const glm::mat4& projection, const glm::mat4& view)
+{
+    lastCompositedPages = 0;
+    lastRenderedPages = 0;
+    if (failed)
+        return false;
+
+    ++frame;
+
+    // az atlasz háttérben töltődik: a helyőrzővel rajzolt lapok a végleges megérkezésekor elavulnak
+    if (iso.GetAtlasTexture() != renderedAtlasTexture) {
+        renderedAtlasTexture = iso.GetAtlasTexture();
+        InvalidateAll();
+    }
+
+    // a kamera által látott világ-téglalap (a képernyő sarkai visszavetítve)
+    const glm::mat4 inverse = glm::inverse(projection * view);
+    glm::vec2 worldMin(INFINITY), worldMax(-INFINITY);
+    for (const glm::vec2 ndc : { glm::vec2(-1, -1), glm::vec2(1, -1), glm::vec2(1, 1), glm::vec2(-1, 1) }) {
+        const glm::vec4 world = inverse * glm::vec4(ndc, 0.0f, 1.0f);
+        worldMin = glm::min(worldMin, glm::vec2(world));
+        worldMax = glm::max(worldMax, glm::vec2(world));
+    }
+
+    const int pageX0 = static_cast<int>(std::floor(worldMin.x / kPageSize));
+    const int pageY0 = static_cast<int>(std::floor(worldMin.y / kPageSize));
+    const int pageX1 = static_cast<int>(std::floor(worldMax.x / kPageSize));
+    const int pageY1 = static_cast<int>(std::floor(worldMax.y / kPageSize));
+
+    // A lapok NEAREST-tel, texel = pixel arányban kerülnek a képre: a világ origóját egész
+    // pixelre toljuk, különben mozgó kameránál a texelek pixelhatárt váltogatnak (remegés).
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const glm::vec2 halfViewport(viewport[2] * 0.5f, viewport[3] * 0.5f);
+    const glm::vec4 origin = projection * view * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    const glm::vec2 originPixels = glm::vec2(origin) / origin.w * halfViewport;
+    const glm::vec2 snapNdc = (glm::round(originPixels) - originPixels) / halfViewport;
+    const glm::mat4 snappedProjection = glm::translate(glm::mat4(1.0f), glm::vec3(snapNdc, 0.0f)) * projection;
+
+    shader.Use();
+    shader.SetMat4("projection", snappedProjection);
+    shader.SetMat4("view", view);
+    shader.SetInt("pageColor", 0);
+    shader.SetInt("pageDepth", 1);
+
+    for (int py = pageY0; py <= pageY1; ++py) {
+        for (int px = pageX0; px <= pageX1; ++px) {
+            auto it = pages.find(PageKey(px, py));
+            if (it == pages.end()) {
+                Page page;
+                if (!CreatePage(page)) {
+                    failed = true;
+                    return false;
+                }
+                it = pages.emplace(PageKey(px, py), std::move(page)).first;
+            }
+
+            Page& page = it->second;
+            page.lastUsedFrame = frame;
+            if (page.dirty) {
+                RenderPage(page, px, py, map, visibility);
+                shader.Use();
+                ++lastRenderedPages;
+            }
+
+            const glm::vec2 pageMin(static_cast<float>(px * kPageSize), static_cast<float>(py * kPageSize));
+            shader.SetVec4("pageRect", glm::vec4(pageMin, pageMin + glm::vec2(static_cast<float>(kPageSize))));
+
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, page.depthTexture);
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, page.colorTexture);
+
+            glBindVertexArray(vao);
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            ++lastCompositedPages;
+        }
+    }
+    glBindVertexArray(0);
+
+    EvictToBudget();
+    return true;
+}
+
+bool MapPageCache::CreatePage(Page& page)
+{
+    page.colorTexture = GLTexture::Create();
+    glBindTexture(GL_TEXTURE_2D, page.colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, kPageSize, kPageSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    page.depthTexture = GLTexture::Create();
+    glBindTexture(GL_TEXTURE_2D, page.depthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, kPageSize, kPageSize, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLint previousFramebuffer = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
+    page.fbo = GLFramebuffer::Create();
+    glBindFramebuffer(GL_FRAMEBUFFER, page.fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, page.colorTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, page.depthTexture, 0);
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Map page framebuffer incomplete: 0x" << std::hex << status << std::dec << std::endl;
+        page = Page();
+        return false;
+    }
+
+    residentBytes += kPageBytes;
+    return true;
+}
+
+
+void MapPageCache::RenderPage(Page& page, int px, int py, const TileMap& map, const uint8_t* visibility)
+{
+    GLint previousFramebuffer = 0;
+    GLint previousViewport[4];
+    GLfloat previousClearColor[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, previousClearColor);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, page.fbo);
+    glViewport(0, 0, kPageSize, kPageSize);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // a lap saját vetítésével, ugyanazzal az (y-felfelé) iránnyal, mint a képernyőn
+    const glm::mat4 savedProjection = iso.GetProjection();
+    const glm::mat4 savedView = iso.GetView();
+    const float x0 = static_cast<float>(px * kPageSize);
+    const float y0 = static_cast<float>(py * kPageSize);
+    iso.SetProjection(glm::ortho(x0, x0 + kPageSize, y0, y0 + kPageSize, -1.0f, 1.0f));
+    iso.SetView(glm::mat4(1.0f));
+    iso.DrawMap(map.GetTiles(), visibility);
+    iso.SetProjection(savedProjection);
+    iso.SetView(savedView);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+    glClearColor(previousClearColor[0], previousClearColor[1], previousClearColor[2], previousClearColor[3]);
+
+    page.dirty = false;
+}
+
+void MapPageCache::InvalidateCell(int x, int y)
+{
+    if (pages.empty())
+        return;
+
+    // a csempe quadja (ahogy az IsoRenderer::DrawMap elhelyezi) mely lapokba lóg bele
+    const glm::vec2 origin = iso.ComputeMapOrigin(mapHeight, mapWidth);
+    const float halfW = iso.GetHalfTileWidth();
+    const float apexX = origin.x + (x - y) * halfW;
+    const float apexY = origin.y + (x + y) * iso.GetHalfTileHeight();
+
+    const int pageX0 = static_cast<int>(std::floor((apexX - halfW) / kPageSize));
+    const int pageX1 = static_cast<int>(std::floor((apexX + halfW) / kPageSize));
+    const int pageY0 = static_cast<int>(std::floor(apexY / kPageSize));
+    const int pageY1 = static_cast<int>(std::floor((apexY + iso.ScaledHeight()) / kPageSize));
+
+    for (int py = pageY0; py <= pageY1; ++py) {
+        for (int px = pageX0; px <= pageX1; ++px) {
+            auto it = pages.find(PageKey(px, py));
+            if (it != pages.end())
+                it->second.dirty = true;
+        }
+    }
+}
+
+void MapPageCache::InvalidateAll()
+{
+    for (auto& entry : pages)
+        entry.second.dirty = true;
+}
+
+void MapPageCache::EvictToBudget()
+{
+    // LRU: a legrégebben használt lapot dobjuk, de az ebben a képkockában látottakat soha
+    while (residentBytes > budgetBytes) {
+        auto oldest = pages.end();
+        for (auto it = pages.begin(); it != pages.end(); ++it)
+            if (it->second.lastUsedFrame != frame && (oldest == pages.end() || it->second.lastUsedFrame < oldest->second.lastUsedFrame))
+                oldest = it;
+        if (oldest == pages.end())
+            break;
+
+        pages.erase(oldest);
+        residentBytes -= kPageBytes;
+    }
+}
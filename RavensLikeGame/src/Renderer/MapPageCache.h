@@ -0,0 +1,78 @@
+﻿#pragma once
+#include "Shader.h"
+#include "IsoRenderer.h"
+#include <cstdint>
+#include <glm.hpp>
+#include <unordered_map>
+#include <vector>
+
+class TileMap;
+
+// A statikus talaj egyszer, offscreen lapokra (kPageSize x kPageSize világ-pixel) rajzolva.
+// Képkockánként csak a kamera által átfedett lapok kerülnek ki egy-egy textúrázott quaddal;
+// a lap újrarajzolása csak akkor kell, ha benne csempe vagy látótér-állapot változott.
+// A lapok mélységet is tárolnak, így a sprite-ok takarása ugyanaz, mint közvetlen rajzolásnál.
+class MapPageCache
+{
+public:
+    static constexpr int kPageSize = 1024;
+    static constexpr size_t kDefaultBudgetBytes = 64u * 1024u * 1024u;
+
+    MapPageCache(Shader& compositeShader, IsoRenderer& iso, size_t budgetBytes = kDefaultBudgetBytes);
+
+    MapPageCache(const MapPageCache&) = delete;
+    MapPageCache& operator=(const MapPageCache&) = delete;
+
+    // Érvénytelenítés a TileMap változásnaplója és a látótér különbsége alapján
+    void Sync(const TileMap& map, const uint8_t* visibility, bool visibilityChanged);
+
+    // false, ha a lapokhoz nem jött létre framebuffer (ilyenkor közvetlenül kell rajzolni)
+    bool Draw(const TileMap& map, const uint8_t* visibility,
+        const glm::mat4& projection, const glm::mat4& view);
+
+    int GetLastCompositedPages() const { return lastCompositedPages; }
+    int GetLastRenderedPages() const { return lastRenderedPages; }
+    size_t GetResidentBytes() const { return residentBytes; }
+
+private:
+    // a lap a GL-objektumai tulajdonosa: a map-ből törölve felszabadulnak
+    struct Page
+    {
+        GLFramebuffer fbo;
+        GLTexture colorTexture;
+        GLTexture depthTexture;
+        bool dirty = true;
+        uint64_t lastUsedFrame = 0;
+    };
+
+    static constexpr size_t kPageBytes = static_cast<size_t>(kPageSize) * kPageSize * 8; // RGBA8 + 24 bites mélység (32 biten)
+
+    Shader& shader;
+    IsoRenderer& iso;
+    size_t budgetBytes;
+    size_t residentBytes = 0;
+    GLVertexArray vao;
+    bool failed = false;
+
+    std::unordered_map<uint64_t, Page> pages;
+    uint64_t frame = 0;
+    int lastCompositedPages = 0;
+    int lastRenderedPages = 0;
+
+    int mapWidth = 0, mapHeight = 0;
+    unsigned int syncedRevision = 0;
+    unsigned int renderedAtlasTexture = 0;
+    std::vector<uint8_t> cachedVisibility;
+    std::vector<glm::ivec2> changedCells;
+
+    static uint64_t PageKey(int px, int py)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(px)) << 32) | static_cast<uint32_t>(py);
+    }
+
+    bool CreatePage(Page& page);
+    void RenderPage(Page& page, int px, int py, const TileMap& map, const uint8_t* visibility);
+    void InvalidateCell(int x, int y);
+    void InvalidateAll();
+    void EvictToBudget();
+};
@@ -0,0 +1,61 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Stabil LSD radix rendezés egész kulcs szerint (RenderQueue, CommandQueue).
+//
+// 11 bites számjegyek: 32 bites kulcsnál 3 menet (11 + 11 + 10 bit) a 8 bites 4 menete
+// helyett, és a menetenkénti hisztogram (8 KB) még L1-ben marad. Minden hisztogram egyetlen
+// olvasással készül; az a menet kimarad, ahol minden kulcs ugyanabba a vödörbe esik
+// (tipikusan a kulcs ritkán változó felső mezői).
+template <typename Item, typename KeyOf>
+void RadixSortByKey(std::vector<Item>& items, std::vector<Item>& scratch, KeyOf keyOf)
+{
+    using Key = std::invoke_result_t<KeyOf, const Item&>;
+    static_assert(std::is_unsigned_v<Key>, "radix sort key must be an unsigned integer");
+
+    constexpr int kDigitBits = 11;
+    constexpr int kKeyBits = static_cast<int>(sizeof(Key) * 8);
+    constexpr int kPasses = (kKeyBits + kDigitBits - 1) / kDigitBits;
+    constexpr uint32_t kBuckets = 1u << kDigitBits;
+
+    const size_t count = items.size();
+    if (count < 2)
+        return;
+
+    // a hisztogramok a veremben: 32 bites kulcsnál 24 KB, 64 bitesnél 48 KB
+    uint32_t histograms[kPasses][kBuckets] = {};
+    for (const Item& item : items) {
+        const Key key = keyOf(item);
+        for (int pass = 0; pass < kPasses; ++pass)
+            ++histograms[pass][(key >> (pass * kDigitBits)) & (kBuckets - 1)];
+    }
+
+    scratch.resize(count);
+    Item* source = items.data();
+    Item* target = scratch.data();
+    for (int pass = 0; pass < kPasses; ++pass) {
+        uint32_t* histogram = histograms[pass];
+        const int shift = pass * kDigitBits;
+
+        // ha minden elem egy vödörben van, a menet nem változtatna a sorrenden
+        if (histogram[(keyOf(source[0]) >> shift) & (kBuckets - 1)] == count)
+            continue;
+
+        uint32_t offset = 0;
+        for (uint32_t bucket = 0; bucket < kBuckets; ++bucket) {
+            const uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+        for (size_t i = 0; i < count; ++i)
+            target[histogram[(keyOf(source[i]) >> shift) & (kBuckets - 1)]++] = source[i];
+        std::swap(source, target);
+    }
+
+    if (source != items.data())
+        items.swap(scratch);
+}
@@ -0,0 +1,105 @@
+﻿#include "RenderQueue.h"
+#include "RadixSort.h"
+#include "../Core/IsoGrid.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MillisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    bool KeyLess(const RenderQueue::Item& a, const RenderQueue::Item& b)
+    {
+        return a.key < b.key;
+    }
+}
+
+uint32_t RenderQueue::MakeKey(float depth, uint32_t batch)
+{
+    // z = 1 (leghátsó) -> 0, z = -1 (legelső) -> max: növekvő kulcs = hátulról-előre
+    constexpr uint32_t kDepthMax = (1u << kDepthBits) - 1;
+    const float backToFront = std::clamp((1.0f - depth) * 0.5f, 0.0f, 1.0f);
+    const uint32_t quantized = static_cast<uint32_t>(std::lround(backToFront * static_cast<float>(kDepthMax)));
+    return (quantized << kBatchBits) | (batch & (kMaxBatches - 1));
+}
+
+void RenderQueue::Clear()
+{
+    items.clear();
+    runs.clear();
+}
+
+void RenderQueue::Sort()
+{
+    const auto start = Clock::now();
+    RadixSort(items, scratch);
+
+    runs.clear();
+    for (uint32_t i = 0; i < items.size(); ++i) {
+        const uint32_t batch = items[i].key & (kMaxBatches - 1);
+        if (!runs.empty() && runs.back().batch == batch)
+            ++runs.back().count;
+        else
+            runs.push_back({ batch, i, 1 });
+    }
+    lastSortMs = MillisecondsSince(start);
+}
+
+void RenderQueue::RadixSort(std::vector<Item>& items, std::vector<Item>& scratch)
+{
+    RadixSortByKey(items, scratch, [](const Item& item) { return item.key; });
+}
+
+void RenderQueue::Benchmark(size_t count, int iterations)
+{
+    // Egy képkocka jellegű minta: egy 64x64-es térkép átlóira szórt mélységek, kevés batch
+    constexpr float kDiagonals = 127.0f;
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> diagonal(0.0f, kDiagonals);
+    std::uniform_int_distribution<uint32_t> batch(0, 3);
+
+    std::vector<Item> input(count);
+    for (size_t i = 0; i < count; ++i)
+        input[i] = { MakeKey(IsoGrid::DepthFromSortKey(diagonal(random)), batch(random)), static_cast<uint32_t>(i) };
+
+    std::vector<Item> work;
+    std::vector<Item> scratch;
+    std::vector<Item> reference = input;
+    std::stable_sort(reference.begin(), reference.end(), KeyLess);
+
+    double radixMs = 0.0, sortMs = 0.0, stableMs = 0.0;
+    bool identical = true;
+    for (int i = 0; i < iterations; ++i) {
+        work = input;
+        auto start = Clock::now();
+        RadixSort(work, scratch);
+        radixMs += MillisecondsSince(start);
+        identical = identical && std::equal(work.begin(), work.end(), reference.begin(),
+            [](const Item& a, const Item& b) { return a.key == b.key && a.index == b.index; });
+
+        work = input;
+        start = Clock::now();
+        std::sort(work.begin(), work.end(), KeyLess);
+        sortMs += MillisecondsSince(start);
+
+        work = input;
+        start = Clock::now();
+        std::stable_sort(work.begin(), work.end(), KeyLess);
+        stableMs += MillisecondsSince(start);
+    }
+
+    const double runs = static_cast<double>(std::max(iterations, 1));
+    std::cout << "Render queue sort, " << count << " items, " << iterations << " iterations (average):\n"
+        << "  radix:            " << radixMs / runs << " ms\n"
+        << "  std::sort:        " << sortMs / runs << " ms\n"
+        << "  std::stable_sort: " << stableMs / runs << " ms\n"
+        << "  radix matches std::stable_sort: " << (identical ? "yes" : "NO") << std::endl;
+}
@@ -0,0 +1,60 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Képkockánkénti rajzolási sor a világ blendelt elemeihez (csempe-szélek, sprite-ok).
+//
+// A mélységteszt a takarást elintézi, de a blendelt pixelek (szélek, nem mélységíró
+// sprite-ok) csak hátulról-előre rajzolva keverednek jól. Ezért minden elem egy 32 bites
+// kulcsot kap: felső bitek = iso mélység hátulról-előre (ugyanaz az NDC z, amit a shader ír),
+// alsó bitek = batch (melyik rajzoló viszi ki). Stabil LSD radix rendezés után az egymás utáni,
+// azonos batch-ű elemek egy futamba olvadnak, amit a hívó egyetlen rajzolással visz ki;
+// azonos kulcsnál a beküldési sorrend marad.
+class RenderQueue
+{
+public:
+    static constexpr int kBatchBits = 8;
+    static constexpr int kDepthBits = 32 - kBatchBits;
+    static constexpr uint32_t kMaxBatches = 1u << kBatchBits;
+
+    struct Item
+    {
+        uint32_t key;
+        uint32_t index;     // a batch saját tömbjében (pl. csempe-példány sorszáma)
+    };
+
+    // first: az első elem a rendezett GetItems()-ben
+    struct Run
+    {
+        uint32_t batch;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    // depth: NDC z (IsoGrid::DepthFromSortKey), nagyobb = hátrébb = előbb rajzolódik
+    static uint32_t MakeKey(float depth, uint32_t batch);
+
+    void Clear();
+    void Reserve(size_t count) { items.reserve(count); }
+    void Push(float depth, uint32_t batch, uint32_t index) { items.push_back({ MakeKey(depth, batch), index }); }
+
+    // rendez és összefűzi a futamokat
+    void Sort();
+
+    const std::vector<Item>& GetItems() const { return items; }
+    const std::vector<Run>& GetRuns() const { return runs; }
+    double GetLastSortMs() const { return lastSortMs; }
+
+    // stabil rendezés kulcs szerint (RadixSortByKey)
+    static void RadixSort(std::vector<Item>& items, std::vector<Item>& scratch);
+
+    // "--bench": count elem rendezése radixszal, std::sort-tal és std::stable_sort-tal
+    static void Benchmark(size_t count, int iterations);
+
+private:
+    std::vector<Item> items;
+    std::vector<Item> scratch;
+    std::vector<Run> runs;
+    double lastSortMs = 0.0;
+};
@@ -1,12 +1,25 @@
 #include "Shader.h"
+#include "ShaderCache.h"
 #include <gtc/type_ptr.hpp>
 #include <iostream>
 
 Shader::Shader(const char* vertexSource, const char* fragmentSource)
+    : Shader(std::string_view(vertexSource), std::string_view(fragmentSource))
 {
+}
+
+// A forrs nem kell, hogy nullval zrdjon: a hosszt tadjuk, gy a lekpezett archvumbl
+// msols nlkl fordthat
+Shader::Shader(std::string_view vertexSource, std::string_view fragmentSource)
+{
+    const char* vertexText = vertexSource.data();
+    const int vertexLength = static_cast<int>(vertexSource.size());
+    const char* fragmentText = fragmentSource.data();
+    const int fragmentLength = static_cast<int>(fragmentSource.size());
+
     // --- Vertex shader ---
     unsigned int vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vertexSource, nullptr);
+    glShaderSource(vertex, 1, &vertexText, &vertexLength);
     glCompileShader(vertex);
 
     int success;
@@ -19,7 +32,7 @@ Shader::Shader(const char* vertexSource, const char* fragmentSource)
 
     // --- Fragment shader ---
     unsigned int fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fragmentSource, nullptr);
+    glShaderSource(fragment, 1, &fragmentText, &fragmentLength);
     glCompileShader(fragment);
 
     glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
@@ -29,7 +42,7 @@ Shader::Shader(const char* vertexSource, const char* fragmentSource)
     }
 
     // --- Program linkelse ---
-    ID = glCreateProgram();
+    ID = GLProgram::Create();
     glAttachShader(ID, vertex);
     glAttachShader(ID, fragment);
     glLinkProgram(ID);
@@ -44,6 +57,12 @@ Shader::Shader(const char* vertexSource, const char* fragmentSource)
     glDeleteShader(fragment);
 }
 
+// Cache-bl vagy httrben fordtva: az els hasznlat (vagy a ShaderCache::FinishPending) vr a linkelsre
+Shader::Shader(ShaderCache& cache, const std::string& name, std::string_view vertexSource, std::string_view fragmentSource)
+    : ID(cache.CreateProgram(name, vertexSource, fragmentSource))
+{
+}
+
 void Shader::Use()
 {
     glUseProgram(ID);
@@ -51,20 +70,36 @@ void Shader::Use()
 
 void Shader::Delete()
 {
-    glDeleteProgram(ID);
+    ID.Reset();
+}
+
+void Shader::SetMat4(const char* name, const glm::mat4& mat) const
+{
+    glUniformMatrix4fv(glGetUniformLocation(ID, name), 1, GL_FALSE, glm::value_ptr(mat));
+}
+
+void Shader::SetVec4(const char* name, const glm::vec4& vec) const
+{
+    glUniform4fv(glGetUniformLocation(ID, name), 1, glm::value_ptr(vec));
+}
+
+// name: a tmb neve index nlkl; egyetlen hvs az egsz tmbre
+void Shader::SetVec4Array(const char* name, const glm::vec4* values, int count) const
+{
+    glUniform4fv(glGetUniformLocation(ID, name), count, glm::value_ptr(values[0]));
 }
 
-void Shader::SetMat4(const std::string& name, const glm::mat4& mat) const
+void Shader::SetVec2(const char* name, const glm::vec2& vec) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    glUniform2fv(glGetUniformLocation(ID, name), 1, glm::value_ptr(vec));
 }
 
-void Shader::SetVec4(const std::string& name, const glm::vec4& vec) const
+void Shader::SetFloat(const char* name, float value) const
 {
-    glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(vec));
+    glUniform1f(glGetUniformLocation(ID, name), value);
 }
 
-void Shader::SetInt(const std::string& name, int value) const
+void Shader::SetInt(const char* name, int value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(glGetUniformLocation(ID, name), value);
 }
\ No newline at end of file
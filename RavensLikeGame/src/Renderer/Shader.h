@@ -1,18 +1,29 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <glad/glad.h>
 #include <glm.hpp>
+#include "GLHandle.h"
+
+class ShaderCache;
 
 class Shader
 {
 public:
-    unsigned int ID;
+    // a program egyetlen tulajdonosa: a Shader csak mozgathat, a rendererek referencit tartanak r
+    GLProgram ID;
 
     Shader(const char* vertexSource, const char* fragmentSource);
+    Shader(std::string_view vertexSource, std::string_view fragmentSource);
+    Shader(ShaderCache& cache, const std::string& name, std::string_view vertexSource, std::string_view fragmentSource);
     void Use();
     void Delete();
 
-    void SetMat4(const std::string& name, const glm::mat4& mat) const;
-    void SetVec4(const std::string& name, const glm::vec4& vec) const;
-    void SetInt(const std::string& name, int value) const;
+    // name: nullval zrd uniform-nv (literlnl nem kell hvsonknt std::string)
+    void SetMat4(const char* name, const glm::mat4& mat) const;
+    void SetVec4(const char* name, const glm::vec4& vec) const;
+    void SetVec4Array(const char* name, const glm::vec4* values, int count) const;
+    void SetVec2(const char* name, const glm::vec2& vec) const;
+    void SetInt(const char* name, int value) const;
+    void SetFloat(const char* name, float value) const;
 };
\ No newline at end of file
@@ -0,0 +1,328 @@
+﻿#include "ShaderCache.h"
+#include <glad/glad.h>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    // KHR_parallel_shader_compile: a glad betöltő nem ismeri a bővítményt, csak ezt az egy enumot használjuk
+    constexpr GLenum kCompletionStatusKhr = 0x91B1;
+
+    constexpr char kCacheMagic[4] = { 'R', 'P', 'R', 'G' };
+    constexpr uint32_t kCacheVersion = 1;
+
+    struct CacheHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t format;
+        uint32_t length;
+    };
+
+    uint64_t Fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::string GetString(GLenum name)
+    {
+        const GLubyte* value = glGetString(name);
+        return value ? reinterpret_cast<const char*>(value) : "";
+    }
+
+    bool HasExtension(const char* name)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; ++i) {
+            const GLubyte* extension = glGetStringi(GL_EXTENSIONS, i);
+            if (extension && std::strcmp(reinterpret_cast<const char*>(extension), name) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    double Milliseconds(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    void ReportCompileError(const std::string& name, const char* stage, unsigned int shader)
+    {
+        int success = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (success)
+            return;
+        char infoLog[512];
+        glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+        std::cerr << "ERROR::SHADER::" << stage << "::COMPILATION_FAILED (" << name << ")\n" << infoLog << std::endl;
+    }
+}
+
+ShaderCache::ShaderCache()
+{
+    driverString = GetString(GL_VENDOR) + '\n' + GetString(GL_RENDERER) + '\n' + GetString(GL_VERSION);
+
+    // 4.1 alatt az ARB_get_program_binary adja ugyanezeket a belépési pontokat; ha nincs
+    // bináris formátum (vagy a lekérdezés ismeretlen), a cache kikapcsol
+    GLint formatCount = 0;
+    if (glad_glGetProgramBinary && glad_glProgramBinary && glad_glProgramParameteri)
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    while (glGetError() != GL_NO_ERROR) {}
+    binarySupported = formatCount > 0;
+
+    parallelSupported = HasExtension("GL_KHR_parallel_shader_compile") || HasExtension("GL_ARB_parallel_shader_compile");
+}
+
+uint64_t ShaderCache::HashSources(std::string_view vertexSource, std::string_view fragmentSource) const
+{
+    const char separator = '\0';
+    uint64_t hash = Fnv1a(&kCacheVersion, sizeof(kCacheVersion));
+    hash = Fnv1a(driverString.data(), driverString.size(), hash);
+    hash = Fnv1a(&separator, 1, hash);
+    hash = Fnv1a(vertexSource.data(), vertexSource.size(), hash);
+    hash = Fnv1a(&separator, 1, hash);
+    return Fnv1a(fragmentSource.data(), fragmentSource.size(), hash);
+}
+
+std::string ShaderCache::CachePath(uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.rprg", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(kCacheDirectory) / name).string();
+}
+
+unsigned int ShaderCache::CreateProgram(const std::string& name, std::string_view vertexSource, std::string_view fragmentSource)
+{
+    const Clock::time_point start = Clock::now();
+    if (!hasRequests) {
+        firstRequest = start;
+        hasRequests = true;
+    }
+
+    const uint64_t key = HashSources(vertexSource, fragmentSource);
+    unsigned int program = glCreateProgram();
+
+    if (binarySupported && LoadBinary(program, key)) {
+        ProgramStat stat;
+        stat.name = name;
+        stat.cacheHit = true;
+        stat.loadMs = Milliseconds(Clock::now() - start);
+        stats.push_back(stat);
+        return program;
+    }
+
+    // elutasított bináris után a programobjektum nem linkelhető újra biztonságosan: újat kérünk
+    glDeleteProgram(program);
+    program = glCreateProgram();
+
+    const char* vertexText = vertexSource.data();
+    const int vertexLength = static_cast<int>(vertexSource.size());
+    const char* fragmentText = fragmentSource.data();
+    const int fragmentLength = static_cast<int>(fragmentSource.size());
+
+    PendingProgram entry;
+    entry.name = name;
+    entry.key = key;
+    entry.program = program;
+    entry.start = start;
+
+    entry.vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(entry.vertex, 1, &vertexText, &vertexLength);
+    glCompileShader(entry.vertex);
+
+    entry.fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(entry.fragment, 1, &fragmentText, &fragmentLength);
+    glCompileShader(entry.fragment);
+
+    // párhuzamos fordítás nélkül a státusz-lekérdezés úgyis megvárná: itt mérjük külön a fordítást
+    if (!parallelSupported) {
+        int success = 0;
+        glGetShaderiv(entry.vertex, GL_COMPILE_STATUS, &success);
+        glGetShaderiv(entry.fragment, GL_COMPILE_STATUS, &success);
+        entry.compiled = Clock::now();
+        entry.compileDone = true;
+    }
+
+    glAttachShader(program, entry.vertex);
+    glAttachShader(program, entry.fragment);
+    if (binarySupported)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program);
+
+    if (parallelSupported)
+        pending.push_back(std::move(entry));
+    else
+        Complete(entry);
+    return program;
+}
+
+bool ShaderCache::IsComplete(unsigned int object, bool isProgram) const
+{
+    if (!parallelSupported)
+        return true;
+    int done = 0;
+    if (isProgram)
+        glGetProgramiv(object, kCompletionStatusKhr, &done);
+    else
+        glGetShaderiv(object, kCompletionStatusKhr, &done);
+    return done != 0;
+}
+
+void ShaderCache::Complete(PendingProgram& entry)
+{
+    ProgramStat stat;
+    stat.name = entry.name;
+
+    // a státusz-lekérdezés a link végéig vár; ha a fordítás végét nem láttuk külön, az egész fordításnak számít
+    int success = 0;
+    glGetProgramiv(entry.program, GL_LINK_STATUS, &success);
+    const Clock::time_point linked = Clock::now();
+    if (!entry.compileDone)
+        entry.compiled = linked;
+    stat.compileMs = Milliseconds(entry.compiled - entry.start);
+    stat.linkMs = Milliseconds(linked - entry.compiled);
+
+    ReportCompileError(entry.name, "VERTEX", entry.vertex);
+    ReportCompileError(entry.name, "FRAGMENT", entry.fragment);
+
+    if (!success) {
+        char infoLog[512];
+        glGetProgramInfoLog(entry.program, 512, nullptr, infoLog);
+        std::cerr << "ERROR::SHADER::PROGRAM::LINK_FAILED (" << entry.name << ")\n" << infoLog << std::endl;
+        stat.failed = true;
+    }
+    else if (binarySupported) {
+        SaveBinary(entry.program, entry.key);
+    }
+
+    glDetachShader(entry.program, entry.vertex);
+    glDetachShader(entry.program, entry.fragment);
+    glDeleteShader(entry.vertex);
+    glDeleteShader(entry.fragment);
+    stats.push_back(stat);
+}
+
+void ShaderCache::FinishPending()
+{
+    while (!pending.empty()) {
+        bool progressed = false;
+        for (size_t i = 0; i < pending.size();) {
+            PendingProgram& entry = pending[i];
+            if (!entry.compileDone && IsComplete(entry.vertex, false) && IsComplete(entry.fragment, false)) {
+                entry.compiled = Clock::now();
+                entry.compileDone = true;
+                progressed = true;
+            }
+            if (IsComplete(entry.program, true)) {
+                Complete(entry);
+                pending.erase(pending.begin() + i);
+                progressed = true;
+                continue;
+            }
+            ++i;
+        }
+        if (!progressed)
+            std::this_thread::yield();
+    }
+
+    PrintReport();
+}
+
+bool ShaderCache::LoadBinary(unsigned int program, uint64_t key) const
+{
+    std::ifstream file(CachePath(key), std::ios::binary);
+    if (!file)
+        return false;
+
+    CacheHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0
+        || header.version != kCacheVersion || header.key != key
+        || header.length == 0 || header.length > 64u * 1024 * 1024)
+        return false;
+
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), static_cast<std::streamsize>(binary.size())))
+        return false;
+
+    glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+    int success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    while (glGetError() != GL_NO_ERROR) {}
+    return success != 0;
+}
+
+void ShaderCache::SaveBinary(unsigned int program, uint64_t key) const
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0)
+        return;
+
+    // a cache csak gyorsítás: ha nem írható, szólunk, de a program ettől még használható
+    const std::string cachePath = CachePath(key);
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+    std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Shader cache not writable: " << cachePath << std::endl;
+        return;
+    }
+
+    CacheHeader header{};
+    std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+    header.version = kCacheVersion;
+    header.key = key;
+    header.format = format;
+    header.length = static_cast<uint32_t>(written);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), written);
+}
+
+void ShaderCache::PrintReport() const
+{
+    if (stats.empty())
+        return;
+
+    int hits = 0;
+    double loadMs = 0.0, compileMs = 0.0, linkMs = 0.0;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Shader programs (binary cache " << (binarySupported ? "on" : "unsupported")
+        << ", parallel compile " << (parallelSupported ? "on" : "unsupported") << "):" << std::endl;
+    for (const ProgramStat& stat : stats) {
+        std::cout << "  " << std::left << std::setw(18) << stat.name << std::right;
+        if (stat.cacheHit)
+            std::cout << "cache hit " << stat.loadMs << " ms";
+        else
+            std::cout << "compile " << stat.compileMs << " ms, link " << stat.linkMs << " ms" << (stat.failed ? " (FAILED)" : "");
+        std::cout << std::endl;
+
+        hits += stat.cacheHit ? 1 : 0;
+        loadMs += stat.loadMs;
+        compileMs += stat.compileMs;
+        linkMs += stat.linkMs;
+    }
+    std::cout << "  " << hits << "/" << stats.size() << " from cache, load " << loadMs << " ms, compile "
+        << compileMs << " ms, link " << linkMs << " ms, wall " << Milliseconds(Clock::now() - firstRequest) << " ms"
+        << std::defaultfloat << std::endl;
+}
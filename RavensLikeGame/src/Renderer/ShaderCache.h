@@ -0,0 +1,74 @@
+﻿#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Shader programok lemezes cache-e (glGetProgramBinary / glProgramBinary).
+//
+// A kulcs a forrás és a meghajtó (GL_VENDOR, GL_RENDERER, GL_VERSION) hash-e: más driveren vagy
+// módosított forrással új bináris készül. Ha a driver a binárist mégis elutasítja (pl. frissítés
+// után azonos verziószöveggel), újrafordítunk és felülírjuk. KHR_parallel_shader_compile mellett
+// a CreateProgram nem vár a fordításra: a programok a textúra-betöltéssel párhuzamosan készülnek,
+// és csak a FinishPending (vagy az első használat) vár rájuk.
+// Csak a GL kontextus szálán használható, a kontextus létrehozása után.
+class ShaderCache
+{
+public:
+    static constexpr const char* kCacheDirectory = "cache/shaders";
+
+    ShaderCache();
+
+    // A program azonnal kap azonosítót; cache-találatnál kész, különben a fordítás/linkelés még futhat
+    unsigned int CreateProgram(const std::string& name, std::string_view vertexSource, std::string_view fragmentSource);
+
+    // Megvárja a folyamatban lévő programokat, kiírja a hibákat, elmenti a binárisokat és a riportot
+    void FinishPending();
+
+    bool IsBinaryCacheSupported() const { return binarySupported; }
+    bool IsParallelCompileSupported() const { return parallelSupported; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct PendingProgram
+    {
+        std::string name;
+        uint64_t key = 0;
+        unsigned int program = 0;
+        unsigned int vertex = 0;
+        unsigned int fragment = 0;
+        Clock::time_point start;
+        Clock::time_point compiled;
+        bool compileDone = false;
+    };
+
+    struct ProgramStat
+    {
+        std::string name;
+        bool cacheHit = false;
+        bool failed = false;
+        double loadMs = 0.0;
+        double compileMs = 0.0;
+        double linkMs = 0.0;
+    };
+
+    uint64_t HashSources(std::string_view vertexSource, std::string_view fragmentSource) const;
+    std::string CachePath(uint64_t key) const;
+    bool LoadBinary(unsigned int program, uint64_t key) const;
+    void SaveBinary(unsigned int program, uint64_t key) const;
+
+    bool IsComplete(unsigned int object, bool isProgram) const;
+    void Complete(PendingProgram& pending);
+    void PrintReport() const;
+
+    bool binarySupported = false;
+    bool parallelSupported = false;
+    std::string driverString;
+
+    std::vector<PendingProgram> pending;
+    std::vector<ProgramStat> stats;
+    Clock::time_point firstRequest;
+    bool hasRequests = false;
+};
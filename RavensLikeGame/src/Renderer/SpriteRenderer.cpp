@@ -2,18 +2,24 @@
 #include <glad/glad.h>
 #include <gtc/matrix_transform.hpp>
 
-SpriteRenderer::SpriteRenderer(const Shader& shader)
+SpriteRenderer::SpriteRenderer(Shader& shader)
     : shader(shader)
 {
     InitRenderData();
-}
 
-SpriteRenderer::~SpriteRenderer() {
-    glDeleteVertexArrays(1, &quadVAO);
+    // a rögzítés GL nélkül fut (akár worker szálon), ezért a helyek előre lekérdezve
+    locations.model = glGetUniformLocation(shader.ID, "model");
+    locations.view = glGetUniformLocation(shader.ID, "view");
+    locations.projection = glGetUniformLocation(shader.ID, "projection");
+    locations.useView = glGetUniformLocation(shader.ID, "useView");
+    locations.useColorOnly = glGetUniformLocation(shader.ID, "useColorOnly");
+    locations.spriteColor = glGetUniformLocation(shader.ID, "spriteColor");
+    locations.uvRect = glGetUniformLocation(shader.ID, "uvRect");
+    locations.sprite = glGetUniformLocation(shader.ID, "sprite");
+    locations.depth = glGetUniformLocation(shader.ID, "depth");
 }
 
 void SpriteRenderer::InitRenderData() {
-    unsigned int VBO;
     float quadVertices[] = {
         // pos      // tex
         0.0f, 1.0f,  0.0f, 1.0f,
@@ -25,10 +31,10 @@ void SpriteRenderer::InitRenderData() {
         1.0f, 0.0f,  1.0f, 0.0f
     };
 
-    glGenVertexArrays(1, &quadVAO);
-    glGenBuffers(1, &VBO);
+    quadVAO = GLVertexArray::Create();
+    quadVBO = GLBuffer::Create();
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
 
     glBindVertexArray(quadVAO);
@@ -87,4 +93,32 @@ void SpriteRenderer::DrawSpriteRegion(const Texture& texture, const glm::vec2& p
     glBindVertexArray(0);
 
     texture.Unbind();
-}
\ No newline at end of file
+}
+
+void SpriteRenderer::RecordSpriteRegion(CommandBuffer& commands, RenderPass pass, uint32_t order,
+    const Texture& texture, const glm::vec2& position, const glm::vec2& size, const glm::vec4& uvRect,
+    const glm::mat4& projection, const glm::mat4& view, float depth) const
+{
+    // a sorrendet a CommandQueue dönti el: minden uniformot magával visz, amire a rajzolás épít
+    glm::mat4 model(1.0f);
+    model = glm::translate(model, glm::vec3(position, 0.0f));
+    model = glm::scale(model, glm::vec3(size, 1.0f));
+
+    commands.SetMat4(locations.projection, projection);
+    commands.SetMat4(locations.view, view);
+    commands.SetMat4(locations.model, model);
+    commands.SetInt(locations.useView, 1);
+    commands.SetInt(locations.useColorOnly, 0);
+    commands.SetVec3(locations.spriteColor, glm::vec3(1.0f));
+    commands.SetVec4(locations.uvRect, uvRect);
+    commands.SetInt(locations.sprite, 0);
+    commands.SetFloat(locations.depth, depth);
+
+    DrawCommand command;
+    command.program = shader.ID;
+    command.texture = texture.ID;
+    command.vao = quadVAO;
+    command.primitive = GL_TRIANGLES;
+    command.count = 6;
+    commands.Record(pass, order, command);
+}
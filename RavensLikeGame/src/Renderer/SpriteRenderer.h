@@ -1,21 +1,31 @@
 #pragma once
 #include "Shader.h"
 #include "Texture.h"
+#include "CommandBuffer.h"
 #include <glm.hpp>
 
 class SpriteRenderer
 {
 public:
-    SpriteRenderer(const Shader& shader);
-    ~SpriteRenderer();
+    SpriteRenderer(Shader& shader);
 
     void DrawSprite(const Texture& texture, const glm::vec2& position, const glm::vec2& size, float rotation = 0.0f);
 
     void DrawSpriteRegion(const Texture& texture, const glm::vec2& position, const glm::vec2& size, const glm::vec4& uvRect);
 
+    void RecordSpriteRegion(CommandBuffer& commands, RenderPass pass, uint32_t order,
+        const Texture& texture, const glm::vec2& position, const glm::vec2& size, const glm::vec4& uvRect,
+        const glm::mat4& projection, const glm::mat4& view, float depth) const;
+
 private:
-    Shader shader;
-    unsigned int quadVAO;
+    Shader& shader;
+    GLVertexArray quadVAO;
+    GLBuffer quadVBO;
+
+    struct UniformLocations
+    {
+        int model, view, projection, useView, useColorOnly, spriteColor, uvRect, sprite, depth;
+    } locations;
 
     void InitRenderData();
 };
\ No newline at end of file
@@ -1,52 +1,48 @@
 #include "Texture.h"
-#include <iostream>
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
-Texture::Texture() : ID(0), Width(0), Height(0), Channels(0) {}
+Texture::Texture() : Width(0), Height(0), Channels(0), Bytes(0) {}
 
 Texture::~Texture() {
     Delete();
 }
 
-bool Texture::LoadFromFile(const std::string& path) {
-    stbi_set_flip_vertically_on_load(false);
-    unsigned char* data = stbi_load(path.c_str(), &Width, &Height, &Channels, 0);
-    if (!data) {
-        std::cerr << "Failed to load texture: " << path << std::endl;
-        return false;
-    }
-
-    glGenTextures(1, &ID);
-    glBindTexture(GL_TEXTURE_2D, ID);
+Texture::Texture(Texture&& other) noexcept
+    : ID(std::move(other.ID)), Width(other.Width), Height(other.Height), Channels(other.Channels), Bytes(other.Bytes) {
+    other.Bytes = 0;
+}
 
-    GLenum format = GL_RGBA;
-    switch (Channels)
-    {
-        case 1:
-            format = GL_RED;
-		    break;
-        case 3:
-			format = GL_RGB;
-            break;
-		case 4:
-            format = GL_RGBA;
-			break;
-        default:
-            break;
+Texture& Texture::operator=(Texture&& other) noexcept {
+    if (this != &other) {
+        ID = std::move(other.ID);
+        Width = other.Width;
+        Height = other.Height;
+        Channels = other.Channels;
+        Bytes = other.Bytes;
+        other.Bytes = 0;
     }
+    return *this;
+}
 
-    glTexImage2D(GL_TEXTURE_2D, 0, format, Width, Height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+bool Texture::LoadFromFile(const std::string& path) {
+    return LoadFromFile(path, TextureImportSettings());
+}
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+bool Texture::LoadFromFile(const std::string& path, const TextureImportSettings& settings) {
+    ImportedTexture image;
+    if (!TextureImporter::Import(path, settings, image))
+        return false;
+    return LoadFromImage(image, settings);
+}
 
-    glBindTexture(GL_TEXTURE_2D, 0);
-    stbi_image_free(data);
-    return true;
+bool Texture::LoadFromImage(const ImportedTexture& image, const TextureImportSettings& settings) {
+    ID = GLTexture(TextureImporter::Upload(image, settings));
+    Width = image.Width();
+    Height = image.Height();
+    Channels = 4;
+    Bytes = ID ? image.ByteSize() : 0;
+    return ID != 0;
 }
 
 void Texture::Bind(unsigned int unit) const {
@@ -59,8 +55,6 @@ void Texture::Unbind() const {
 }
 
 void Texture::Delete() {
-    if (ID) {
-        glDeleteTextures(1, &ID);
-        ID = 0;
-    }
+    ID.Reset();
+    Bytes = 0;
 }
\ No newline at end of file
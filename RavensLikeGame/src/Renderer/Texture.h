@@ -1,17 +1,27 @@
 #pragma once
 #include <string>
 #include <glad/glad.h>
+#include "GLHandle.h"
+#include "TextureImporter.h"
 
 class Texture
 {
 public:
-    unsigned int ID;
+    GLTexture ID;
     int Width, Height, Channels;
+    size_t Bytes;
 
     Texture();
     ~Texture();
 
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+    Texture(Texture&& other) noexcept;
+    Texture& operator=(Texture&& other) noexcept;
+
     bool LoadFromFile(const std::string& path);
+    bool LoadFromFile(const std::string& path, const TextureImportSettings& settings);
+    bool LoadFromImage(const ImportedTexture& image, const TextureImportSettings& settings);
     void Bind(unsigned int unit = 0) const;
     void Unbind() const;
     void Delete();
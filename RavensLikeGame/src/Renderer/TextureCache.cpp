@@ -0,0 +1,309 @@
+﻿#include "TextureCache.h"
+#include "../Core/AllocationTracker.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+namespace
+{
+    // betöltés alatt: 1x1, félig átlátszó szürke (premultiplikált)
+    constexpr uint8_t kPlaceholderPixel[4] = { 48, 48, 48, 96 };
+}
+
+TextureRef::TextureRef(TextureCache* cache, Entry* entry)
+    : cache(cache), entry(entry)
+{
+    ++entry->refCount;
+}
+
+TextureRef::TextureRef(const TextureRef& other)
+    : cache(other.cache), entry(other.entry)
+{
+    if (entry)
+        ++entry->refCount;
+}
+
+TextureRef& TextureRef::operator=(const TextureRef& other)
+{
+    if (entry != other.entry) {
+        if (other.entry)
+            ++other.entry->refCount;
+        Reset();
+        cache = other.cache;
+        entry = other.entry;
+    }
+    return *this;
+}
+
+TextureRef::TextureRef(TextureRef&& other) noexcept
+    : cache(other.cache), entry(other.entry)
+{
+    other.cache = nullptr;
+    other.entry = nullptr;
+}
+
+TextureRef& TextureRef::operator=(TextureRef&& other) noexcept
+{
+    if (this != &other) {
+        Reset();
+        cache = other.cache;
+        entry = other.entry;
+        other.cache = nullptr;
+        other.entry = nullptr;
+    }
+    return *this;
+}
+
+void TextureRef::Reset()
+{
+    if (entry)
+        cache->Release(entry);
+    cache = nullptr;
+    entry = nullptr;
+}
+
+const Texture& TextureRef::operator*() const
+{
+    return entry->texture;
+}
+
+bool TextureRef::IsReady() const
+{
+    return entry && !entry->pending;
+}
+
+TextureCache::TextureCache(size_t budgetBytes)
+    : budgetBytes(budgetBytes)
+{
+}
+
+TextureCache::TextureCache(ThreadPool& pool, size_t budgetBytes)
+    : budgetBytes(budgetBytes), loader(std::make_unique<AsyncTextureLoader>(pool))
+{
+}
+
+TextureCache::~TextureCache()
+{
+    // előbb a betöltő: megvárja a futó dekódolásokat és eldobja a félkész feltöltéseket
+    loader.reset();
+
+    for (const auto& item : entries)
+        if (item.second->refCount > 0)
+            std::cerr << "TextureCache destroyed with " << item.second->refCount
+                << " live reference(s) to " << item.first << std::endl;
+}
+
+std::string TextureCache::MakeKey(const std::string& path, const TextureImportSettings& settings)
+{
+    char hash[20];
+    std::snprintf(hash, sizeof(hash), "%016llx|", static_cast<unsigned long long>(TextureImporter::HashSettings(settings)));
+    return hash + path;
+}
+
+TextureRef TextureCache::Acquire(const std::string& path, const TextureImportSettings& settings)
+{
+    return AcquireLoaded(path, settings, false);
+}
+
+TextureRef TextureCache::AcquireLoaded(const std::string& path, const TextureImportSettings& settings, bool keepImage)
+{
+    const std::string key = MakeKey(path, settings);
+
+    auto it = entries.find(key);
+    if (it == entries.end() || (keepImage && !it->second->image)) {
+        ImportedTexture image;
+        if (!TextureImporter::Import(path, settings, image))
+            return TextureRef();
+
+        if (it == entries.end()) {
+            auto entry = std::make_unique<Entry>();
+            if (!entry->texture.LoadFromImage(image, settings))
+                return TextureRef();
+
+            residentBytes += entry->texture.Bytes;
+            it = entries.emplace(key, std::move(entry)).first;
+        }
+        if (keepImage)
+            it->second->image = std::make_unique<ImportedTexture>(std::move(image));
+    }
+
+    Entry* entry = it->second.get();
+    entry->lastUsed = ++useCounter;
+    entry->keepImage = entry->keepImage || keepImage;
+    TextureRef ref(this, entry);
+
+    // az új textúra után kerülhetünk a keret fölé; a most kért persze nem esik ki
+    if (residentBytes > budgetBytes)
+        Trim();
+    return ref;
+}
+
+TextureRef TextureCache::AcquireAsync(const std::string& path, const TextureImportSettings& settings, ReadyCallback onReady)
+{
+    if (!loader) {
+        TextureRef ref = AcquireLoaded(path, settings, static_cast<bool>(onReady));
+        if (ref && onReady)
+            onReady(*ref.entry->image);
+        return ref;
+    }
+
+    const std::string key = MakeKey(path, settings);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        int width, height;
+        if (!TextureImporter::ReadInfo(path, settings, width, height))
+            return TextureRef();
+
+        auto entry = std::make_unique<Entry>();
+        Texture& texture = entry->texture;
+        texture.ID = GLTexture::Create();
+        glBindTexture(GL_TEXTURE_2D, texture.ID);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, kPlaceholderPixel);
+        TextureImporter::ConfigureSampling(1, settings);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        texture.Width = width;
+        texture.Height = height;
+        texture.Channels = 4;
+        texture.Bytes = sizeof(kPlaceholderPixel);
+
+        entry->pending = true;
+        residentBytes += texture.Bytes;
+
+        // előre indított betöltésnél nem dekódolunk újra, csak átvesszük a jegyét
+        uint64_t ticket;
+        auto prefetched = prefetchedTickets.find(key);
+        if (prefetched != prefetchedTickets.end()) {
+            ticket = prefetched->second;
+            prefetchedTickets.erase(prefetched);
+        }
+        else {
+            ticket = loader->Request(path, settings);
+        }
+        pendingByTicket.emplace(ticket, entry.get());
+        it = entries.emplace(key, std::move(entry)).first;
+    }
+
+    Entry* entry = it->second.get();
+    entry->lastUsed = ++useCounter;
+    TextureRef ref(this, entry);
+
+    if (onReady) {
+        entry->keepImage = true;
+        if (entry->image) {
+            onReady(*entry->image);
+        }
+        else {
+            // rezidens, de kép nélkül töltötték be: a textúra marad használatban, a lánc háttérben
+            // újra dekódolódik, és az Update a friss feltöltéssel együtt adja át
+            if (!entry->pending && entry->onReady.empty())
+                pendingByTicket.emplace(loader->Request(path, settings), entry);
+            entry->onReady.push_back(std::move(onReady));
+        }
+    }
+    else if (!entry->keepImage) {
+        entry->image.reset();   // az előre betöltött képre senki nem tart igényt
+    }
+    return ref;
+}
+
+void TextureCache::Prefetch(const std::string& path, const TextureImportSettings& settings)
+{
+    if (!loader)
+        return;
+
+    const std::string key = MakeKey(path, settings);
+    if (entries.count(key) == 0 && prefetchedTickets.count(key) == 0)
+        prefetchedTickets.emplace(key, loader->Request(path, settings));
+}
+
+void TextureCache::Update(size_t uploadBudgetBytes)
+{
+    ALLOCATION_SCOPE("TextureCache::Update");
+    if (!loader)
+        return;
+
+    completed.clear();
+    loader->Update(uploadBudgetBytes, completed);
+
+    for (AsyncTextureLoader::Completed& done : completed) {
+        auto pendingIt = pendingByTicket.find(done.ticket);
+        if (pendingIt == pendingByTicket.end()) {
+            // előre indított, még senki által nem kért betöltés: hivatkozatlanul a cache-be kerül
+            auto prefetched = std::find_if(prefetchedTickets.begin(), prefetchedTickets.end(),
+                [&](const auto& item) { return item.second == done.ticket; });
+            if (prefetched != prefetchedTickets.end() && done.texture != 0) {
+                auto entry = std::make_unique<Entry>();
+                entry->texture.ID = std::move(done.texture);
+                entry->texture.Width = done.image.Width();
+                entry->texture.Height = done.image.Height();
+                entry->texture.Channels = 4;
+                entry->texture.Bytes = done.image.ByteSize();
+                entry->lastUsed = ++useCounter;
+                // az első AcquireAsync dönti el, kell-e a kép az onReady-hez
+                entry->image = std::make_unique<ImportedTexture>(std::move(done.image));
+                residentBytes += entry->texture.Bytes;
+                entries.emplace(prefetched->first, std::move(entry));
+            }
+            else {
+                done.texture.Reset();
+            }
+            if (prefetched != prefetchedTickets.end())
+                prefetchedTickets.erase(prefetched);
+            continue;
+        }
+        Entry* entry = pendingIt->second;
+        pendingByTicket.erase(pendingIt);
+        entry->pending = false;
+
+        // sikertelen betöltésnél a helyőrző marad (a hibát az importer már kiírta)
+        const bool loaded = done.texture != 0;
+        if (loaded) {
+            residentBytes -= entry->texture.Bytes;
+            entry->texture.ID = std::move(done.texture);
+            entry->texture.Width = done.image.Width();
+            entry->texture.Height = done.image.Height();
+            entry->texture.Bytes = done.image.ByteSize();
+            residentBytes += entry->texture.Bytes;
+        }
+
+        std::vector<ReadyCallback> callbacks = std::move(entry->onReady);
+        entry->onReady.clear();
+        if (loaded && entry->refCount > 0)
+            for (ReadyCallback& callback : callbacks)
+                callback(done.image);
+        if (loaded && entry->keepImage)
+            entry->image = std::make_unique<ImportedTexture>(std::move(done.image));
+    }
+
+    if (residentBytes > budgetBytes)
+        Trim();
+}
+
+void TextureCache::Release(Entry* entry)
+{
+    --entry->refCount;
+    if (entry->refCount == 0 && residentBytes > budgetBytes)
+        Trim();
+}
+
+void TextureCache::Trim()
+{
+    while (residentBytes > budgetBytes) {
+        auto oldest = entries.end();
+        for (auto it = entries.begin(); it != entries.end(); ++it)
+            if (it->second->refCount == 0 && !it->second->pending && it->second->onReady.empty() && (oldest == entries.end() || it->second->lastUsed < oldest->second->lastUsed))
+                oldest = it;
+        if (oldest == entries.end())
+            break; // minden rezidens textúra használatban van
+
+        residentBytes -= oldest->second->texture.Bytes;
+        entries.erase(oldest);
+    }
+}
+
+void TextureCache::SetBudget(size_t bytes)
+{
+    budgetBytes = bytes;
+    Trim();
+}
@@ -0,0 +1,127 @@
+﻿#pragma once
+#include "Texture.h"
+#include "TextureImporter.h"
+#include "AsyncTextureLoader.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TextureCache;
+class ThreadPool;
+
+// Referenciaszámlált kézi a cache egy textúrájára. Másolható (a számláló nő) és mozgatható;
+// az utolsó kézi elengedése után a textúra még rezidens marad, amíg a keret ki nem szorítja.
+// A cache-nek túl kell élnie minden kezét.
+class TextureRef
+{
+public:
+    TextureRef() = default;
+    ~TextureRef() { Reset(); }
+
+    TextureRef(const TextureRef& other);
+    TextureRef& operator=(const TextureRef& other);
+    TextureRef(TextureRef&& other) noexcept;
+    TextureRef& operator=(TextureRef&& other) noexcept;
+
+    void Reset();
+
+    explicit operator bool() const { return entry != nullptr; }
+    // false, amíg a háttérben töltődik (addig helyőrző textúra, de a mérete már a végleges)
+    bool IsReady() const;
+    const Texture& operator*() const;
+    const Texture* operator->() const { return &**this; }
+
+private:
+    friend class TextureCache;
+    struct Entry;
+
+    TextureRef(TextureCache* cache, Entry* entry);
+
+    TextureCache* cache = nullptr;
+    Entry* entry = nullptr;
+};
+
+// Útvonal + import-beállítások szerint egyszer dekódolt és feltöltött textúrák.
+// A VRAM-használat (a teljes mip-lánccal) számolva van; ha a keret fölé megy, a nem
+// hivatkozott textúrák a legrégebben kért elöl kerülnek ki.
+// Thread poollal az AcquireAsync a dekódolást a worker szálakra teszi (AsyncTextureLoader).
+class TextureCache
+{
+public:
+    static constexpr size_t kDefaultBudgetBytes = 256u * 1024u * 1024u;
+    static constexpr size_t kDefaultUploadBytesPerFrame = 4u * 1024u * 1024u;
+
+    using ReadyCallback = std::function<void(const ImportedTexture&)>;
+
+    explicit TextureCache(size_t budgetBytes = kDefaultBudgetBytes);
+    explicit TextureCache(ThreadPool& pool, size_t budgetBytes = kDefaultBudgetBytes);
+    ~TextureCache();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    // Üres kézi, ha a fájl nem tölthető be
+    TextureRef Acquire(const std::string& path, const TextureImportSettings& settings);
+    TextureRef Acquire(const std::string& path) { return Acquire(path, TextureImportSettings()); }
+
+    // Azonnal visszatér (csak a fejlécet olvassa); a kép háttérben dekódolódik, addig helyőrző
+    // látszik. onReady a GL szálon, az Update-ből fut a CPU-oldali lánccal, amikor a végleges
+    // textúra a helyére került; elmarad, ha addigra senki nem hivatkozik a textúrára.
+    // Már betöltött textúránál azonnal fut a bejegyzésben megtartott CPU-oldali lánccal: ezt a
+    // cache azoknál a textúráknál őrzi meg (a VRAM-keretbe nem számolva), amelyekre onReady-t kértek.
+    // Ha egy onReady nélkül betöltött textúrára később kérnek onReady-t, a kép háttérben újra
+    // dekódolódik (a GL szálon nem), és a hívás az Update-ből fut.
+    TextureRef AcquireAsync(const std::string& path, const TextureImportSettings& settings, ReadyCallback onReady = {});
+    TextureRef AcquireAsync(const std::string& path) { return AcquireAsync(path, TextureImportSettings()); }
+
+    // Indításhoz, akár a GL kontextus előtt (a fő szálról): elindítja a dekódolást, helyőrző és
+    // kézi nélkül. A későbbi AcquireAsync ugyanerre a kulcsra ezt a betöltést veszi át; ha addig
+    // elkészül, az Update hivatkozatlan (kiszorítható) bejegyzésként teszi a cache-be.
+    void Prefetch(const std::string& path, const TextureImportSettings& settings);
+
+    // GL szál, képkockánként egyszer: a kész dekódolások feltöltése legfeljebb ennyi bájtig
+    void Update(size_t uploadBudgetBytes = kDefaultUploadBytesPerFrame);
+    size_t GetPendingCount() const { return pendingByTicket.size() + prefetchedTickets.size(); }
+
+    // A nem hivatkozott textúrák kiszorítása, amíg a keret fölött vagyunk
+    void Trim();
+
+    void SetBudget(size_t bytes);
+    size_t GetBudget() const { return budgetBytes; }
+    size_t GetResidentBytes() const { return residentBytes; }
+    size_t GetTextureCount() const { return entries.size(); }
+
+private:
+    friend class TextureRef;
+    using Entry = TextureRef::Entry;
+
+    size_t budgetBytes;
+    size_t residentBytes = 0;
+    uint64_t useCounter = 0;
+    std::unordered_map<std::string, std::unique_ptr<Entry>> entries;
+
+    std::unique_ptr<AsyncTextureLoader> loader;
+    std::unordered_map<uint64_t, Entry*> pendingByTicket;
+    std::unordered_map<std::string, uint64_t> prefetchedTickets;
+    std::vector<AsyncTextureLoader::Completed> completed;
+
+    static std::string MakeKey(const std::string& path, const TextureImportSettings& settings);
+    // betöltő nélküli út: egy importból tölt fel, és keepImage-nél a képet is megtartja
+    TextureRef AcquireLoaded(const std::string& path, const TextureImportSettings& settings, bool keepImage);
+    void Release(Entry* entry);
+};
+
+struct TextureRef::Entry
+{
+    Texture texture;
+    int refCount = 0;
+    uint64_t lastUsed = 0;
+    bool pending = false;
+    std::vector<TextureCache::ReadyCallback> onReady;   // nem üres, amíg a bejegyzés jegye fut
+    // CPU-oldali lánc az onReady-hez; előre betöltött bejegyzésnél az első AcquireAsync-ig is
+    std::unique_ptr<ImportedTexture> image;
+    bool keepImage = false;
+};
@@ -0,0 +1,321 @@
+﻿#include "TextureImporter.h"
+#include "../Core/VirtualFileSystem.h"
+#include <glad/glad.h>
+#include "stb_image.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    constexpr char kCacheMagic[4] = { 'R', 'T', 'E', 'X' };
+    constexpr uint32_t kCacheVersion = 1;
+
+    struct CacheHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        uint32_t levelCount;
+        uint32_t reserved;
+    };
+
+    uint64_t Fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint32_t PackPixel(const uint8_t* p)
+    {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+            | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+}
+
+size_t ImportedTexture::ByteSize() const
+{
+    size_t bytes = 0;
+    for (const Level& level : levels)
+        bytes += level.pixels.size();
+    return bytes;
+}
+
+uint64_t TextureImporter::HashSettings(const TextureImportSettings& settings)
+{
+    // mezőnként, hogy a struct-padding ne kerüljön a kulcsba
+    uint64_t hash = Fnv1a(&kCacheVersion, sizeof(kCacheVersion));
+    const int profile = static_cast<int>(settings.profile);
+    const int mipmaps = static_cast<int>(settings.mipmaps);
+    const uint8_t flags[2] = { settings.premultiplyAlpha, settings.flipVertically };
+    hash = Fnv1a(&profile, sizeof(profile), hash);
+    hash = Fnv1a(&mipmaps, sizeof(mipmaps), hash);
+    hash = Fnv1a(flags, sizeof(flags), hash);
+    return Fnv1a(&settings.prescale, sizeof(settings.prescale), hash);
+}
+
+bool TextureImporter::Import(const std::string& path, const TextureImportSettings& settings, ImportedTexture& out)
+{
+    out = ImportedTexture();
+
+    // archívumból a tartalom hash-e, laza fájlnál a módosítási idő érvényesíti a cache-t
+    AssetStat source;
+    if (!VirtualFileSystem::Get().Stat(path, source)) {
+        std::cerr << "Failed to load texture: " << path << std::endl;
+        return false;
+    }
+    const uint64_t sourceSize = source.size;
+    const int64_t sourceTime = static_cast<int64_t>(source.stamp);
+
+    std::string cachePath;
+    if (settings.useDiskCache) {
+        const uint64_t key = Fnv1a(path.data(), path.size(), HashSettings(settings));
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.rtex", static_cast<unsigned long long>(key));
+        cachePath = (std::filesystem::path(kCacheDirectory) / name).string();
+
+        if (ReadCache(cachePath, sourceSize, sourceTime, out))
+            return true;
+    }
+
+    if (!Process(path, settings, out))
+        return false;
+
+    if (settings.useDiskCache)
+        WriteCache(cachePath, sourceSize, sourceTime, out);
+    return true;
+}
+
+void TextureImporter::ScaledSize(int width, int height, float prescale, int& outWidth, int& outHeight)
+{
+    outWidth = width;
+    outHeight = height;
+    if (prescale > 0.0f && prescale < 1.0f) {
+        outWidth = std::max(1, static_cast<int>(std::lround(width * prescale)));
+        outHeight = std::max(1, static_cast<int>(std::lround(height * prescale)));
+    }
+}
+
+bool TextureImporter::ReadInfo(const std::string& path, const TextureImportSettings& settings, int& width, int& height)
+{
+    // a fejléchez elég a fájl eleje (laza fájlnál nem olvassuk be az egészet)
+    AssetData data;
+    int sourceWidth, sourceHeight, channels;
+    if (!VirtualFileSystem::Get().Read(path, data, kInfoReadBytes)
+        || !stbi_info_from_memory(data.Data(), static_cast<int>(data.Size()), &sourceWidth, &sourceHeight, &channels)) {
+        std::cerr << "Failed to load texture: " << path << std::endl;
+        return false;
+    }
+    ScaledSize(sourceWidth, sourceHeight, settings.prescale, width, height);
+    return true;
+}
+
+bool TextureImporter::Process(const std::string& path, const TextureImportSettings& settings, ImportedTexture& out)
+{
+    // csomagolt PNG-nél a dekóder közvetlenül a leképezett archívumból olvas
+    AssetData source;
+    if (!VirtualFileSystem::Get().Read(path, source)) {
+        std::cerr << "Failed to load texture: " << path << std::endl;
+        return false;
+    }
+
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load_thread(settings.flipVertically);
+    unsigned char* data = stbi_load_from_memory(source.Data(), static_cast<int>(source.Size()), &width, &height, &channels, 4);
+    if (!data) {
+        std::cerr << "Failed to load texture: " << path << std::endl;
+        return false;
+    }
+
+    ImportedTexture::Level base;
+    base.width = width;
+    base.height = height;
+    base.pixels.assign(data, data + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(data);
+
+    // Premultiplikálás a szűrés előtt: így a mip-átlagban az átlátszó pixelek (tetszőleges,
+    // gyakran fekete) színe nem szivárog be a peremre
+    if (settings.premultiplyAlpha) {
+        for (size_t i = 0; i < base.pixels.size(); i += 4) {
+            const unsigned int a = base.pixels[i + 3];
+            for (int c = 0; c < 3; ++c)
+                base.pixels[i + c] = static_cast<uint8_t>((base.pixels[i + c] * a + 127) / 255);
+        }
+    }
+
+    const MipmapMode filter = settings.mipmaps == MipmapMode::None ? MipmapMode::Box : settings.mipmaps;
+    int scaledWidth, scaledHeight;
+    ScaledSize(width, height, settings.prescale, scaledWidth, scaledHeight);
+    if (scaledWidth != width || scaledHeight != height)
+        base = Resample(base, scaledWidth, scaledHeight, filter);
+
+    out.levels.push_back(std::move(base));
+    if (settings.mipmaps != MipmapMode::None) {
+        while (out.levels.back().width > 1 || out.levels.back().height > 1) {
+            const ImportedTexture::Level& previous = out.levels.back();
+            out.levels.push_back(Resample(previous,
+                std::max(1, previous.width / 2), std::max(1, previous.height / 2), settings.mipmaps));
+        }
+    }
+    return true;
+}
+
+ImportedTexture::Level TextureImporter::Resample(const ImportedTexture::Level& source, int width, int height, MipmapMode filter)
+{
+    ImportedTexture::Level result;
+    result.width = width;
+    result.height = height;
+    result.pixels.resize(static_cast<size_t>(width) * height * 4);
+
+    // minden cél-pixel a forrás egy téglalapjából (mipnél 2x2, páratlan méretnél helyenként 3 széles) készül
+    std::vector<std::pair<uint32_t, int>> counts;
+    for (int y = 0; y < height; ++y) {
+        const int sy0 = static_cast<int>(static_cast<int64_t>(y) * source.height / height);
+        const int sy1 = std::max(sy0 + 1, static_cast<int>(static_cast<int64_t>(y + 1) * source.height / height));
+        for (int x = 0; x < width; ++x) {
+            const int sx0 = static_cast<int>(static_cast<int64_t>(x) * source.width / width);
+            const int sx1 = std::max(sx0 + 1, static_cast<int>(static_cast<int64_t>(x + 1) * source.width / width));
+            uint8_t* target = &result.pixels[(static_cast<size_t>(y) * width + x) * 4];
+
+            if (filter == MipmapMode::PixelArt) {
+                // a blokk leggyakoribb színe; döntetlennél az átlátszatlanabb (a vékony kontúr így megmarad)
+                counts.clear();
+                for (int sy = sy0; sy < sy1; ++sy) {
+                    for (int sx = sx0; sx < sx1; ++sx) {
+                        const uint32_t pixel = PackPixel(&source.pixels[(static_cast<size_t>(sy) * source.width + sx) * 4]);
+                        auto it = std::find_if(counts.begin(), counts.end(), [pixel](const auto& c) { return c.first == pixel; });
+                        if (it != counts.end())
+                            ++it->second;
+                        else
+                            counts.emplace_back(pixel, 1);
+                    }
+                }
+                auto best = counts.begin();
+                for (auto it = counts.begin() + 1; it != counts.end(); ++it)
+                    if (it->second > best->second || (it->second == best->second && (it->first >> 24) > (best->first >> 24)))
+                        best = it;
+                for (int c = 0; c < 4; ++c)
+                    target[c] = static_cast<uint8_t>(best->first >> (c * 8));
+            }
+            else {
+                unsigned int sum[4] = {};
+                for (int sy = sy0; sy < sy1; ++sy) {
+                    const uint8_t* row = &source.pixels[(static_cast<size_t>(sy) * source.width + sx0) * 4];
+                    for (int sx = sx0; sx < sx1; ++sx, row += 4)
+                        for (int c = 0; c < 4; ++c)
+                            sum[c] += row[c];
+                }
+                const unsigned int count = static_cast<unsigned int>((sx1 - sx0) * (sy1 - sy0));
+                for (int c = 0; c < 4; ++c)
+                    target[c] = static_cast<uint8_t>((sum[c] + count / 2) / count);
+            }
+        }
+    }
+    return result;
+}
+
+bool TextureImporter::ReadCache(const std::string& cachePath, uint64_t sourceSize, int64_t sourceTime, ImportedTexture& out)
+{
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file)
+        return false;
+
+    CacheHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0
+        || header.version != kCacheVersion
+        || header.sourceSize != sourceSize || header.sourceTime != sourceTime
+        || header.levelCount == 0 || header.levelCount > 32)
+        return false;
+
+    ImportedTexture image;
+    image.levels.resize(header.levelCount);
+    for (ImportedTexture::Level& level : image.levels) {
+        int32_t size[2];
+        if (!file.read(reinterpret_cast<char*>(size), sizeof(size)) || size[0] <= 0 || size[1] <= 0 || size[0] > 16384 || size[1] > 16384)
+            return false;
+        level.width = size[0];
+        level.height = size[1];
+        level.pixels.resize(static_cast<size_t>(level.width) * level.height * 4);
+        if (!file.read(reinterpret_cast<char*>(level.pixels.data()), static_cast<std::streamsize>(level.pixels.size())))
+            return false;
+    }
+
+    image.fromCache = true;
+    out = std::move(image);
+    return true;
+}
+
+void TextureImporter::WriteCache(const std::string& cachePath, uint64_t sourceSize, int64_t sourceTime, const ImportedTexture& image)
+{
+    // a cache csak gyorsítás: ha nem írható, szólunk, de a textúra ettől még betöltött
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+    std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Texture cache not writable: " << cachePath << std::endl;
+        return;
+    }
+
+    CacheHeader header{};
+    std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+    header.version = kCacheVersion;
+    header.sourceSize = sourceSize;
+    header.sourceTime = sourceTime;
+    header.levelCount = static_cast<uint32_t>(image.levels.size());
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const ImportedTexture::Level& level : image.levels) {
+        const int32_t size[2] = { level.width, level.height };
+        file.write(reinterpret_cast<const char*>(size), sizeof(size));
+        file.write(reinterpret_cast<const char*>(level.pixels.data()), static_cast<std::streamsize>(level.pixels.size()));
+    }
+}
+
+unsigned int TextureImporter::Upload(const ImportedTexture& image, const TextureImportSettings& settings)
+{
+    if (image.levels.empty())
+        return 0;
+
+    unsigned int id = 0;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    const int levelCount = static_cast<int>(image.levels.size());
+    for (int i = 0; i < levelCount; ++i) {
+        const ImportedTexture::Level& level = image.levels[i];
+        glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, level.pixels.data());
+    }
+    ConfigureSampling(levelCount, settings);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return id;
+}
+
+void TextureImporter::ConfigureSampling(int levelCount, const TextureImportSettings& settings)
+{
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+    const bool pixelArt = settings.profile == TextureFilterProfile::PixelArt;
+    const bool mipmapped = levelCount > 1;
+    GLint minFilter = pixelArt ? GL_NEAREST : GL_LINEAR;
+    if (mipmapped)
+        minFilter = pixelArt ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR;
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, pixelArt ? GL_NEAREST : GL_LINEAR);
+}
@@ -0,0 +1,78 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Mintavételezési profil: a GL min/mag szűrők ebből és a mip-lánc meglétéből jönnek
+enum class TextureFilterProfile
+{
+    Smooth,     // LINEAR / LINEAR_MIPMAP_LINEAR
+    PixelArt    // NEAREST / NEAREST_MIPMAP_NEAREST
+};
+
+enum class MipmapMode
+{
+    None,       // csak az alapszint (pl. ~1:1-ben rajzolt sprite-lap)
+    Box,        // 2x2 átlag (premultiplikált térben, így nincs sötét perem)
+    PixelArt    // 2x2 blokk leggyakoribb színe: nem kever új színeket, élek maradnak
+};
+
+struct TextureImportSettings
+{
+    TextureFilterProfile profile = TextureFilterProfile::Smooth;
+    MipmapMode mipmaps = MipmapMode::Box;
+    bool premultiplyAlpha = true;       // a blend: GL_ONE, GL_ONE_MINUS_SRC_ALPHA
+    bool flipVertically = false;
+    float prescale = 1.0f;              // import-kori kicsinyítés a rajzolási méretre (a mipmaps szűrőjével)
+    bool useDiskCache = true;
+};
+
+// Feldolgozott RGBA8 kép a teljes mip-lánccal (levels[0] = alapszint)
+struct ImportedTexture
+{
+    struct Level
+    {
+        int width = 0, height = 0;
+        std::vector<uint8_t> pixels;
+    };
+
+    std::vector<Level> levels;
+    bool fromCache = false;
+
+    int Width() const { return levels.empty() ? 0 : levels[0].width; }
+    int Height() const { return levels.empty() ? 0 : levels[0].height; }
+    size_t ByteSize() const;
+};
+
+// PNG -> (premultiplikálás, előskálázás, mip-lánc) -> GL textúra.
+// A feldolgozott eredmény a cache/textures alá kerül; a forrás mérete és módosítási ideje
+// dönti el, hogy a cache érvényes-e, így indításkor nem kell újra számolni.
+class TextureImporter
+{
+public:
+    // Szálbiztos, GL nélkül: a háttérszálas dekódolás is ezt hívja
+    static bool Import(const std::string& path, const TextureImportSettings& settings, ImportedTexture& out);
+
+    // Csak a fejléc (stbi_info): az alapszint mérete az előskálázás után, dekódolás nélkül
+    static bool ReadInfo(const std::string& path, const TextureImportSettings& settings, int& width, int& height);
+
+    // GL textúra a teljes lánccal és a profil szűrőivel; 0 hiba esetén
+    static unsigned int Upload(const ImportedTexture& image, const TextureImportSettings& settings);
+
+    // a kötött GL_TEXTURE_2D szűrői és szintjei (Upload és a PBO-s feltöltés közös része)
+    static void ConfigureSampling(int levelCount, const TextureImportSettings& settings);
+
+    // a cache-kulcs és a TextureCache kulcsa is ebből készül
+    static uint64_t HashSettings(const TextureImportSettings& settings);
+
+    static constexpr const char* kCacheDirectory = "cache/textures";
+    // ReadInfo ennyit olvas be: a PNG/JPEG fejlécek ebbe bőven beleférnek
+    static constexpr size_t kInfoReadBytes = 4096;
+
+private:
+    static void ScaledSize(int width, int height, float prescale, int& outWidth, int& outHeight);
+    static bool Process(const std::string& path, const TextureImportSettings& settings, ImportedTexture& out);
+    static ImportedTexture::Level Resample(const ImportedTexture::Level& source, int width, int height, MipmapMode filter);
+    static bool ReadCache(const std::string& cachePath, uint64_t sourceSize, int64_t sourceTime, ImportedTexture& out);
+    static void WriteCache(const std::string& cachePath, uint64_t sourceSize, int64_t sourceTime, const ImportedTexture& image);
+};
@@ -0,0 +1,172 @@
+﻿#include "TileMesh.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Egy atlasz-sor sávjai az összes cellára összesítve
+    struct RowSpan
+    {
+        int hullMin, hullMax;       // bármely nem-átlátszó pixel [min, max)
+        int opaqueMin, opaqueMax;   // minden cellában 255-ös alfa [min, max); üres, ha min >= max
+    };
+}
+
+TileMesh TileMesh::BuildFromAlpha(const uint8_t* rgba, int atlasWidth, int atlasHeight,
+    int cellWidth, int cellCount, int bandHeight)
+{
+    if (!rgba || cellWidth <= 0 || cellCount <= 0 || cellWidth * cellCount > atlasWidth || bandHeight <= 0)
+        return FullQuad();
+
+    // 1) soronként: a cellák burkainak uniója és az átlátszatlan futások metszete
+    std::vector<RowSpan> rows(atlasHeight);
+    for (int y = 0; y < atlasHeight; ++y) {
+        RowSpan span{ cellWidth, 0, 0, cellWidth };
+        const uint8_t* row = rgba + static_cast<size_t>(y) * atlasWidth * 4;
+
+        for (int c = 0; c < cellCount; ++c) {
+            const uint8_t* cell = row + static_cast<size_t>(c) * cellWidth * 4;
+
+            // leghosszabb összefüggő 255-ös futás, közben a burok szélei
+            int bestMin = 0, bestMax = 0, runStart = -1;
+            for (int x = 0; x < cellWidth; ++x) {
+                const uint8_t a = cell[x * 4 + 3];
+                if (a > 0) {
+                    span.hullMin = std::min(span.hullMin, x);
+                    span.hullMax = std::max(span.hullMax, x + 1);
+                }
+                if (a == 255) {
+                    if (runStart < 0) runStart = x;
+                    if (x + 1 - runStart > bestMax - bestMin) {
+                        bestMin = runStart;
+                        bestMax = x + 1;
+                    }
+                }
+                else {
+                    runStart = -1;
+                }
+            }
+            span.opaqueMin = std::max(span.opaqueMin, bestMin);
+            span.opaqueMax = std::min(span.opaqueMax, bestMax);
+        }
+        rows[y] = span;
+    }
+
+    // 2) sávonként konzervatív téglalapok (a burok sosem vág le látható pixelt)
+    TileMesh mesh;
+    const float invW = 1.0f / cellWidth;
+    const float invH = 1.0f / atlasHeight;
+    for (int y0 = 0; y0 < atlasHeight; y0 += bandHeight) {
+        const int y1 = std::min(atlasHeight, y0 + bandHeight);
+
+        int hullMin = cellWidth, hullMax = 0;
+        int opaqueMin = 0, opaqueMax = cellWidth;
+        for (int y = y0; y < y1; ++y) {
+            hullMin = std::min(hullMin, rows[y].hullMin);
+            hullMax = std::max(hullMax, rows[y].hullMax);
+            opaqueMin = std::max(opaqueMin, rows[y].opaqueMin);
+            opaqueMax = std::min(opaqueMax, rows[y].opaqueMax);
+        }
+        if (hullMin >= hullMax)
+            continue; // teljesen átlátszó sáv: nincs geometria
+
+        const float v0 = y0 * invH, v1 = y1 * invH;
+        if (opaqueMin >= opaqueMax) {
+            AppendRect(mesh.edgeTriangles, hullMin * invW, v0, hullMax * invW, v1);
+            continue;
+        }
+
+        AppendRect(mesh.opaqueTriangles, opaqueMin * invW, v0, opaqueMax * invW, v1);
+        if (hullMin < opaqueMin)
+            AppendRect(mesh.edgeTriangles, hullMin * invW, v0, opaqueMin * invW, v1);
+        if (opaqueMax < hullMax)
+            AppendRect(mesh.edgeTriangles, opaqueMax * invW, v0, hullMax * invW, v1);
+    }
+    return mesh;
+}
+
+TileMesh TileMesh::FullQuad()
+{
+    TileMesh mesh;
+    AppendRect(mesh.edgeTriangles, 0.0f, 0.0f, 1.0f, 1.0f);
+    return mesh;
+}
+
+TileMesh::Coverage TileMesh::Measure(const uint8_t* rgba, int atlasWidth, int atlasHeight, int cellWidth, int cellCount, float scale) const
+{
+    constexpr uint8_t kEdge = 1, kOpaque = 2;
+    Coverage coverage;
+
+    // rajzolási méreten: hány pixel megy át a raszterizáláson, és ebből mennyi blendelve
+    const int width = std::max(1, static_cast<int>(cellWidth * scale));
+    const int height = std::max(1, static_cast<int>(atlasHeight * scale));
+    std::vector<uint8_t> mask(static_cast<size_t>(width) * height, 0);
+    Rasterize(edgeTriangles, width, height, kEdge, mask);
+    Rasterize(opaqueTriangles, width, height, kOpaque, mask);
+    coverage.quadPixels = width * height;
+    for (uint8_t value : mask) {
+        coverage.meshPixels += value != 0 ? 1 : 0;
+        coverage.blendedPixels += value == kEdge ? 1 : 0;
+    }
+
+    // texelenként: a burok minden látható texelt fed, az opaque rész csak 255-ös alfát
+    mask.assign(static_cast<size_t>(cellWidth) * atlasHeight, 0);
+    Rasterize(edgeTriangles, cellWidth, atlasHeight, kEdge, mask);
+    Rasterize(opaqueTriangles, cellWidth, atlasHeight, kOpaque, mask);
+    for (int c = 0; c < cellCount; ++c) {
+        for (int y = 0; y < atlasHeight; ++y) {
+            for (int x = 0; x < cellWidth; ++x) {
+                const uint8_t alpha = rgba[(static_cast<size_t>(y) * atlasWidth + c * cellWidth + x) * 4 + 3];
+                const uint8_t covered = mask[static_cast<size_t>(y) * cellWidth + x];
+                coverage.uncoveredTexels += alpha > 0 && covered == 0 ? 1 : 0;
+                coverage.translucentOpaqueTexels += alpha < 255 && covered == kOpaque ? 1 : 0;
+            }
+        }
+    }
+    return coverage;
+}
+
+void TileMesh::Rasterize(const std::vector<glm::vec2>& triangles, int width, int height, uint8_t value, std::vector<uint8_t>& mask)
+{
+    const glm::vec2 size(static_cast<float>(width), static_cast<float>(height));
+    for (size_t i = 0; i + 2 < triangles.size(); i += 3) {
+        const glm::vec2 a = triangles[i] * size, b = triangles[i + 1] * size, c = triangles[i + 2] * size;
+        const int x0 = std::max(0, static_cast<int>(std::floor(std::min({ a.x, b.x, c.x }))));
+        const int x1 = std::min(width - 1, static_cast<int>(std::ceil(std::max({ a.x, b.x, c.x }))));
+        const int y0 = std::max(0, static_cast<int>(std::floor(std::min({ a.y, b.y, c.y }))));
+        const int y1 = std::min(height - 1, static_cast<int>(std::ceil(std::max({ a.y, b.y, c.y }))));
+        auto edge = [](const glm::vec2& p, const glm::vec2& q, const glm::vec2& r) {
+            return (q.x - p.x) * (r.y - p.y) - (q.y - p.y) * (r.x - p.x);
+        };
+        const float sign = edge(a, b, c) < 0.0f ? -1.0f : 1.0f;
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                // a közös élre eső pixelközép mindkét háromszöghöz tartozik: a max miatt ez nem számít kétszer
+                const glm::vec2 p(x + 0.5f, y + 0.5f);
+                if (sign * edge(a, b, p) >= 0.0f && sign * edge(b, c, p) >= 0.0f && sign * edge(c, a, p) >= 0.0f) {
+                    uint8_t& covered = mask[static_cast<size_t>(y) * width + x];
+                    covered = std::max(covered, value);
+                }
+            }
+        }
+    }
+}
+
+float TileMesh::TriangleArea(const std::vector<glm::vec2>& triangles)
+{
+    float area = 0.0f;
+    for (size_t i = 0; i + 2 < triangles.size(); i += 3) {
+        const glm::vec2 a = triangles[i + 1] - triangles[i];
+        const glm::vec2 b = triangles[i + 2] - triangles[i];
+        area += std::abs(a.x * b.y - a.y * b.x) * 0.5f;
+    }
+    return area;
+}
+
+void TileMesh::AppendRect(std::vector<glm::vec2>& out, float x0, float y0, float x1, float y1)
+{
+    out.insert(out.end(), {
+        { x0, y0 }, { x1, y0 }, { x1, y1 },
+        { x1, y1 }, { x0, y1 }, { x0, y0 }
+    });
+}
@@ -0,0 +1,48 @@
+﻿#pragma once
+#include <cstdint>
+#include <glm.hpp>
+#include <vector>
+
+// Az atlasz-cellák alfájából épített szoros csempe-háló.
+// A cellát bandHeight magas sávokra bontja; sávonként:
+//  - opaque: az a téglalap, ahol MINDEN cella MINDEN sora teljesen átlátszatlan (blend nélkül rajzolható)
+//  - edge:   a burok (bármely cella nem-átlátszó pixelei) mínusz az opaque téglalap (blenddel)
+// Minden cellára ugyanaz a háló jut, így a csempék továbbra is egyetlen instanced rajzolással mennek.
+// A koordináták normáltak a cellán belül: (0,0) = a kép alja-bal, (1,1) = teteje-jobb
+// (stbi_set_flip_vertically_on_load(true) után a 0. sor a kép alja).
+struct TileMesh
+{
+    // A háló ellenőrzése CPU-raszterizálással (pixelközepek), az atlasz alfájával összevetve
+    struct Coverage
+    {
+        int quadPixels = 0;             // a teljes cella-quad pixelei a rajzolási méreten
+        int meshPixels = 0;             // ebből a háló által lefedettek
+        int blendedPixels = 0;          // ebből az edge passba esők
+        int uncoveredTexels = 0;        // látható (alfa > 0) texel a burkon kívül: 0 kell legyen
+        int translucentOpaqueTexels = 0;    // nem teljesen átlátszatlan texel az opaque részben: 0 kell
+    };
+
+    std::vector<glm::vec2> opaqueTriangles;
+    std::vector<glm::vec2> edgeTriangles;
+
+    // lefedett terület normált egységben (1.0 = a teljes cella-quad)
+    float OpaqueArea() const { return TriangleArea(opaqueTriangles); }
+    float EdgeArea() const { return TriangleArea(edgeTriangles); }
+
+    // rgba: a teljes atlasz (RGBA8, sor-folytonos); a cellák egymás mellett, cellWidth szélesek
+    static TileMesh BuildFromAlpha(const uint8_t* rgba, int atlasWidth, int atlasHeight,
+        int cellWidth, int cellCount, int bandHeight = 8);
+
+    // scale: a cella rajzolási mérete a texelekhez képest (a pixelszámokhoz); a texel-ellenőrzés
+    // minden cellára 1:1-ben fut
+    Coverage Measure(const uint8_t* rgba, int atlasWidth, int atlasHeight, int cellWidth, int cellCount, float scale) const;
+
+    // ha nincs alfa-adat: egy teljes quad az edge passban (a korábbi viselkedés)
+    static TileMesh FullQuad();
+
+private:
+    static float TriangleArea(const std::vector<glm::vec2>& triangles);
+    // a háromszögek által lefedett pixelközepek: mask = max(mask, value)
+    static void Rasterize(const std::vector<glm::vec2>& triangles, int width, int height, uint8_t value, std::vector<uint8_t>& mask);
+    static void AppendRect(std::vector<glm::vec2>& out, float x0, float y0, float x1, float y1);
+};
@@ -1,19 +1,49 @@
 ﻿#include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
 
+#include "Core/AllocationTracker.h"
+#include "Core/AssetPacker.h"
+#include "Core/FrameArena.h"
 #include "Core/Globals.h"
 #include "Core/Input.h"
 #include "Core/UIRenderer.h"
+#include "Game/PlayerHud.h"
+#include "Game/DebugOverlay.h"
+#include "Core/StartupGraph.h"
+#include "Core/ThreadPool.h"
+#include "Core/VirtualFileSystem.h"
 #include "Game/Character8Direction.h"
+#include "Game/CrowdAvoidance.h"
+#include "Game/FieldOfView.h"
+#include "Game/FlowField.h"
+#include "Game/ParticleSystem.h"
+#include "Game/ProjectileSystem.h"
+#include "Game/TileMap.h"
 #include "Renderer/Shader.h"
+#include "Renderer/ShaderCache.h"
 #include "Renderer/Camera.h"
-#include "Renderer/Texture.h"
+#include "Renderer/TextureCache.h"
 #include "Renderer/SpriteRenderer.h"
 #include "Renderer/IsoRenderer.h"
+#include "Renderer/IsoMapTextureRenderer.h"
+#include "Renderer/MapPageCache.h"
+#include "Renderer/DynamicResolution.h"
+#include "Renderer/InstancedSpriteRenderer.h"
+#include "Renderer/CrowdRenderer.h"
+#include "Renderer/RenderQueue.h"
+#include "Renderer/CommandBuffer.h"
+#include "Renderer/GLBackend.h"
+#include "Renderer/GLStats.h"
+#include "Renderer/GLHandle.h"
 
 struct DashState {
     bool active = false;     // éppen dash-ben van-e
@@ -24,10 +54,14 @@ struct DashState {
     glm::vec2 direction = { 0.0f, 0.0f };  // normált irányvektor
 };
 
-// Egyszeri, megosztott erőforrások a rácsvonalakhoz
-static GLuint sGridVAO = 0, sGridVBO = 0;
-auto EnsureGridVAO = []() {
-    if (sGridVAO) return;
+// A rácsvonalak egység-rombusza; a hívó tartja (a kontextussal együtt szűnik meg)
+struct GridOutlineMesh
+{
+    GLVertexArray vao;
+    GLBuffer vbo;
+};
+
+GridOutlineMesh CreateGridOutlineMesh() {
     // Egység-rombussz (origó-középpontú), GL_LINE_LOOP-hoz 4 pont elég:
     // (-1,0) -> (0,1) -> (1,0) -> (0,-1)
     const float unitDiamond[8] = {
@@ -36,16 +70,18 @@ auto EnsureGridVAO = []() {
          1.0f,  0.0f,
          0.0f, -1.0f
     };
-    glGenVertexArrays(1, &sGridVAO);
-    glGenBuffers(1, &sGridVBO);
-    glBindVertexArray(sGridVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, sGridVBO);
+    GridOutlineMesh mesh;
+    mesh.vao = GLVertexArray::Create();
+    mesh.vbo = GLBuffer::Create();
+    glBindVertexArray(mesh.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(unitDiamond), unitDiamond, GL_STATIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
-    };
+    return mesh;
+}
 
 void CenterWindowOnPrimary(GLFWwindow* window) {
     GLFWmonitor* mon = glfwGetPrimaryMonitor();
@@ -73,13 +109,13 @@ void CenterWindowOnPrimary(GLFWwindow* window) {
 
 void DrawWalkableOutlines(
     const IsoRenderer& iso,
+    const GridOutlineMesh& mesh,
     const std::vector<std::vector<int>>& map,
     Shader& lineShader,
     const glm::vec3& lineColor = glm::vec3(1.0f),
     float lineWidth = 1.0f)
 {
     glDisable(GL_DEPTH_TEST);
-    EnsureGridVAO();
 
     const int rows = static_cast<int>(map.size());
     const int cols = static_cast<int>(map[0].size());
@@ -107,7 +143,7 @@ void DrawWalkableOutlines(
         (Globals::kClampBiasTilesX + Globals::kClampBiasTilesY) * halfH
     );
 
-    glBindVertexArray(sGridVAO);
+    glBindVertexArray(mesh.vao);
 
     // Minden tile közepére: model = T(center) * S(halfW,halfH,1)
     for (int r = 0; r < rows; ++r)
@@ -132,24 +168,88 @@ void DrawWalkableOutlines(
     glBindVertexArray(0);
 }
 
-std::string LoadShaderSource(const std::string& filePath)
+// Az indításkor fordított programok; a forrásaikat egy worker olvassa be, amíg az ablak készül
+enum StartupShader
 {
-    std::ifstream file(filePath);
-    if (!file.is_open())
-    {
+    IsoShader,
+    IsoMapShader,
+    MapPageShader,
+    UpscaleShader,
+    SpriteShader,
+    InstancedSpriteShader,
+    CrowdShader,
+    UiShader,
+    StartupShaderCount
+};
+
+const char* const kStartupShaderNames[StartupShaderCount] = {
+    "iso", "iso_map", "map_page", "upscale", "sprite", "instanced_sprite", "crowd", "ui"
+};
+
+struct StartupShaderSource
+{
+    AssetData vertex;
+    AssetData fragment;
+};
+
+using StartupShaderSources = std::array<StartupShaderSource, StartupShaderCount>;
+
+// az indítás előtti feltöltésnek nincs képkocka-kerete: ami kész, az mind felmehet
+constexpr size_t kStartupUploadBytes = 64u * 1024u * 1024u;
+
+// Csomagolva a forrás a leképezett archívumban marad, a Shader onnan fordít (hosszal, másolás nélkül)
+AssetData LoadShaderSource(const std::string& filePath)
+{
+    AssetData source;
+    if (!VirtualFileSystem::Get().Read(filePath, source))
         std::cerr << "Failed to open shader file: " << filePath << std::endl;
-        return "";
-    }
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
+    return source;
+}
+
+Shader CreateStartupShader(ShaderCache& cache, const StartupShaderSources& sources, StartupShader which)
+{
+    return Shader(cache, kStartupShaderNames[which], sources[which].vertex.Text(), sources[which].fragment.Text());
+}
+
+void BuildDefaultMap(TileMap& tileMap)
+{
+    tileMap.SetTiles({
+        { 0, 1, 2, 3, 0, 3, 0, 3, 0, 3 },
+        { 0, 2, 3, 0, 0, 0, 3, 0, 3, 0 },
+        { 0, 3, 0, 1, 0, 3, 0, 3, 0, 3 },
+        { 0, 0, 1, 2, 0, 0, 3, 0, 3, 0 },
+        { 0, 3, 0, 3, 0, 3, 0, 3, 0, 3 }
+    });
+}
+
+// ~1:1-ben rajzolt pixel-art lap: nincs mip-lánc, nearest szűrés
+TextureImportSettings PlayerSheetImportSettings()
+{
+    TextureImportSettings settings;
+    settings.profile = TextureFilterProfile::PixelArt;
+    settings.mipmaps = MipmapMode::None;
+    return settings;
 }
 
-GLFWwindow* CreateGameWindow()
+// A játékos kezdőpozíciója: a térkép középső csempéje
+glm::vec2 GetMapCenterPosition(const IsoRenderer& isoRenderer, const TileMap& tileMap)
+{
+    const int centerTileX = tileMap.GetWidth() / 2;
+    const int centerTileY = tileMap.GetHeight() / 2;
+
+    const float worldX = (centerTileX - centerTileY) * (isoRenderer.ScaledWidth() * 0.5f);
+    const float worldY = (centerTileX + centerTileY) * (isoRenderer.ScaledVisibleHeight() * 0.5f);
+    return glm::vec2(worldX, worldY);
+}
+
+// debugContext: a KHR_debug teljesítmény-üzeneteit a driverek többnyire csak debug kontextusban adják
+GLFWwindow* CreateGameWindow(bool debugContext)
 {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (debugContext)
+        glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
 
     GLFWmonitor* primaryMonitor = glfwGetPrimaryMonitor();
     const GLFWvidmode* mode = glfwGetVideoMode(primaryMonitor);
@@ -219,26 +319,6 @@ void UpdatePlayerMovement(GLFWwindow* window,
     player.Update(move, dt);                // animáció frissítés
 }
 
-// --- Játékos kirajzolása (sprite shader beállítás + render)
-void DrawPlayer(Shader& spriteShader,
-    const Camera& camera,
-    Character8Direction& player,
-    const glm::vec2& playerPos,
-    const glm::vec2& playerSize)
-{
-    glEnable(GL_DEPTH_TEST);
-    // ugyanazok az uniformok, mint eddig a statikus sprite-hoz
-    spriteShader.Use();
-    glUniformMatrix4fv(glGetUniformLocation(spriteShader.ID, "projection"), 1, GL_FALSE, &camera.GetProjection()[0][0]);
-    glUniformMatrix4fv(glGetUniformLocation(spriteShader.ID, "view"), 1, GL_FALSE, &camera.GetView()[0][0]);
-    glUniform1i(glGetUniformLocation(spriteShader.ID, "useView"), 1);
-    glUniform1i(glGetUniformLocation(spriteShader.ID, "useColorOnly"), 0);
-    glUniform1i(glGetUniformLocation(spriteShader.ID, "sprite"), 0);
-
-    // a Character8Direction saját UV-t állít és rajzol; pozíciót/négyzetméretet tőled kap
-    player.DrawPlayer(playerPos, playerSize);
-}
-
 void UpdateCameraFollow(Camera& camera, const glm::vec2& playerPos, float deltaTime)
 {
     float smoothness = Globals::kCameraFollowSmoothness;
@@ -328,22 +408,423 @@ void UpdatePlayerPosition(GLFWwindow* window,
     }
 }
 
+// A lövedék a láb pontjáról indul: a fal- és entitás-ütközés is a láb-térben számol
+void FireProjectiles(GLFWwindow* window,
+    const Character8Direction& player,
+    const glm::vec2& playerFeet,
+    ProjectileSystem& projectiles,
+    float& fireCooldown,
+    float deltaTime)
+{
+    fireCooldown = std::max(0.0f, fireCooldown - deltaTime);
+    if (fireCooldown > 0.0f || glfwGetKey(window, Globals::FireKey) != GLFW_PRESS)
+        return;
+
+    const glm::vec2 direction = player.GetCurrentDirectionVector();
+    projectiles.Spawn(playerFeet, direction * Globals::ProjectileSpeed,
+        Globals::ProjectileLifetimeInSeconds, Globals::ProjectileRadius,
+        glm::vec4(1.0f, 0.85f, 0.3f, 1.0f));
+    fireCooldown = Globals::FireIntervalInSeconds;
+}
+
 void BeginFrame()
 {
     glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
-void RenderWorld(IsoRenderer& isoRenderer, const std::vector<std::vector<int>>& mapData)
+enum class WorldRenderMode { PageCache = 0, Geometry, MapTexture, Count };
+
+// A világ-sor (RenderQueue) batch-ei: ezek fésülődnek össze iso-mélység szerint
+enum WorldBatch : uint32_t { TileEdgeBatch = 0, PlayerBatch };
+
+// Geometria módban a csempék parancsként rögzülnek, a szélek a világ-sorba kerülnek;
+// a többi mód azonnal rajzolja a kész képet
+void RenderWorld(IsoRenderer& isoRenderer, IsoMapTextureRenderer& mapRenderer, MapPageCache& pageCache,
+    const TileMap& tileMap, const FieldOfView& fov, WorldRenderMode mode,
+    CommandBuffer& commands, RenderQueue& worldQueue)
 {
     glEnable(GL_DEPTH_TEST);
-    isoRenderer.DrawMap(mapData);
+    switch (mode)
+    {
+    case WorldRenderMode::PageCache:
+        // ha nincs framebuffer, közvetlenül rajzolunk
+        if (pageCache.Draw(tileMap, fov.GetVisibility().data(), isoRenderer.GetProjection(), isoRenderer.GetView()))
+            break;
+        [[fallthrough]];
+    case WorldRenderMode::Geometry:
+        isoRenderer.RecordMap(commands, tileMap.GetTiles(), fov.GetVisibility().data(), worldQueue, TileEdgeBatch);
+        break;
+    case WorldRenderMode::MapTexture:
+        mapRenderer.Draw(isoRenderer.GetProjection(), isoRenderer.GetView());
+        break;
+    default:
+        break;
+    }
 }
 
-void RenderUI(UIRenderer& ui, int currentHealth, int maxHealth)
+// A rendezett világ-sor rögzítése: a futam sorszáma a WorldBlended pass-on belüli sorrend.
+// A csempe-futamok folytonos példány-tartományok (a csempék sorrendben kerültek be),
+// így futamonként egy parancs.
+void RecordSortedWorld(CommandBuffer& commands, const RenderQueue& worldQueue, const IsoRenderer& isoRenderer,
+    const Camera& camera, const Character8Direction& player,
+    const glm::vec2& playerPos, const glm::vec2& playerSize, float playerDepth)
 {
-    glDisable(GL_DEPTH_TEST);
-    ui.DrawHealthBar(currentHealth, maxHealth);
+    const std::vector<RenderQueue::Item>& items = worldQueue.GetItems();
+    const std::vector<RenderQueue::Run>& runs = worldQueue.GetRuns();
+    for (uint32_t order = 0; order < runs.size(); ++order) {
+        const RenderQueue::Run& run = runs[order];
+        switch (run.batch)
+        {
+        case TileEdgeBatch:
+            isoRenderer.RecordEdges(commands, order, items[run.first].index, run.count);
+            break;
+        case PlayerBatch:
+            // mélység a láb iso rendezési kulcsából: az előtte álló csempék eltakarják
+            player.RecordPlayer(commands, RenderPass::WorldBlended, order, playerPos, playerSize,
+                camera.GetProjection(), camera.GetView(), playerDepth);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// Nearest <-> sharp-bilinear nagyítás váltása (élre)
+void ToggleUpscaleFilter(GLFWwindow* window, DynamicResolution& dynamicResolution, bool& keyWasDown)
+{
+    const bool keyDown = (glfwGetKey(window, Globals::UpscaleFilterKey) == GLFW_PRESS);
+    if (keyDown && !keyWasDown)
+        dynamicResolution.SetFilter(dynamicResolution.GetFilter() == DynamicResolution::UpscaleFilter::Nearest
+            ? DynamicResolution::UpscaleFilter::SharpBilinear
+            : DynamicResolution::UpscaleFilter::Nearest);
+    keyWasDown = keyDown;
+}
+
+void ToggleDebugOverlay(GLFWwindow* window, DebugOverlay& overlay, bool& keyWasDown)
+{
+    const bool keyDown = (glfwGetKey(window, Globals::DebugOverlayKey) == GLFW_PRESS);
+    if (keyDown && !keyWasDown)
+        overlay.SetVisible(!overlay.IsVisible());
+    keyWasDown = keyDown;
+}
+
+// Lap-cache -> csempe-geometria -> térkép-textúra mód léptetése (élre)
+void CycleWorldRenderMode(GLFWwindow* window, WorldRenderMode& mode, bool& keyWasDown)
+{
+    const bool keyDown = (glfwGetKey(window, Globals::MapRenderModeKey) == GLFW_PRESS);
+    if (keyDown && !keyWasDown)
+        mode = static_cast<WorldRenderMode>((static_cast<int>(mode) + 1) % static_cast<int>(WorldRenderMode::Count));
+    keyWasDown = keyDown;
+}
+
+// --- Tömeg-teszt (F4): sok, a térképen körbe sétáló szereplő egyetlen instanced rajzolással.
+// Szereplőnként csak a 8 bájtos CrowdInstance megy fel; az UV-t a vertex shader választja.
+struct CrowdTest
+{
+    bool enabled = false;
+    bool keyWasDown = false;
+    int clip = -1;
+    std::vector<glm::vec2> centers;
+    std::vector<glm::vec3> motion;      // sugár, szögsebesség, fázis
+    std::vector<CrowdInstance> instances;
+    std::vector<glm::vec2> feet;        // a szereplők lába (a lövedékek célpontjai); kikapcsolva üres
+    std::vector<int> chunkCounts;       // UpdateCrowdTest: darabonként a csomagolt példányok száma
+};
+
+// Véletlen csempékre szórja a szereplőket (fix maggal, ismételhető)
+void SpawnCrowdTest(CrowdTest& crowd, const IsoGrid& grid, int mapHeight, int mapWidth)
+{
+    std::mt19937 random(1234);
+    std::uniform_int_distribution<int> column(0, mapWidth - 1), row(0, mapHeight - 1);
+    std::uniform_real_distribution<float> offset(-0.4f, 0.4f), radius(10.0f, 80.0f), speed(0.3f, 1.5f), phase(0.0f, 6.2832f);
+
+    crowd.centers.resize(Globals::CrowdTestCount);
+    crowd.motion.resize(Globals::CrowdTestCount);
+    for (int i = 0; i < Globals::CrowdTestCount; ++i) {
+        crowd.centers[i] = grid.TileCenter(column(random), row(random))
+            + glm::vec2(offset(random) * grid.halfWidth, offset(random) * grid.halfHeight);
+        crowd.motion[i] = glm::vec3(radius(random), speed(random) * (i % 2 ? 1.0f : -1.0f), phase(random));
+    }
+}
+
+void ToggleCrowdTest(GLFWwindow* window, CrowdTest& crowd, const IsoGrid& grid, int mapHeight, int mapWidth)
+{
+    const bool keyDown = (glfwGetKey(window, Globals::CrowdTestKey) == GLFW_PRESS);
+    if (keyDown && !crowd.keyWasDown)
+        crowd.enabled = !crowd.enabled;
+    crowd.keyWasDown = keyDown;
+
+    if (crowd.enabled && crowd.centers.empty())
+        SpawnCrowdTest(crowd, grid, mapHeight, mapWidth);
+}
+
+// A mozgás és a csomagolás a CPU-n, darabonként párhuzamosan; az origóhoz (a kamera
+// közepéhez) képest messze lévők kimaradnak. A körpályák középpontja a flow field mentén a
+// célja (a játékos) felé sodródik: szereplőnként egy irány-lekérdezés. Minden darab a saját index-tartományába ír (a
+// lábak indexre pontosan, a példányok a tartomány elejétől), utána a példányokat egymás után
+// tömörítjük, így a sorrend ugyanaz, mint egy szálon.
+void UpdateCrowdTest(CrowdTest& crowd, float time, float deltaTime, const glm::vec2& origin,
+    const FlowField& flowField, const IsoGrid& grid, ThreadPool* workers)
+{
+    constexpr float kFramesPerSecond = 8.0f;
+    constexpr int kGrainSize = 4096;
+
+    if (!crowd.enabled || crowd.clip < 0) {
+        crowd.instances.clear();
+        crowd.feet.clear();
+        return;
+    }
+
+    const int count = static_cast<int>(crowd.centers.size());
+    const int chunkCount = (count + kGrainSize - 1) / kGrainSize;
+    crowd.instances.resize(count);
+    crowd.feet.resize(count);
+    crowd.chunkCounts.resize(chunkCount);
+
+    // egy darab: a lábak indexre pontosan, a képen lévők példányai a darab elejétől
+    // irányonként a képkocka sodródása: a 8 irány vektora a rács arányára nyújtva pontosan a
+    // szomszéd csempe közepe felé mutat
+    std::array<glm::vec2, 8> seekSteps;
+    for (int direction = 0; direction < 8; ++direction)
+        seekSteps[direction] = glm::normalize(Character8Direction::DirectionToVector(direction) * glm::vec2(grid.halfWidth, grid.halfHeight))
+            * (Globals::CrowdSeekSpeed * deltaTime);
+
+    auto packChunk = [&crowd, time, &seekSteps, &origin, &flowField, &grid](int chunk) {
+        const int begin = chunk * kGrainSize;
+        const int end = std::min(static_cast<int>(crowd.centers.size()), begin + kGrainSize);
+        int written = begin;
+        for (int i = begin; i < end; ++i) {
+            const glm::ivec2 tile = grid.WorldToTile(crowd.centers[i]);
+            const int seekDirection = flowField.GetDirection(tile.x, tile.y);
+            if (seekDirection >= 0)
+                crowd.centers[i] += seekSteps[seekDirection];
+
+            const glm::vec3& motion = crowd.motion[i];
+            const float angle = motion.z + motion.y * time;
+            const glm::vec2 feet = crowd.centers[i] + motion.x * glm::vec2(std::cos(angle), std::sin(angle));
+            crowd.feet[i] = feet;
+            // a körpálya érintője a haladási irány
+            const glm::vec2 velocity = motion.y * glm::vec2(-std::sin(angle), std::cos(angle));
+            const int direction = std::max(0, Character8Direction::DirectionFromMovement(velocity));
+            const int frame = static_cast<int>(time * kFramesPerSecond + motion.z) % Character8Direction::kFramesPerDirection;
+
+            if (CrowdRenderer::Pack(feet, origin, direction, frame, crowd.clip, crowd.instances[written]))
+                ++written;
+        }
+        crowd.chunkCounts[chunk] = written - begin;
+    };
+
+    // egy referencia: a std::function kis-objektum pufferébe fér, nincs foglalás. A ParallelFor
+    // egyben is átadhatja a teljes tartományt (nincs szabad worker), ezért darabonként megyünk.
+    auto updateRange = [&packChunk](int begin, int end) {
+        for (int chunk = begin / kGrainSize; chunk * kGrainSize < end; ++chunk)
+            packChunk(chunk);
+    };
+
+    if (workers)
+        workers->ParallelFor(count, kGrainSize, updateRange);
+    else
+        updateRange(0, count);
+
+    size_t packed = 0;
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        const auto first = crowd.instances.begin() + static_cast<size_t>(chunk) * kGrainSize;
+        if (packed != static_cast<size_t>(chunk) * kGrainSize)
+            std::copy(first, first + crowd.chunkCounts[chunk], crowd.instances.begin() + packed);
+        packed += crowd.chunkCounts[chunk];
+    }
+    crowd.instances.resize(packed);
+}
+
+size_t RenderParticles(InstancedSpriteRenderer& renderer,
+    const Camera& camera,
+    ParticleSystem& particles,
+    std::vector<SpriteInstance>& instances)
+{
+    size_t uploadBytes = 0;
+
+    particles.BuildInstances(ParticleBlendMode::Alpha, instances);
+    renderer.Draw(instances, camera.GetProjection(), camera.GetView());
+    uploadBytes += renderer.GetLastUploadBytes();
+
+    particles.BuildInstances(ParticleBlendMode::Additive, instances);
+    glBlendFunc(GL_ONE, GL_ONE);   // premultiplikált szín: additív = egyszerű összeg
+    renderer.Draw(instances, camera.GetProjection(), camera.GetView());
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    uploadBytes += renderer.GetLastUploadBytes();
+
+    return uploadBytes;
+}
+
+// A játék kibocsátói (a headless jelenet is ezeket szimulálja)
+ParticleEmitterSettings MakeDashTrailSettings()
+{
+    ParticleEmitterSettings settings;
+    settings.capacity = 512;
+    settings.minLifetime = 0.2f;
+    settings.maxLifetime = 0.4f;
+    settings.minSpeed = 20.0f;
+    settings.maxSpeed = 60.0f;
+    settings.spreadRadians = 1.2f;
+    settings.drag = 4.0f;
+    settings.startSize = 10.0f;
+    settings.endSize = 2.0f;
+    settings.startColor = glm::vec4(0.7f, 0.8f, 1.0f, 0.6f);
+    settings.endColor = glm::vec4(0.4f, 0.5f, 1.0f, 0.0f);
+    return settings;
+}
+
+ParticleEmitterSettings MakeHitSparkSettings()
+{
+    ParticleEmitterSettings settings;
+    settings.capacity = 4096;
+    settings.blendMode = ParticleBlendMode::Additive;
+    settings.minLifetime = 0.15f;
+    settings.maxLifetime = 0.35f;
+    settings.minSpeed = 80.0f;
+    settings.maxSpeed = 220.0f;
+    settings.drag = 6.0f;
+    settings.startSize = 5.0f;
+    settings.endSize = 1.0f;
+    settings.startColor = glm::vec4(1.0f, 0.9f, 0.5f, 1.0f);
+    settings.endColor = glm::vec4(1.0f, 0.3f, 0.1f, 0.0f);
+    return settings;
+}
+
+ParticleEmitterSettings MakeDustSettings()
+{
+    ParticleEmitterSettings settings;
+    settings.capacity = 256;
+    settings.minLifetime = 3.0f;
+    settings.maxLifetime = 6.0f;
+    settings.minSpeed = 2.0f;
+    settings.maxSpeed = 10.0f;
+    settings.acceleration = glm::vec2(0.0f, -2.0f);
+    settings.startSize = 3.0f;
+    settings.endSize = 3.0f;
+    settings.startColor = glm::vec4(0.9f, 0.85f, 0.7f, 0.35f);
+    settings.endColor = glm::vec4(0.9f, 0.85f, 0.7f, 0.0f);
+    settings.spawnRate = 40.0f;
+    settings.spawnAreaHalfExtent = glm::vec2(Globals::WindowWidth * 0.5f, Globals::WindowHeight * 0.5f);
+    return settings;
+}
+
+// Dash csóva, becsapódási szikrák és a kamera körül lebegő por
+void EmitGameplayParticles(float deltaTime,
+    const DashState& dash,
+    const glm::vec2& playerFeet,
+    const std::vector<ProjectileHit>& hits,
+    ParticleEmitter& dashTrail,
+    ParticleEmitter& hitSparks,
+    ParticleEmitter& dust)
+{
+    if (dash.active)
+        dashTrail.EmitOverTime(Globals::DashTrailRate, deltaTime, playerFeet, -dash.direction);
+
+    for (const ProjectileHit& hit : hits)
+        hitSparks.Emit(12, hit.position);
+
+    dust.SetSpawnCenter(playerFeet);
+}
+
+bool HasArgument(int argc, char** argv, const std::string& argument)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (argument == argv[i])
+            return true;
+    }
+    return false;
+}
+
+GLStats::Settings MakeGLStatsSettings(bool continuous)
+{
+    GLStats::Settings settings;
+    settings.captureFrames = Globals::GLStatsCaptureFrames;
+    settings.topCount = Globals::GLStatsTopCount;
+    settings.continuous = continuous;
+    return settings;
+}
+
+// Egy mérési ablak (GLStatsCaptureFrames képkocka) indítása élre; a végén a táblázat a
+// konzolra kerül, és a réteg magától kikapcsol
+void StartGLStatsCapture(GLFWwindow* window, bool& keyWasDown)
+{
+    const bool keyDown = (glfwGetKey(window, Globals::GLStatsKey) == GLFW_PRESS);
+    if (keyDown && !keyWasDown && !GLStats::IsEnabled())
+        GLStats::Enable(MakeGLStatsSettings(false), (GLADloadproc)glfwGetProcAddress);
+    keyWasDown = keyDown;
+}
+
+// Fél másodpercenként az ablak címsorába írja a részecske-statisztikát
+void ReportFrameStats(GLFWwindow* window, const ParticleSystem::Stats& stats,
+    const CommandQueue::Stats& commandStats, size_t crowdCount,
+    size_t uploadBytes, float deltaTime, float& reportTimer)
+{
+    reportTimer += deltaTime;
+    if (reportTimer < 0.5f)
+        return;
+    reportTimer = 0.0f;
+
+    // fix pufferbe: a címsor frissítése se foglaljon heapet
+    char title[256];
+    std::snprintf(title, sizeof(title),
+        "%s | particles: %d | update: %.3f ms | draws: %zu (prog %zu, tex %zu) | crowd: %zu | upload: %.1f KB",
+        Globals::WindowTitle, stats.particleCount, stats.updateMs,
+        commandStats.commands, commandStats.programBinds, commandStats.textureBinds,
+        crowdCount, uploadBytes / 1024.0);
+    glfwSetWindowTitle(window, title);
+}
+
+// Debug buildben a bemelegedés utáni képkockáknak foglalásmentesnek kell lenniük; ha egy mégis
+// foglal, a hívási helyek listája a konzolra kerül (legfeljebb másodpercenként)
+void CheckSteadyStateAllocations(int frameIndex, float deltaTime, float& reportTimer)
+{
+    if (!AllocationTracker::IsEnabled() || frameIndex < Globals::AllocationWarmupFrames)
+        return;
+    reportTimer -= deltaTime;
+    if (AllocationTracker::GetFrameTotals().allocations == 0 || reportTimer > 0.0f)
+        return;
+    reportTimer = 1.0f;
+    std::cout << "Steady-state frame " << frameIndex << " allocated:" << std::endl;
+    AllocationTracker::PrintFrameReport();
+}
+
+// Az első képkocka lezárja az indítási gráfot (riport a kritikus úttal); utána még jelezzük,
+// mikor került fel minden háttérben töltött textúra
+void ReportStartupProgress(StartupGraph& startup, StartupGraph::TaskId firstFrame, const TextureCache& textures, int& stage)
+{
+    if (stage == 0) {
+        startup.End(firstFrame);
+        startup.PrintReport(Globals::StartupTargetMs);
+        std::cout << "First frame after " << startup.ElapsedMs() << " ms ("
+            << textures.GetPendingCount() << " texture(s) still loading)" << std::endl;
+        stage = 1;
+    }
+    if (stage == 1 && textures.GetPendingCount() == 0) {
+        std::cout << "All textures loaded after " << startup.ElapsedMs() << " ms" << std::endl;
+        stage = 2;
+    }
+}
+
+// --- Lövedékek: egyetlen instanced rajzolás, ugyanazzal a kamerával, mint a játékos
+void RenderProjectiles(InstancedSpriteRenderer& renderer,
+    const Camera& camera,
+    const ProjectileSystem& projectiles,
+    std::vector<SpriteInstance>& instances)
+{
+    projectiles.BuildInstances(instances);
+    renderer.Draw(instances, camera.GetProjection(), camera.GetView());
+}
+
+// A HUD egy rajzolás; feltöltés csak akkor, ha valamelyik widget látványa változott
+void RenderUI(UIRenderer& ui, PlayerHud& hud, CommandQueue& commandQueue, CommandBuffer& commands,
+    int currentHealth, int maxHealth, float dashCooldown)
+{
+    hud.Update(currentHealth, maxHealth, dashCooldown);
+    ui.Update();
+    ui.Record(commands);
+    commandQueue.Submit();
 }
 
 // L1 "rombusz peremre" való klampelés
@@ -363,6 +844,11 @@ glm::vec2 ClampLocalToDiamond(glm::vec2 local)
     return local;
 }
 
+glm::vec2 GetPlayerFeetPosition(const glm::vec2& playerCenterPosition, const glm::vec2& playerSize)
+{
+    return playerCenterPosition - glm::vec2(0.0f, playerSize.y * 0.5f - Globals::kPlayerFootHitboxHeightPx);
+}
+
 void ClampPlayerToMapBoundsDiamond(
     glm::vec2& playerCenterPosition,
     const glm::vec2& playerSize,
@@ -374,7 +860,7 @@ void ClampPlayerToMapBoundsDiamond(
     const float halfHit = Globals::kPlayerFootHitboxWidthPx * 0.5f; // vízszintes fél-szélesség (pl. 6.5 a 13px-hez)
 
     // --- 1) sprite-középpont -> lábpont (világ) ---
-    glm::vec2 feet = playerCenterPosition - glm::vec2(0.0f, playerSize.y * 0.5f - footH);
+    glm::vec2 feet = GetPlayerFeetPosition(playerCenterPosition, playerSize);
 
     // --- 2) előkészített méretek és origó (pontosan mint a rajzolásnál) ---
     const float halfW = iso.ScaledWidth() * 0.5f;          // 693 * scale / 2
@@ -410,73 +896,546 @@ void ClampPlayerToMapBoundsDiamond(
     playerCenterPosition = feet + glm::vec2(0.0f, playerSize.y * 0.5f - footH);
 }
 
-int main()
+Shader LoadHeadlessShader(StartupShader which)
+{
+    const std::string path = std::string("assets/shaders/") + kStartupShaderNames[which];
+    const AssetData vertex = LoadShaderSource(path + ".vert");
+    const AssetData fragment = LoadShaderSource(path + ".frag");
+    return Shader(vertex.Text(), fragment.Text());
+}
+
+// Ablak és GPU nélküli jelenet (geometria mód: csempék, szélek, játékos, életerő-csík).
+// Worker nélküli cache: a textúrák szinkron, a kérés sorrendjében kapnak nevet, így a
+// rögzített napló futásról futásra azonos. A tagok sorrendje a létrehozásé (és fordítva a
+// megszűnésé): a textúrát és shadert tartók a cache és a shaderek után jönnek.
+struct HeadlessScene
+{
+    TextureCache textureCache;
+    Shader isoShader = LoadHeadlessShader(IsoShader);
+    Shader spriteShader = LoadHeadlessShader(SpriteShader);
+    Shader uiShader = LoadHeadlessShader(UiShader);
+    IsoRenderer isoRenderer{ isoShader, "assets/textures/tiles/tiles.png", textureCache };
+    BitmapFont hudFont;
+    UIRenderer uiRenderer{ uiShader };
+    PlayerHud hud{ uiRenderer, hudFont };
+    TextureRef playerSheet = textureCache.AcquireAsync("assets/textures/player/characters.png", PlayerSheetImportSettings());
+    SpriteRenderer playerRenderer{ spriteShader };
+    Character8Direction player{ playerSheet, playerRenderer };
+
+    Camera camera{ (float)Globals::WindowWidth, (float)Globals::WindowHeight };
+    glm::vec2 playerPosition;
+    const glm::vec2 playerSize{ 32.0f, 32.0f };
+    FieldOfView fov;
+    float playerDepth = 0.0f;
+
+    RenderQueue worldQueue;
+    CommandQueue commandQueue;
+    CommandBuffer& commands = commandQueue.CreateBuffer();
+    double uiSeconds = 0.0;     // a HUD frissítése, rögzítése és végrehajtása összesen
+
+    // A játékmenet rendszerei (Simulate): ugyanazok a CPU-oldali frissítések, mint a
+    // játékciklusban, hogy a foglalásmentesség rájuk is ellenőrizve legyen. Nem rajzolnak,
+    // így a hívásnapló (--record-frame) nem változik.
+    ThreadPool workers;
+    FlowField flowField;
+    ProjectileSystem projectiles{ ProjectileSystem::kDefaultCapacity, &workers };
+    ParticleSystem particles{ &workers };
+    ParticleEmitter& dashTrail = particles.CreateEmitter(MakeDashTrailSettings());
+    ParticleEmitter& hitSparks = particles.CreateEmitter(MakeHitSparkSettings());
+    ParticleEmitter& dust = particles.CreateEmitter(MakeDustSettings());
+    CrowdTest crowd;
+    std::vector<SpriteInstance> effectInstances;
+    int simulatedFrames = 0;
+    size_t projectileHits = 0;
+    double simulationSeconds = 0.0;
+
+    explicit HeadlessScene(const TileMap& tileMap)
+        : fov(tileMap), flowField(tileMap, &workers)
+    {
+        uiRenderer.SetFont(hudFont);
+        playerPosition = GetMapCenterPosition(isoRenderer, tileMap);
+        camera.SetPosition(playerPosition - glm::vec2(Globals::WindowWidth * 0.5f, Globals::WindowHeight * 0.5f));
+        isoRenderer.SetProjection(glm::ortho(0.0f, (float)Globals::WindowWidth, 0.0f, (float)Globals::WindowHeight, -1.0f, 1.0f));
+        isoRenderer.SetView(camera.GetView());
+
+        const IsoGrid mapGrid = isoRenderer.GetGrid(tileMap.GetHeight(), tileMap.GetWidth());
+        const glm::vec2 playerFeet = GetPlayerFeetPosition(playerPosition, playerSize);
+        fov.Update(mapGrid.WorldToTile(playerFeet));
+        playerDepth = mapGrid.SpriteDepth(playerFeet);
+
+        // a tömeg rajzolás nélkül: csak a mozgás és a csomagolás fut, ahhoz elég egy klip-index
+        crowd.enabled = true;
+        crowd.clip = 0;
+        SpawnCrowdTest(crowd, mapGrid, tileMap.GetHeight(), tileMap.GetWidth());
+    }
+
+    // Egy képkocka játékmenete fix lépéssel: a flow field célja csempénként váltakozik (minden
+    // képkocka újraszámol), a játékos körbe lő és folyamatosan dash-el.
+    void Simulate(const TileMap& tileMap)
+    {
+        constexpr float kDeltaTime = 1.0f / 60.0f;
+        const auto start = std::chrono::steady_clock::now();
+        const float time = simulatedFrames * kDeltaTime;
+
+        const IsoGrid mapGrid = isoRenderer.GetGrid(tileMap.GetHeight(), tileMap.GetWidth());
+        const glm::vec2 playerFeet = GetPlayerFeetPosition(playerPosition, playerSize);
+        flowField.Update(mapGrid.WorldToTile(playerFeet) + glm::ivec2(simulatedFrames % 2, 0));
+
+        UpdateCrowdTest(crowd, time, kDeltaTime, playerPosition, flowField, mapGrid, &workers);
+
+        const glm::vec2 aim(std::cos(time * 3.0f), std::sin(time * 3.0f));
+        projectiles.Spawn(playerFeet, aim * Globals::ProjectileSpeed,
+            Globals::ProjectileLifetimeInSeconds, Globals::ProjectileRadius, glm::vec4(1.0f));
+        projectiles.Update(kDeltaTime, tileMap, mapGrid, crowd.feet, Globals::CrowdHitRadius);
+        projectileHits += projectiles.GetHits().size();
+
+        DashState dash;
+        dash.active = true;
+        dash.direction = aim;
+        EmitGameplayParticles(kDeltaTime, dash, playerFeet, projectiles.GetHits(), dashTrail, hitSparks, dust);
+        particles.Update(kDeltaTime);
+        particles.BuildInstances(ParticleBlendMode::Alpha, effectInstances);
+        particles.BuildInstances(ParticleBlendMode::Additive, effectInstances);
+        projectiles.BuildInstances(effectInstances);
+
+        ++simulatedFrames;
+        simulationSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void RenderFrame(const TileMap& tileMap)
+    {
+        worldQueue.Clear();
+        isoRenderer.RecordMap(commands, tileMap.GetTiles(), fov.GetVisibility().data(), worldQueue, TileEdgeBatch);
+        worldQueue.Push(playerDepth, PlayerBatch, 0);
+        worldQueue.Sort();
+        RecordSortedWorld(commands, worldQueue, isoRenderer, camera, player, playerPosition, playerSize, playerDepth);
+        commandQueue.Submit();
+        const auto uiStart = std::chrono::steady_clock::now();
+        RenderUI(uiRenderer, hud, commandQueue, commands, 75, 100, 0.0f);
+        uiSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - uiStart).count();
+    }
+};
+
+// Egy sok ezer glifes szöveg-widget: minden lépésben más szöveg (teljes újra elrendezés és
+// feltöltés), illetve ugyanaz (a SetText összevet, a csúcsok maradnak). Közben a HUD továbbra
+// is egy rajzolás.
+void BenchmarkText(UIRenderer& ui, int iterations, uint32_t& glyphs, double& relayoutUs, double& cachedUs)
+{
+    const char* line = "Frame 16.67 ms  dash 1.5  damage -42  \xC3\xA1rv\xC3\xADzt\xC5\xB1r\xC5\x91 t\xC3\xBCk\xC3\xB6rf\xC3\xBAr\xC3\xB3g\xC3\xA9p\n";
+    std::string text;
+    while (text.size() < 6000)
+        text += line;
+    const size_t glyphsBefore = ui.GetStats().glyphs;
+    const UIRenderer::WidgetId id = ui.AddText(glm::vec2(8.0f, 700.0f), 4096);
+    ui.SetText(id, text);
+    ui.Update();
+    glyphs = static_cast<uint32_t>(ui.GetStats().glyphs - glyphsBefore);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        text[0] = static_cast<char>('0' + i % 10);
+        ui.SetText(id, text);
+        ui.Update();
+    }
+    relayoutUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        ui.SetText(id, text);
+        ui.Update();
+    }
+    cachedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+// Egy headless képkocka elvárt hívásszámai: a rajzolások, shader- és textúraváltások
+// számának változása a batchelés romlását jelzi akkor is, ha a napló egyébként is eltér.
+bool CheckFrameCallCounts()
+{
+    struct ExpectedCalls
+    {
+        const char* label;
+        size_t expected;
+        size_t actual;
+    };
+    const ExpectedCalls checks[] = {
+        { "draws", 5, GLBackend::GetCallCount("glDrawArrays") + GLBackend::GetCallCount("glDrawArraysInstanced") },
+        { "glUseProgram", 4, GLBackend::GetCallCount("glUseProgram") },
+        { "glBindTexture", 6, GLBackend::GetCallCount("glBindTexture") },
+    };
+
+    bool ok = true;
+    for (const ExpectedCalls& check : checks) {
+        if (check.actual != check.expected) {
+            std::cerr << "Frame " << check.label << ": " << check.actual << " (expected " << check.expected << ")\n";
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// goldenPath nélkül a null backenden méri a CPU-oldali összeállítást (rögzítés, rendezés,
+// Submit), majd egy képkockát a rögzítő backenden a GL-hívások számáért; goldenPath-tel egy
+// képkocka hívásnaplóját veti össze a mentett naplóval. Hiányzó napló hiba; új naplót csak
+// updateGolden ír.
+int RunHeadlessFrames(int frameCount, const char* goldenPath, bool updateGolden = false)
+{
+    if (!GLBackend::Install(goldenPath ? GLBackend::Kind::Recording : GLBackend::Kind::Null))
+        return 1;
+    VirtualFileSystem::Get().MountArchive();
+
+    TileMap tileMap;
+    BuildDefaultMap(tileMap);
+    HeadlessScene scene(tileMap);
+    if (!scene.playerSheet) {
+        std::cerr << "Player texture load failed!\n";
+        return 1;
+    }
+    auto renderFrame = [&]() { scene.RenderFrame(tileMap); };
+
+    // bemelegítés: a pufferek elérik a végleges méretüket, a példány-VBO feltöltődik; a
+    // lövedék-készlet és a részecske-pufferek egy élettartamnyi képkocka alatt telnek meg
+    renderFrame();
+    if (!goldenPath) {
+        for (int i = 0; i < Globals::AllocationWarmupFrames; ++i) {
+            FrameArena::Get().BeginFrame();
+            scene.Simulate(tileMap);
+        }
+        scene.simulationSeconds = 0.0;
+        scene.projectileHits = 0;
+    }
+
+    int result = 0;
+    if (goldenPath) {
+        GLBackend::ResetRecording();
+        renderFrame();
+        if (updateGolden) {
+            result = GLBackend::SaveCallLog(goldenPath) ? 0 : 1;
+            std::cout << "Recorded " << GLBackend::GetTotalCallCount() << " GL calls to " << goldenPath << std::endl;
+        }
+        else if (std::ifstream(goldenPath).good()) {
+            const bool matches = GLBackend::MatchesCallLog(goldenPath);
+            std::cout << "Frame GL calls (" << GLBackend::GetTotalCallCount() << ") "
+                << (matches ? "match " : "differ from ") << goldenPath << std::endl;
+            result = matches ? 0 : 1;
+        }
+        else {
+            std::cerr << "Golden call log not found: " << goldenPath << " (record it with --update)\n";
+            result = 1;
+        }
+        if (!CheckFrameCallCounts())
+            result = 1;
+    }
+    else {
+        // a bemelegítés után egy képkocka sem foglalhat heapet (debug buildben ellenőrizve)
+        uint64_t steadyAllocations = 0;
+        scene.uiSeconds = 0.0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < frameCount; ++i) {
+            FrameArena::Get().BeginFrame();
+            AllocationTracker::BeginFrame();
+            scene.Simulate(tileMap);
+            renderFrame();
+            const uint64_t allocations = AllocationTracker::GetFrameTotals().allocations;
+            if (allocations > 0 && steadyAllocations == 0)
+                AllocationTracker::PrintFrameReport();
+            steadyAllocations += allocations;
+        }
+        const double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const double uiUs = scene.uiSeconds * 1e6 / frameCount;
+        const UIRenderer::Stats hudStats = scene.uiRenderer.GetStats();
+
+        uint32_t textGlyphs = 0;
+        double relayoutUs = 0.0, cachedUs = 0.0;
+        BenchmarkText(scene.uiRenderer, 200, textGlyphs, relayoutUs, cachedUs);
+
+        GLBackend::Install(GLBackend::Kind::Recording);
+        GLBackend::SetLogCalls(false);
+        renderFrame();
+
+        std::cout << "Headless frames (null GL backend), " << frameCount << " frames:\n"
+            << "  CPU time:      " << totalMs * 1000.0 / frameCount << " us/frame\n"
+            << "  GL calls:      " << GLBackend::GetTotalCallCount() << " per frame ("
+            << GLBackend::GetCallCount("glDrawArrays") + GLBackend::GetCallCount("glDrawArraysInstanced") << " draws, "
+            << GLBackend::GetCallCount("glUseProgram") << " program binds, "
+            << GLBackend::GetCallCount("glBindTexture") << " texture binds)\n"
+            << "  UI:            " << uiUs << " us/frame (" << hudStats.widgets << " widgets, "
+            << hudStats.glyphs << " glyphs, one draw; target < 100 us)\n"
+            << "  Text:          " << textGlyphs << " glyphs in the same draw: " << relayoutUs << " us to lay out and upload, "
+            << cachedUs << " us when unchanged\n"
+            << "  Gameplay:      " << scene.simulationSeconds * 1e6 / frameCount << " us/frame (flow field, "
+            << scene.crowd.centers.size() << " crowd actors, " << scene.projectileHits << " projectile hits, "
+            << scene.particles.GetStats().particleCount << " particles; part of the CPU time)" << std::endl;
+        if (!CheckFrameCallCounts())
+            result = 1;
+        if (AllocationTracker::IsEnabled()) {
+            std::cout << "  heap allocations after warm-up: " << steadyAllocations << " (target 0)" << std::endl;
+            if (steadyAllocations != 0)
+                result = 1;
+        }
+        else {
+            // release buildben nincs számlálás: ne tűnjön sikeres ellenőrzésnek
+            std::cout << "  heap allocations: not tracked in this build (define RAVENS_TRACK_ALLOCATIONS)" << std::endl;
+        }
+    }
+
+    return result;
+}
+
+// Ismételt pályabetöltés GPU nélkül: a jelenet GL-objektumai (textúra-cache, shaderek,
+// rendererek) loadCount-szor jönnek létre és szűnnek meg egy-egy képkocka után. Minden
+// lebontás után az élő objektumok száma a kiinduló értékre kell visszaálljon, különben a
+// GPU-memória betöltésenként nőne.
+int RunHeadlessReloads(int loadCount)
 {
+    if (!GLBackend::Install(GLBackend::Kind::Null))
+        return 1;
+    VirtualFileSystem::Get().MountArchive();
+
+    TileMap tileMap;
+    BuildDefaultMap(tileMap);
+
+    const size_t baseline = GLObjectTracker::GetTotalLiveCount();
+    size_t objectsPerLoad = 0;
+    for (int load = 0; load < loadCount; ++load) {
+        {
+            HeadlessScene scene(tileMap);
+            scene.RenderFrame(tileMap);
+            objectsPerLoad = GLObjectTracker::GetTotalLiveCount() - baseline;
+        }
+        const size_t live = GLObjectTracker::GetTotalLiveCount();
+        if (live != baseline) {
+            std::cerr << "Load " << load + 1 << " left " << live - baseline << " GL objects alive" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Level loads: " << loadCount << ", " << objectsPerLoad << " GL objects per load, "
+        << "none alive after unload" << std::endl;
+    return 0;
+}
+
+// A fő ciklus GL-objektumait tartó lokálisok (textúra-cache, shaderek, rendererek) ez után
+// jönnek létre, így előbb szűnnek meg: a kontextus a felszabadításukig él. A glfwTerminate
+// előtt a még élő (szivárgott) és a kétszer törölt objektumok kiíródnak.
+struct GLContextScope
+{
+    ~GLContextScope()
+    {
+        GLObjectTracker::ReportLeaks();
+        glfwTerminate();
+    }
+};
+
+// ablak nélküli futásnál a jelenet megszűnése után: szivárgásnál a kilépési kód is hibát jelez
+int CheckGLObjectLeaks(int result)
+{
+    return GLObjectTracker::ReportLeaks() ? result : 1;
+}
+
+int main(int argc, char** argv)
+{
+    const StartupGraph::Clock::time_point processStart = StartupGraph::Clock::now();
+
+    // Build utáni lépés: "RavensLikeGame --pack [kimenet]" az assets/ könyvtárból archívumot készít
+    if (argc >= 2 && std::string(argv[1]) == "--pack")
+        return AssetPacker::Pack("assets", argc >= 3 ? argv[2] : VirtualFileSystem::kDefaultArchive) ? 0 : 1;
+
+    // "RavensLikeGame --bench [elemszám]": a világ-sor radix rendezése std::sort-tal szemben
+    if (argc >= 2 && std::string(argv[1]) == "--bench") {
+        const int count = argc >= 3 ? std::max(1, std::atoi(argv[2])) : 100000;
+        RenderQueue::Benchmark(static_cast<size_t>(count), 100);
+        return 0;
+    }
+
+    // "RavensLikeGame --bench-crowd [ágensek]": a helyi elkerülés (CrowdAvoidance) költsége
+    if (argc >= 2 && std::string(argv[1]) == "--bench-crowd") {
+        ThreadPool benchWorkers;
+        return CrowdAvoidance::Benchmark(argc >= 3 ? std::max(2, std::atoi(argv[2])) : 5000, 300, &benchWorkers) ? 0 : 1;
+    }
+
+    // "RavensLikeGame --bench-projectiles [lövedékek]": a lövedék-készlet frissítése teli készlettel
+    if (argc >= 2 && std::string(argv[1]) == "--bench-projectiles") {
+        ProjectileSystem::Benchmark(argc >= 3 ? std::max(1, std::atoi(argv[2])) : ProjectileSystem::kDefaultCapacity, 5000, 300);
+        return 0;
+    }
+
+    // "RavensLikeGame --tile-mesh-check": a csempe-háló lefedettsége és fragmentszáma CPU-raszterrel
+    if (argc >= 2 && std::string(argv[1]) == "--tile-mesh-check") {
+        VirtualFileSystem::Get().MountArchive();
+        TileMap tileMap;
+        BuildDefaultMap(tileMap);
+        return IsoRenderer::CheckTileMesh("assets/textures/tiles/tiles.png", tileMap.GetWidth() * tileMap.GetHeight()) ? 0 : 1;
+    }
+
+    // "RavensLikeGame --bench-frames [képkockák]": a képkocka CPU-költsége a null GL backenddel
+    if (argc >= 2 && std::string(argv[1]) == "--bench-frames")
+        return CheckGLObjectLeaks(RunHeadlessFrames(argc >= 3 ? std::max(1, std::atoi(argv[2])) : 1000, nullptr));
+
+    // "RavensLikeGame --record-frame [napló] [--update]": egy képkocka GL-hívásait a rögzítő
+    // backenddel a mentett naplóhoz (alapból a repóban lévő golden/frame_calls.txt) veti össze;
+    // --update-tel szándékos változás után újraírja
+    if (argc >= 2 && std::string(argv[1]) == "--record-frame") {
+        const char* goldenPath = argc >= 3 && std::string(argv[2]) != "--update" ? argv[2] : "golden/frame_calls.txt";
+        return CheckGLObjectLeaks(RunHeadlessFrames(1, goldenPath, HasArgument(argc, argv, "--update")));
+    }
+
+    // "RavensLikeGame --reload-check [betöltések]": a GL-objektumok száma ismételt
+    // pályabetöltésnél sem nőhet
+    if (argc >= 2 && std::string(argv[1]) == "--reload-check")
+        return CheckGLObjectLeaks(RunHeadlessReloads(argc >= 3 ? std::max(1, std::atoi(argv[2])) : 20));
+
+    const bool glStatsAtStartup = HasArgument(argc, argv, "--gl-stats");
+    GLContextScope glContextScope;
+
+    // Közös worker szálak (textúra-dekódolás, flow field, részecskék) és a textúra-cache;
+    // a textúrát tartó objektumok előtt jönnek létre, így azok után szűnnek meg.
+    // A cache-hez még nem kell GL: a dekódolás az ablak létrehozása alatt elindulhat.
+    ThreadPool workers;
+    TextureCache textureCache(workers);
+
+    // Indítás lépésekben: a CPU-munka a workereken fut, amíg a fő szál az ablakot és a
+    // kontextust hozza létre; a fő szálon csak a GL-t igénylő lépések maradnak.
+    // A workeren futó lépések ezekbe írnak, ezért a gráf előtt jönnek létre.
+    StartupShaderSources shaderSources;
+    TileMap tileMap;
+    StartupGraph startup(workers, processStart);
+
+    // Az archívum (vagy a laza assets/) a munkakönyvtárban vagy a futtatható mellett lehet;
+    // ha nincs archívum, minden laza fájlból töltődik (fejlesztés)
+    const StartupGraph::TaskId mountAssets = startup.Begin("mount assets");
+    VirtualFileSystem::Get().MountArchive();
+    startup.End(mountAssets);
+
+    const StartupGraph::TaskId readShaders = startup.Spawn("read shaders", { mountAssets }, [&shaderSources]() {
+        for (int i = 0; i < StartupShaderCount; ++i) {
+            const std::string path = std::string("assets/shaders/") + kStartupShaderNames[i];
+            shaderSources[i].vertex = LoadShaderSource(path + ".vert");
+            shaderSources[i].fragment = LoadShaderSource(path + ".frag");
+        }
+    });
+    const StartupGraph::TaskId buildMap = startup.Spawn("build map", {}, [&tileMap]() {
+        BuildDefaultMap(tileMap);
+    });
+
+    const TextureImportSettings playerSheetImport = PlayerSheetImportSettings();
+
+    // a dekódolás a thread poolon indul; a renderereknél az AcquireAsync ezt veszi át
+    StartupGraph::TaskId stage = startup.Begin("prefetch textures");
+    textureCache.Prefetch("assets/textures/tiles/tiles.png", IsoRenderer::AtlasImportSettings());
+    textureCache.Prefetch("assets/textures/player/characters.png", playerSheetImport);
+    startup.End(stage);
+
+    stage = startup.Begin("create window");
     if (!glfwInit())
         return -1;
 
-    GLFWwindow* window = CreateGameWindow();
+    GLFWwindow* window = CreateGameWindow(glStatsAtStartup);
     if (!window)
         return -1;
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    if (!GLBackend::Install(GLBackend::Kind::OpenGL, (GLADloadproc)glfwGetProcAddress))
         return -1;
 
-    // Engedélyezzük az átlátszóságot (alpha blending)
+    // "--gl-stats": GL hívás-statisztika az indítástól folyamatosan (különben F5: egy mérési ablak)
+    if (glStatsAtStartup)
+        GLStats::Enable(MakeGLStatsSettings(true), (GLADloadproc)glfwGetProcAddress);
+
+    // Engedélyezzük az átlátszóságot (premultiplikált alpha: a textúrák importkor,
+    // a shaderek kimenete is rgb*a)
     glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LEQUAL);
     glClearDepth(1.0);
+    startup.End(stage);
+
+    // Shaderek: binárisként a cache-ből, vagy (KHR_parallel_shader_compile mellett) háttérben
+    // fordítva, amíg a textúrák a workereken dekódolódnak; a FinishPending a kérések után vár rájuk
+    stage = startup.Begin("compile shaders", { readShaders });
+    ShaderCache shaderCache;
+    Shader isoShader = CreateStartupShader(shaderCache, shaderSources, IsoShader);
+    // Alternatív mód: a rács R8UI textúrában, a talaj egy teljes képernyős passban
+    Shader isoMapShader = CreateStartupShader(shaderCache, shaderSources, IsoMapShader);
+    // Alapmód: a statikus talaj offscreen lapokon, képkockánként csak a látható lapok kerülnek ki
+    Shader mapPageShader = CreateStartupShader(shaderCache, shaderSources, MapPageShader);
+    // A világ és a sprite-ok skálázott offscreen targetbe mennek (GPU-idő alapú szabályzás),
+    // a UI utána natív felbontáson rajzol
+    Shader upscaleShader = CreateStartupShader(shaderCache, shaderSources, UpscaleShader);
+    Shader uiShader = CreateStartupShader(shaderCache, shaderSources, SpriteShader);
+    Shader effectShader = CreateStartupShader(shaderCache, shaderSources, InstancedSpriteShader);
+    Shader crowdShader = CreateStartupShader(shaderCache, shaderSources, CrowdShader);
+    Shader hudShader = CreateStartupShader(shaderCache, shaderSources, UiShader);
+    startup.End(stage);
+
+    stage = startup.Begin("create renderers", { buildMap });
+    // Izometrikus renderer inicializálás
+    IsoRenderer isoRenderer(isoShader, "assets/textures/tiles/tiles.png", textureCache);
 
-    // Shader betöltése fájlból
-    std::string vertexCode = LoadShaderSource("assets/shaders/iso.vert");
-    std::string fragmentCode = LoadShaderSource("assets/shaders/iso.frag");
+    IsoMapTextureRenderer isoMapRenderer(isoMapShader, isoRenderer);
 
-    Shader isoShader(vertexCode.c_str(), fragmentCode.c_str());
+    MapPageCache mapPageCache(mapPageShader, isoRenderer);
 
-    isoShader.Use();
-    isoShader.SetInt("textureAtlas", 0);
+    WorldRenderMode worldRenderMode = WorldRenderMode::Geometry;
+    RenderQueue worldQueue;
+    CommandQueue commandQueue;
+    CommandBuffer& frameCommands = commandQueue.CreateBuffer();
+    bool mapModeKeyWasDown = false;
 
-    // Izometrikus renderer inicializálás
-    IsoRenderer isoRenderer(isoShader, "assets/textures/tiles/tiles.png");
+    int framebufferWidth = 0, framebufferHeight = 0;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    DynamicResolution::Settings dynamicResolutionSettings;
+    dynamicResolutionSettings.budgetMs = Globals::DynamicResolutionBudgetMs;
+    DynamicResolution dynamicResolution(upscaleShader, framebufferWidth, framebufferHeight, dynamicResolutionSettings);
+    bool upscaleFilterKeyWasDown = false;
+    bool glStatsKeyWasDown = false;
     
     glm::mat4 projection = glm::ortho(0.0f, (float)Globals::WindowWidth, 0.0f, (float)Globals::WindowHeight, -1.0f, 1.0f);
     glm::mat4 view = glm::mat4(1.0f);
     isoRenderer.SetProjection(projection);
     isoRenderer.SetView(view);
 
-    std::vector<std::vector<int>> mapData = {
-        { 0, 1, 2, 3, 0, 3, 0, 3, 0, 3 },
-        { 0, 2, 3, 0, 0, 0, 3, 0, 3, 0 },
-        { 0, 3, 0, 1, 0, 3, 0, 3, 0, 3 },
-        { 0, 0, 1, 2, 0, 0, 3, 0, 3, 0 },
-        { 0, 3, 0, 3, 0, 3, 0, 3, 0, 3 }
-    };
-
-    Shader uiShader(
-        LoadShaderSource("assets/shaders/sprite.vert").c_str(),
-        LoadShaderSource("assets/shaders/sprite.frag").c_str());
-    UIRenderer uiRenderer(uiShader);
+    // a font atlasza egyben a HUD atlasza: a csíkok és a szövegek egy rajzolásban
+    BitmapFont hudFont;
+    UIRenderer uiRenderer(hudShader);
+    uiRenderer.SetFont(hudFont);
+    PlayerHud hud(uiRenderer, hudFont);
+    DebugOverlay debugOverlay(uiRenderer);
+    bool debugOverlayKeyWasDown = false;
 
-    Texture playerSheet;
-    if (!playerSheet.LoadFromFile("assets/textures/player/characters.png")) {
+    TextureRef playerSheet = textureCache.AcquireAsync("assets/textures/player/characters.png", playerSheetImport);
+    if (!playerSheet) {
         std::cerr << "Player texture load failed!\n";
         return -1;
     }
     SpriteRenderer playerRenderer(uiShader);
-    Character8Direction player(playerSheet, playerRenderer);
+    //const GridOutlineMesh gridOutlineMesh = CreateGridOutlineMesh();   // a DrawWalkableOutlines-hoz
 
-    Camera camera((float)Globals::WindowWidth, (float)Globals::WindowHeight);
+    InstancedSpriteRenderer effectRenderer(effectShader);
+    Character8Direction player(playerSheet, playerRenderer);
 
-    int centerTileX = static_cast<int>(mapData[0].size() / 2);
-    int centerTileY = static_cast<int>(mapData.size() / 2);
+    // a tömeg a játékos lapjáról és animációjából rajzol (egy klip a CrowdRenderer táblájában)
+    CrowdRenderer crowdRenderer(crowdShader);
+    CrowdTest crowdTest;
+    crowdTest.clip = crowdRenderer.AddClip(player.GetUvFrames()[0].data(),
+        Character8Direction::kDirections, Character8Direction::kFramesPerDirection);
+    startup.End(stage);
+
+    // ami az ablak alatt már dekódolódott, az első képkocka előtt felkerül (nem vár a többire)
+    stage = startup.Begin("upload textures");
+    textureCache.Update(kStartupUploadBytes);
+    startup.End(stage);
+
+    // minden textúra-kérés kint van: innen már érdemes a shaderekre várni
+    stage = startup.Begin("link shaders");
+    shaderCache.FinishPending();
+    isoShader.Use();
+    isoShader.SetInt("textureAtlas", 0);
+    startup.End(stage);
 
-    float worldX = (centerTileX - centerTileY) * (isoRenderer.ScaledWidth() * 0.5f);
-    float worldY = (centerTileX + centerTileY) * (isoRenderer.ScaledVisibleHeight() * 0.5f);
+    Camera camera((float)Globals::WindowWidth, (float)Globals::WindowHeight);
 
-    glm::vec2 playerPosition(worldX, worldY);
+    glm::vec2 playerPosition = GetMapCenterPosition(isoRenderer, tileMap);
     glm::vec2 playerSize(32.0f, 32.0f);
     const float playerSpeed = 300.0f;
 
@@ -486,39 +1445,113 @@ int main()
     int maxHealth = 100, currentHealth = 100;
 
     float lastTime = glfwGetTime();
+    int startupReportState = 0;
+    const StartupGraph::TaskId firstFrame = startup.Begin("first frame");
     float deltaTime = 0.0f;
 
-    const int mapWidth = static_cast<int>(mapData[0].size());
-    const int mapHeight = static_cast<int>(mapData.size());
+    const int mapWidth = tileMap.GetWidth();
+    const int mapHeight = tileMap.GetHeight();
+
+    // A játékos felé mutató flow field: a tömeg-teszt szereplői ezen kormányoznak
+    // (csak csempeváltáskor számol újra, és csak amíg a tömeg-teszt fut)
+    FlowField playerFlowField(tileMap, &workers);
+    FieldOfView playerFov(tileMap);
+
+    // Lövedékek (fix kapacitású készlet); falakba és a tömeg-teszt szereplőibe csapódnak
+    ProjectileSystem projectiles(ProjectileSystem::kDefaultCapacity, &workers);
+    std::vector<SpriteInstance> projectileInstances;
+    float fireCooldown = 0.0f;
+
+    // Részecskék: kibocsátónként saját gyűrűpuffer, a szimuláció a közös worker szálakon fut
+    ParticleSystem particles(&workers);
+
+    ParticleEmitter& dashTrail = particles.CreateEmitter(MakeDashTrailSettings());
+    ParticleEmitter& hitSparks = particles.CreateEmitter(MakeHitSparkSettings());
+    ParticleEmitter& dust = particles.CreateEmitter(MakeDustSettings());
+
+    std::vector<SpriteInstance> particleInstances;
+    float statsReportTimer = 0.0f;
+    float allocationReportTimer = 0.0f;
+    int frameIndex = 0;
 
     while (!glfwWindowShouldClose(window))
     {
+        FrameArena::Get().BeginFrame();
+        AllocationTracker::BeginFrame();
         CalculateDeltaTime(lastTime, deltaTime);
         glfwPollEvents();
+        textureCache.Update();
 
         UpdatePlayerPosition(window, player, playerPosition, playerSpeed, deltaTime, dash, dashKeyWasDown);
 
         ClampPlayerToMapBoundsDiamond(playerPosition, playerSize, isoRenderer, mapHeight, mapWidth);
 
+        const IsoGrid mapGrid = isoRenderer.GetGrid(mapHeight, mapWidth);
+        const glm::vec2 playerFeet = GetPlayerFeetPosition(playerPosition, playerSize);
+        const glm::ivec2 playerTile = mapGrid.WorldToTile(playerFeet);
+        const bool fovChanged = playerFov.Update(playerTile);
+        isoMapRenderer.Sync(tileMap, playerFov.GetVisibility().data(), fovChanged);
+        mapPageCache.Sync(tileMap, playerFov.GetVisibility().data(), fovChanged);
+        CycleWorldRenderMode(window, worldRenderMode, mapModeKeyWasDown);
+        ToggleCrowdTest(window, crowdTest, mapGrid, mapHeight, mapWidth);
+        // csak a tömeg-teszt olvassa: kikapcsolva nem számolunk újra
+        if (crowdTest.enabled)
+            playerFlowField.Update(playerTile);
+        UpdateCrowdTest(crowdTest, static_cast<float>(glfwGetTime()), deltaTime, playerPosition, playerFlowField, mapGrid, &workers);
+        ToggleUpscaleFilter(window, dynamicResolution, upscaleFilterKeyWasDown);
+        StartGLStatsCapture(window, glStatsKeyWasDown);
+        ToggleDebugOverlay(window, debugOverlay, debugOverlayKeyWasDown);
+
+        FireProjectiles(window, player, playerFeet, projectiles, fireCooldown, deltaTime);
+        projectiles.Update(deltaTime, tileMap, mapGrid, crowdTest.feet, Globals::CrowdHitRadius);
+
+        EmitGameplayParticles(deltaTime, dash, playerFeet,
+            projectiles.GetHits(), dashTrail, hitSparks, dust);
+        particles.Update(deltaTime);
+
         UpdateCameraFollow(camera, playerPosition, deltaTime);
         isoRenderer.SetView(camera.GetView());
 
         DrainHealthOnKey(window, deltaTime, currentHealth);
 
         BeginFrame();
-        RenderWorld(isoRenderer, mapData);
+        dynamicResolution.BeginScene(0.1f, 0.1f, 0.15f);
+        worldQueue.Clear();
+        RenderWorld(isoRenderer, isoMapRenderer, mapPageCache, tileMap, playerFov, worldRenderMode, frameCommands, worldQueue);
+
+        //DrawWalkableOutlines(isoRenderer, gridOutlineMesh, tileMap.GetTiles(), uiShader, glm::vec3(1.0f), 1.0f);
+
+        // a tömeg alfa-tesztelt és mélységet ír: a sorrendje mindegy, a blendelt elemek elé kerül
+        crowdRenderer.SetSpriteDepth(mapGrid.GetSpriteDepthParams());
+        crowdRenderer.Draw(crowdTest.instances, playerPosition, playerSize, *playerSheet, camera.GetProjection(), camera.GetView());
+
+        // csempe-szélek és a játékos iso-mélység szerint összefésülve, majd a világ parancsai
+        const float playerDepth = mapGrid.SpriteDepth(playerFeet);
+        worldQueue.Push(playerDepth, PlayerBatch, 0);
+        worldQueue.Sort();
+        RecordSortedWorld(frameCommands, worldQueue, isoRenderer, camera, player, playerPosition, playerSize, playerDepth);
+        commandQueue.Submit();
+        const CommandQueue::Stats worldCommandStats = commandQueue.GetLastStats();
+        effectRenderer.SetSpriteDepth(mapGrid.GetSpriteDepthParams());
+        RenderProjectiles(effectRenderer, camera, projectiles, projectileInstances);
+        const size_t particleUploadBytes = RenderParticles(effectRenderer, camera, particles, particleInstances);
 
-        //DrawWalkableOutlines(isoRenderer, mapData, uiShader, glm::vec3(1.0f), 1.0f);
+        dynamicResolution.EndScene();
 
-        DrawPlayer(uiShader, camera, player, playerPosition, playerSize);
+        debugOverlay.Update(deltaTime, worldCommandStats, isoRenderer);
+        RenderUI(uiRenderer, hud, commandQueue, frameCommands, currentHealth, maxHealth, dash.cooldown);
 
-        RenderUI(uiRenderer, currentHealth, maxHealth);
+        ReportFrameStats(window, particles.GetStats(), worldCommandStats, crowdTest.instances.size(),
+            particleUploadBytes + crowdRenderer.GetLastUploadBytes(), deltaTime, statsReportTimer);
 
         glfwSwapBuffers(window);
+        GLStats::EndFrame();
+        ReportStartupProgress(startup, firstFrame, textureCache, startupReportState);
+        CheckSteadyStateAllocations(frameIndex++, deltaTime, allocationReportTimer);
     }
 
-    isoShader.Delete();
-    uiShader.Delete();
-    glfwTerminate();
+    // a shaderek, rendererek és a textúra-cache a visszatéréskor szűnnek meg, még a
+    // glfwTerminate (GLContextScope) előtt
+    GLStats::Disable();
     return 0;
 }
\ No newline at end of file